@@ -0,0 +1,426 @@
+// Headless benchmark of the LGFXBase primitives.
+// Everything is drawn into sprites, so no display device is needed.
+// The results are written as JSON (ns per call and Mpix/s) to stdout or to the file given with -o.
+//
+// usage: LGFX_Benchmark [-o result.json] [-t msec_per_case] [-f name_filter]
+//        LGFX_Benchmark -v   (verify mode, see verify.cpp)
+
+#define LGFX_USE_V1
+#include <LovyanGFX.hpp>
+#include <lgfx/utility/lgfx_qoi.h>
+
+#include "assets.h"  // examples/Sprite/TransitionFX/assets.h
+
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+int run_verify(void);  // verify.cpp
+
+namespace
+{
+  struct result_t
+  {
+    std::string name;
+    int depth;
+    int rotation;
+    uint64_t calls;
+    double ns_per_call;
+    double mpix_per_sec;
+  };
+
+  std::vector<result_t> results;
+  uint32_t min_msec = 30;
+  const char* name_filter = nullptr;
+
+  int current_depth = 0;
+  int current_rotation = 0;
+
+  constexpr int target_width  = 320;
+  constexpr int target_height = 240;
+
+  // deterministic pseudo random coordinates, shared by every case.
+  constexpr size_t rand_count = 1024;
+  int32_t rand_x[rand_count];
+  int32_t rand_y[rand_count];
+  uint32_t rand_c[rand_count];
+
+  void init_random(void)
+  {
+    uint32_t s = 0x12345678;
+    for (size_t i = 0; i < rand_count; ++i)
+    {
+      s ^= s << 13; s ^= s >> 17; s ^= s << 5;
+      rand_x[i] = (s & 0xFFFF) % target_width;
+      rand_y[i] = (s >> 16) % target_height;
+      rand_c[i] = s * 2654435761u;
+    }
+  }
+
+  /// Runs func(i) repeatedly for at least min_msec and records the result.
+  /// @param pixels pixels written per call, or 0 when it is not meaningful.
+  template <typename TFunc>
+  void bench(const char* name, double pixels, TFunc&& func)
+  {
+    if (name_filter && strstr(name, name_filter) == nullptr) { return; }
+
+    typedef std::chrono::steady_clock clock;
+    func(0);
+
+    uint64_t calls = 0;
+    uint32_t batch = 1;
+    double elapsed_ns = 0;
+    auto start = clock::now();
+    do
+    {
+      for (uint32_t i = 0; i < batch; ++i) { func(calls++); }
+      elapsed_ns = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+      if (elapsed_ns < 1000000.0) { batch <<= 1; }
+    } while (elapsed_ns < min_msec * 1000000.0);
+
+    result_t r;
+    r.name = name;
+    r.depth = current_depth;
+    r.rotation = current_rotation;
+    r.calls = calls;
+    r.ns_per_call = elapsed_ns / calls;
+    r.mpix_per_sec = pixels * calls * 1000.0 / elapsed_ns;
+    results.push_back(r);
+    fprintf(stderr, "%-28s depth:%2d rot:%d %12.1f ns/call %10.2f Mpix/s\n", name, r.depth, r.rotation, r.ns_per_call, r.mpix_per_sec);
+  }
+
+//----------------------------------------------------------------------------
+
+  std::vector<uint8_t>  img332;
+  std::vector<uint16_t> img565;
+  std::vector<uint8_t>  img888;
+  std::vector<uint32_t> img8888;
+  constexpr int img_size = 64;
+
+  std::vector<uint8_t> vlw_data;
+  std::vector<uint8_t> bmp_data;
+  uint8_t* png_data = nullptr;
+  size_t png_len = 0;
+  uint8_t* qoi_data = nullptr;
+  size_t qoi_len = 0;
+
+  void put_be32(std::vector<uint8_t>& v, uint32_t x) { v.push_back(x >> 24); v.push_back(x >> 16); v.push_back(x >> 8); v.push_back(x); }
+  void put_le(std::vector<uint8_t>& v, uint32_t x, int bytes) { for (int i = 0; i < bytes; ++i) { v.push_back(x >> (i * 8)); } }
+
+  // a synthetic anti-aliased font, since no .vlw file is shipped with the library.
+  void make_vlw(void)
+  {
+    uint32_t count = 0x7E - 0x20 + 1;
+    put_be32(vlw_data, count); put_be32(vlw_data, 11); put_be32(vlw_data, 16);
+    put_be32(vlw_data, 0); put_be32(vlw_data, 13); put_be32(vlw_data, 3);
+    for (uint32_t c = 0x20; c <= 0x7E; ++c)
+    {
+      uint32_t w = (c == 0x20) ? 0 : 8;
+      uint32_t h = (c == 0x20) ? 0 : 12;
+      put_be32(vlw_data, c); put_be32(vlw_data, h); put_be32(vlw_data, w);
+      put_be32(vlw_data, 9); put_be32(vlw_data, 12); put_be32(vlw_data, 0); put_be32(vlw_data, 0);
+    }
+    for (uint32_t c = 0x21; c <= 0x7E; ++c)
+    {
+      for (uint32_t i = 0; i < 8 * 12; ++i) { vlw_data.push_back((uint8_t)((c * 37 + i * 91) & 0xFF)); }
+    }
+  }
+
+  void make_images(void)
+  {
+    img332.resize(img_size * img_size);
+    img565.resize(img_size * img_size);
+    img888.resize(img_size * img_size * 3);
+    img8888.resize(img_size * img_size);
+    for (int y = 0; y < img_size; ++y)
+    {
+      for (int x = 0; x < img_size; ++x)
+      {
+        int i = x + y * img_size;
+        uint8_t r = x * 4, g = y * 4, b = (x ^ y) * 4;
+        img332[i] = lgfx::color332(r, g, b);
+        img565[i] = lgfx::swap565(r, g, b);
+        img888[i * 3 + 0] = r;
+        img888[i * 3 + 1] = g;
+        img888[i * 3 + 2] = b;
+        img8888[i] = ((x + y) * 2) << 24 | r << 16 | g << 8 | b;
+      }
+    }
+
+    // encode the sample photo in the other formats.
+    LGFX_Sprite photo;
+    photo.setColorDepth(24);
+    photo.createSprite(200, 200);
+    photo.drawJpg(dog_200_200_jpg, sizeof(dog_200_200_jpg));
+
+    int w = photo.width();
+    int h = photo.height();
+
+    png_data = (uint8_t*)photo.createPng(&png_len, 0, 0, w, h);
+    std::vector<uint8_t> rgb(w * h * 3);
+    photo.readRectRGB(0, 0, w, h, rgb.data());
+
+    uint32_t row_bytes = (w * 3 + 3) & ~3u;
+    put_le(bmp_data, 0x4D42, 2); put_le(bmp_data, 54 + row_bytes * h, 4); put_le(bmp_data, 0, 4); put_le(bmp_data, 54, 4);
+    put_le(bmp_data, 40, 4); put_le(bmp_data, w, 4); put_le(bmp_data, h, 4); put_le(bmp_data, 1, 2); put_le(bmp_data, 24, 2);
+    put_le(bmp_data, 0, 4); put_le(bmp_data, row_bytes * h, 4); put_le(bmp_data, 2835, 4); put_le(bmp_data, 2835, 4);
+    put_le(bmp_data, 0, 4); put_le(bmp_data, 0, 4);
+    for (int y = h - 1; y >= 0; --y)
+    {
+      for (int x = 0; x < w; ++x)
+      { // BMP stores BGR
+        auto p = &rgb[(x + y * w) * 3];
+        bmp_data.push_back(p[2]); bmp_data.push_back(p[1]); bmp_data.push_back(p[0]);
+      }
+      for (uint32_t i = w * 3; i < row_bytes; ++i) { bmp_data.push_back(0); }
+    }
+
+    std::vector<uint8_t> line(w * 3);
+    qoi_data = (uint8_t*)lgfx_qoi_encoder_write_fb(line.data(), w, h, 3, &qoi_len, 0,
+      [](uint8_t* line_buffer, int, int w, int, int y, void* user) -> uint8_t*
+      {
+        memcpy(line_buffer, &((const uint8_t*)user)[y * w * 3], w * 3);
+        return line_buffer;
+      }, rgb.data());
+  }
+
+//----------------------------------------------------------------------------
+
+  void run_target(int depth, int rotation)
+  {
+    current_depth = depth;
+    current_rotation = rotation;
+
+    LGFX_Sprite dst;
+    dst.setColorDepth(depth);
+    if (!dst.createSprite(target_width, target_height)) { return; }
+    if (dst.getColorDepth() <= 8 && depth < 8) { dst.createPalette(); }
+    dst.setRotation(rotation);
+    int32_t w = dst.width();
+    int32_t h = dst.height();
+    auto rx = [&](uint64_t i) { return rand_x[i & (rand_count - 1)] % w; };
+    auto ry = [&](uint64_t i) { return rand_y[i & (rand_count - 1)] % h; };
+    auto rc = [&](uint64_t i) { return rand_c[i & (rand_count - 1)]; };
+
+    // alpha blending and rgb sources are not supported on palette targets.
+    bool rgb = depth >= 8;
+
+    // fills
+    bench("fillScreen", w * h, [&](uint64_t i) { dst.fillScreen(rc(i)); });
+    bench("fillRect_32x32", 32 * 32, [&](uint64_t i) { dst.fillRect(rx(i) - 16, ry(i) - 16, 32, 32, rc(i)); });
+    bench("fillRect_4x4", 4 * 4, [&](uint64_t i) { dst.fillRect(rx(i), ry(i), 4, 4, rc(i)); });
+    if (rgb)
+    {
+      bench("fillRectAlpha_32x32", 32 * 32, [&](uint64_t i) { dst.fillRectAlpha(rx(i) - 16, ry(i) - 16, 32, 32, 128, (uint32_t)(rc(i) & 0xFFFFFF)); });
+    }
+    bench("drawPixel", 1, [&](uint64_t i) { dst.drawPixel(rx(i), ry(i), rc(i)); });
+    bench("drawFastHLine_100", 100, [&](uint64_t i) { dst.drawFastHLine(rx(i) - 50, ry(i), 100, rc(i)); });
+    bench("drawFastVLine_100", 100, [&](uint64_t i) { dst.drawFastVLine(rx(i), ry(i) - 50, 100, rc(i)); });
+
+    // lines and shapes
+    bench("drawLine", 0, [&](uint64_t i) { dst.drawLine(rx(i), ry(i), rx(i + 1), ry(i + 1), rc(i)); });
+    bench("drawRect_64x48", 0, [&](uint64_t i) { dst.drawRect(rx(i) - 32, ry(i) - 24, 64, 48, rc(i)); });
+    bench("drawCircle_r40", 0, [&](uint64_t i) { dst.drawCircle(rx(i), ry(i), 40, rc(i)); });
+    bench("fillCircle_r40", 3.14159 * 40 * 40, [&](uint64_t i) { dst.fillCircle(rx(i), ry(i), 40, rc(i)); });
+    bench("fillEllipse_60x30", 3.14159 * 60 * 30, [&](uint64_t i) { dst.fillEllipse(rx(i), ry(i), 60, 30, rc(i)); });
+    bench("fillRoundRect_64x48", 64 * 48, [&](uint64_t i) { dst.fillRoundRect(rx(i) - 32, ry(i) - 24, 64, 48, 8, rc(i)); });
+    bench("fillTriangle", 0, [&](uint64_t i) { dst.fillTriangle(rx(i), ry(i), rx(i + 1), ry(i + 1), rx(i + 2), ry(i + 2), rc(i)); });
+    bench("fillArc_r30_50", 3.14159 * (50 * 50 - 30 * 30) / 2, [&](uint64_t i) { dst.fillArc(rx(i), ry(i), 30, 50, 0, 180, rc(i)); });
+
+    if (rgb)
+    {
+      // anti-aliased shapes
+      bench("fillSmoothCircle_r40", 3.14159 * 40 * 40, [&](uint64_t i) { dst.fillSmoothCircle(rx(i), ry(i), 40, rc(i)); });
+      bench("fillSmoothRoundRect_64x48", 64 * 48, [&](uint64_t i) { dst.fillSmoothRoundRect(rx(i) - 32, ry(i) - 24, 64, 48, 8, rc(i)); });
+      bench("drawSmoothLine", 0, [&](uint64_t i) { dst.drawSmoothLine(rx(i), ry(i), rx(i + 1), ry(i + 1), rc(i)); });
+      bench("drawWideLine_r3", 0, [&](uint64_t i) { dst.drawWideLine(rx(i), ry(i), rx(i + 1), ry(i + 1), 3.0f, rc(i)); });
+      bench("drawWedgeLine_r1_6", 0, [&](uint64_t i) { dst.drawWedgeLine(rx(i), ry(i), rx(i + 1), ry(i + 1), 1.0f, 6.0f, rc(i)); });
+
+      // gradients
+      bench("drawGradientHLine_200", 200, [&](uint64_t i) { dst.drawGradientHLine(rx(i) - 100, ry(i), 200, (uint32_t)rc(i) & 0xFFFFFF, (uint32_t)rc(i + 1) & 0xFFFFFF); });
+      bench("fillGradientRect_linear", 128 * 96, [&](uint64_t i) { dst.fillGradientRect(rx(i) - 64, ry(i) - 48, 128, 96, (uint32_t)rc(i) & 0xFFFFFF, (uint32_t)rc(i + 1) & 0xFFFFFF, lgfx::VLINEAR); });
+      bench("fillGradientRect_radial", 128 * 96, [&](uint64_t i) { dst.fillGradientRect(rx(i) - 64, ry(i) - 48, 128, 96, (uint32_t)rc(i) & 0xFFFFFF, (uint32_t)rc(i + 1) & 0xFFFFFF, lgfx::RADIAL); });
+    }
+
+    // text per font type
+    static const char text[] = "The quick brown fox 0123";
+    struct font_case_t { const char* name; const lgfx::IFont* font; };
+    const font_case_t fonts[] =
+    { { "text_glcd"    , &lgfx::fonts::Font0 }
+    , { "text_bmp"     , &lgfx::fonts::Font2 }
+    , { "text_rle"     , &lgfx::fonts::Font4 }
+    , { "text_gfx"     , &lgfx::fonts::FreeSans9pt7b }
+    , { "text_u8g2"    , &lgfx::fonts::lgfxJapanGothic_12 }
+    , { "text_vlw"     , nullptr }
+    };
+    for (auto& f : fonts)
+    {
+      lgfx::PointerWrapper vlw;
+      if (f.font) { dst.setFont(f.font); }
+      else
+      {
+        vlw.set(vlw_data.data(), vlw_data.size());
+        dst.loadFont(&vlw);
+      }
+      double pixels = dst.textWidth(text) * dst.fontHeight();
+      std::string name = f.name;
+      dst.setTextColor(TFT_WHITE);
+      bench(name.c_str(), pixels, [&](uint64_t i) { dst.drawString(text, rx(i) - 60, ry(i)); });
+      name += "_bg";
+      dst.setTextColor(TFT_WHITE, TFT_NAVY);
+      bench(name.c_str(), pixels, [&](uint64_t i) { dst.drawString(text, rx(i) - 60, ry(i)); });
+
+      // the same text again through the string cache.
+      dst.setStringCacheSize(64 * 1024);
+      name = std::string(f.name) + "_cached";
+      dst.setTextColor(TFT_WHITE);
+      bench(name.c_str(), pixels, [&](uint64_t i) { dst.drawString(text, rx(i) - 60, ry(i)); });
+      name = std::string(f.name) + "_bg_cached";
+      dst.setTextColor(TFT_WHITE, TFT_NAVY);
+      bench(name.c_str(), pixels, [&](uint64_t i) { dst.drawString(text, rx(i) - 60, ry(i)); });
+      dst.setStringCacheSize(0);
+      if (!f.font) { dst.unloadFont(); }
+    }
+    dst.setFont(&lgfx::fonts::Font0);
+
+    constexpr int n = img_size;
+    if (rgb)
+    {
+      // pushImage per source format
+      bench("pushImage_rgb332", n * n, [&](uint64_t i) { dst.pushImage(rx(i) - n / 2, ry(i) - n / 2, n, n, (const lgfx::rgb332_t*)img332.data()); });
+      bench("pushImage_rgb565", n * n, [&](uint64_t i) { dst.pushImage(rx(i) - n / 2, ry(i) - n / 2, n, n, img565.data()); });
+      bench("pushImage_rgb888", n * n, [&](uint64_t i) { dst.pushImage(rx(i) - n / 2, ry(i) - n / 2, n, n, (const lgfx::rgb888_t*)img888.data()); });
+      bench("pushImage_rgb565_transp", n * n, [&](uint64_t i) { dst.pushImage(rx(i) - n / 2, ry(i) - n / 2, n, n, img565.data(), img565[5]); });
+      bench("pushAlphaImage_argb8888", n * n, [&](uint64_t i) { dst.pushAlphaImage(rx(i) - n / 2, ry(i) - n / 2, n, n, (const lgfx::argb8888_t*)img8888.data()); });
+    }
+
+    // sprite to sprite, same depth and 4bit palette source
+    LGFX_Sprite src(&dst);
+    src.setColorDepth(depth);
+    src.createSprite(n, n);
+    if (rgb) { src.pushImage(0, 0, n, n, img565.data()); }
+    else
+    {
+      src.createPalette();
+      for (int y = 0; y < n; ++y) { for (int x = 0; x < n; ++x) { src.drawPixel(x, y, (x + y) & 15); } }
+    }
+    LGFX_Sprite pal(&dst);
+    pal.setColorDepth(4);
+    pal.createSprite(n, n);
+    pal.createPalette();
+    for (int y = 0; y < n; ++y) { for (int x = 0; x < n; ++x) { pal.drawPixel(x, y, (x ^ y) & 15); } }
+
+    bench("pushSprite_same_depth", n * n, [&](uint64_t i) { src.pushSprite(rx(i) - n / 2, ry(i) - n / 2); });
+    bench("pushSprite_palette4", n * n, [&](uint64_t i) { pal.pushSprite(rx(i) - n / 2, ry(i) - n / 2); });
+    bench("pushRotateZoom_x2", n * n * 4, [&](uint64_t i) { src.pushRotateZoom(rx(i), ry(i), (float)(i % 360), 2.0f, 2.0f); });
+    bench("pushRotateZoomWithAA_x2", n * n * 4, [&](uint64_t i) { src.pushRotateZoomWithAA(rx(i), ry(i), (float)(i % 360), 2.0f, 2.0f); });
+    bench("pushRotateZoom_palette4", n * n * 4, [&](uint64_t i) { pal.pushRotateZoom(rx(i), ry(i), (float)(i % 360), 2.0f, 2.0f); });
+    float matrix[6] = { 1.2f, 0.3f, 0.0f, -0.3f, 1.2f, 0.0f };
+    bench("pushAffine", n * n * 1.53, [&](uint64_t i) { matrix[2] = rx(i) - n / 2; matrix[5] = ry(i) - n / 2; src.pushAffine(matrix); });
+    bench("pushAffineWithAA", n * n * 1.53, [&](uint64_t i) { matrix[2] = rx(i) - n / 2; matrix[5] = ry(i) - n / 2; src.pushAffineWithAA(matrix); });
+
+    if (rgb)
+    {
+      // image decoders, 200x200
+      bench("drawJpg", 200 * 200, [&](uint64_t) { dst.drawJpg(dog_200_200_jpg, sizeof(dog_200_200_jpg), 0, 0); });
+      if (png_data) { bench("drawPng", 200 * 200, [&](uint64_t) { dst.drawPng(png_data, png_len, 0, 0); }); }
+      if (qoi_data) { bench("drawQoi", 200 * 200, [&](uint64_t) { dst.drawQoi(qoi_data, qoi_len, 0, 0); }); }
+      bench("drawBmp", 200 * 200, [&](uint64_t) { dst.drawBmp(bmp_data.data(), bmp_data.size(), 0, 0); });
+    }
+  }
+
+  /// Full frame drawing split into bands with LGFX_ParallelRenderer, by number of threads.
+  void run_parallel(int depth)
+  {
+    current_depth = depth;
+    current_rotation = 0;
+
+    constexpr int w = 1280;
+    constexpr int h = 720;
+    LGFX_Sprite dst;
+    dst.setColorDepth(depth);
+    if (!dst.createSprite(w, h)) { return; }
+
+    constexpr int n = img_size;
+    LGFX_Sprite src(&dst);
+    src.setColorDepth(depth);
+    src.createSprite(n, n);
+    src.pushImage(0, 0, n, n, img565.data());
+
+    lgfx::LGFX_ParallelRenderer pr;
+    for (int threads : { 1, 2, 4, 8 })
+    {
+      pr.init(&dst, threads);
+      char name[48];
+      snprintf(name, sizeof(name), "parallel_fillGradientRect_t%d", threads);
+      bench(name, w * h, [&](uint64_t) { pr.fillGradientRect(0, 0, w, h, 0xFF0000u, 0x0000FFu, lgfx::RADIAL); });
+      snprintf(name, sizeof(name), "parallel_pushRotateZoomWithAA_t%d", threads);
+      bench(name, w * h, [&](uint64_t i) { pr.pushRotateZoomWithAA(&src, w / 2, h / 2, (float)(i % 360), 24.0f, 24.0f); });
+      snprintf(name, sizeof(name), "parallel_fillSmoothCircle_t%d", threads);
+      bench(name, 3.1416 * 300 * 300, [&](uint64_t i) { pr.fillSmoothCircle(w / 2, h / 2, 300, rand_c[i & (rand_count - 1)]); });
+    }
+  }
+
+  void write_json(FILE* fp)
+  {
+    fprintf(fp, "{\n");
+    fprintf(fp, "  \"library\": \"LovyanGFX %d.%d.%d\",\n", LGFX_VERSION_MAJOR, LGFX_VERSION_MINOR, LGFX_VERSION_PATCH);
+    fprintf(fp, "  \"target\": { \"width\": %d, \"height\": %d },\n", target_width, target_height);
+    fprintf(fp, "  \"min_msec\": %u,\n", min_msec);
+    fprintf(fp, "  \"results\": [\n");
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+      auto& r = results[i];
+      fprintf(fp, "    { \"name\": \"%s\", \"depth\": %d, \"rotation\": %d, \"calls\": %llu, \"ns_per_call\": %.1f, \"mpix_per_sec\": %.3f }%s\n",
+              r.name.c_str(), r.depth, r.rotation, (unsigned long long)r.calls, r.ns_per_call, r.mpix_per_sec,
+              (i + 1 < results.size()) ? "," : "");
+    }
+    fprintf(fp, "  ]\n}\n");
+  }
+}
+
+int main(int argc, char** argv)
+{
+  const char* output = nullptr;
+  for (int i = 1; i < argc; ++i)
+  {
+    if      (!strcmp(argv[i], "-o") && i + 1 < argc) { output = argv[++i]; }
+    else if (!strcmp(argv[i], "-t") && i + 1 < argc) { min_msec = atoi(argv[++i]); }
+    else if (!strcmp(argv[i], "-f") && i + 1 < argc) { name_filter = argv[++i]; }
+    else if (!strcmp(argv[i], "-v")) { return run_verify() ? 1 : 0; }
+    else
+    {
+      fprintf(stderr, "usage: %s [-o result.json] [-t msec_per_case] [-f name_filter] | -v\n", argv[0]);
+      return 1;
+    }
+  }
+
+  init_random();
+  make_vlw();
+  make_images();
+
+  static constexpr int depths[] = { 4, 8, 16, 24 };
+  for (int depth : depths)
+  {
+    for (int rotation = 0; rotation < 2; ++rotation)
+    {
+      run_target(depth, rotation);
+    }
+  }
+  run_parallel(16);
+
+  FILE* fp = output ? fopen(output, "w") : stdout;
+  if (fp == nullptr)
+  {
+    fprintf(stderr, "cannot open %s\n", output);
+    return 1;
+  }
+  write_json(fp);
+  if (output) { fclose(fp); }
+
+  if (png_data) { free(png_data); }
+  if (qoi_data) { free(qoi_data); }
+  return 0;
+}
@@ -0,0 +1,950 @@
+// Verify mode of the headless benchmark (-v).
+// Checks that the optimized paths give the same pixels as the plain ones,
+// so that a speedup which changes the output is caught as a failure. (exit code 1)
+
+#define LGFX_USE_V1
+#include <LovyanGFX.hpp>
+#include <lgfx/utility/lgfx_tjpgd.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <vector>
+
+int run_verify(void);
+
+namespace assets
+{ // also included by benchmark.cpp; the sizes are not const, so they are kept apart here.
+#include "assets.h"  // examples/Sprite/TransitionFX/assets.h
+}
+
+namespace
+{
+  using namespace lgfx;
+  using assets::dog_200_200_jpg;
+  using assets::lgfx_logo_201x197_jpg;
+
+  int failures = 0;
+
+  void report(const char* name, int mismatches)
+  {
+    fprintf(stderr, "verify %-40s %s", name, mismatches ? "FAILED" : "ok");
+    if (mismatches) { fprintf(stderr, " (%d mismatches)", mismatches); }
+    fprintf(stderr, "\n");
+    if (mismatches) { ++failures; }
+  }
+
+  uint32_t rand_state = 0x2468ACE1;
+  uint32_t next_rand(void)
+  {
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 17;
+    rand_state ^= rand_state << 5;
+    return rand_state;
+  }
+
+  void fill_random(void* buf, size_t bytes)
+  {
+    auto p = static_cast<uint8_t*>(buf);
+    for (size_t i = 0; i < bytes; ++i) { p[i] = next_rand() >> 24; }
+  }
+
+//----------------------------------------------------------------------------
+// pixelcopy_t : SIMD kernels against color_convert / effect_fill_alpha
+
+  constexpr uint32_t simd_pixels = 300;
+  constexpr uint8_t guard = 0xA5;
+
+  // lengths around the block sizes of the kernels (8, 16, 32 pixels)
+  const uint32_t simd_lengths[] = { 0, 1, 2, 3, 5, 7, 8, 9, 15, 16, 17, 23, 31, 32, 33, 47, 63, 64, 65, 100, 127, 128, 129, 255 };
+
+  template <typename TDst, typename TSrc>
+  bool same_as_scalar(const TDst* d, const TSrc* s, uint32_t len)
+  {
+    for (uint32_t i = 0; i < len; ++i)
+    {
+      TDst ref;
+      ref.set(color_convert<TDst, TSrc>(s[i].get()));
+      if (memcmp(&ref, &d[i], sizeof(TDst))) { return false; }
+    }
+    return true;
+  }
+
+  bool untouched(const void* buf, size_t bytes)
+  {
+    auto p = static_cast<const uint8_t*>(buf);
+    for (size_t i = 0; i < bytes; ++i) { if (p[i] != guard) { return false; } }
+    return true;
+  }
+
+  template <typename TDst, typename TSrc>
+  void verify_copy(const char* name, color_depth_t dst_depth, color_depth_t src_depth)
+  {
+    std::vector<TSrc> src(simd_pixels);
+    std::vector<TDst> dst(simd_pixels + 8);
+    fill_random(src.data(), src.size() * sizeof(TSrc));
+
+    int mismatches = 0;
+    for (uint32_t len : simd_lengths)
+    {
+      for (uint32_t soff = 0; soff < 4; ++soff)
+      {
+        for (uint32_t doff = 0; doff < 4; ++doff)
+        {
+          // the kernel alone : it writes whole blocks only, and nothing after them.
+          memset((void*)dst.data(), guard, dst.size() * sizeof(TDst));
+          uint32_t n = pixelcopy_t::copy_rgb_simd<TDst, TSrc>(&dst[doff], &src[soff], len);
+          if (n > len
+           || !same_as_scalar(&dst[doff], &src[soff], n)
+           || !untouched(&dst[doff + n], (dst.size() - doff - n) * sizeof(TDst)))
+          {
+            ++mismatches;
+          }
+
+          // copy_rgb_fast : the kernel and the scalar tail. the source and destination offsets differ.
+          pixelcopy_t pc(src.data(), dst_depth, src_depth);
+          pc.positions[0] = soff;
+          memset((void*)dst.data(), guard, dst.size() * sizeof(TDst));
+          pixelcopy_t::copy_rgb_fast<TDst, TSrc>(dst.data(), doff, doff + len, &pc);
+          if (!same_as_scalar(&dst[doff], &src[soff], len)
+           || !untouched(&dst[doff + len], (dst.size() - doff - len) * sizeof(TDst)))
+          {
+            ++mismatches;
+          }
+
+          // copy_rgb_affine without scaling : the contiguous path.
+          pixelcopy_t pa(src.data(), dst_depth, src_depth);
+          pa.src_bitwidth = simd_pixels;
+          pa.src_x32 = soff << pixelcopy_t::FP_SCALE;
+          pa.src_y32 = 0;
+          memset((void*)dst.data(), guard, dst.size() * sizeof(TDst));
+          if (len) { pixelcopy_t::copy_rgb_affine<TDst, TSrc>(dst.data(), doff, doff + len, &pa); }
+          if (!same_as_scalar(&dst[doff], &src[soff], len)
+           || !untouched(&dst[doff + len], (dst.size() - doff - len) * sizeof(TDst)))
+          {
+            ++mismatches;
+          }
+        }
+      }
+    }
+    report(name, mismatches);
+  }
+
+  template <typename TDst>
+  void verify_blend(const char* name)
+  {
+    std::vector<TDst> base(simd_pixels);
+    std::vector<TDst> dst(simd_pixels);
+    std::vector<TDst> ref(simd_pixels);
+    fill_random(base.data(), base.size() * sizeof(TDst));
+
+    int mismatches = 0;
+    const uint32_t alphas[] = { 0, 1, 127, 128, 254, 255 };
+    for (uint32_t a : alphas)
+    {
+      uint32_t argb = a << 24 | (next_rand() & 0xFFFFFF);
+      for (uint32_t len : simd_lengths)
+      {
+        for (uint32_t off = 0; off < 4; ++off)
+        {
+          dst = base;
+          ref = base;
+          pixelcopy_t::blend_fill<TDst>(&dst[off], len, argb);
+          effect_fill_alpha effector(argb8888_t { argb });
+          for (uint32_t i = 0; i < len; ++i) { effector(0, 0, ref[off + i]); }
+          if (memcmp(dst.data(), ref.data(), dst.size() * sizeof(TDst))) { ++mismatches; }
+        }
+      }
+    }
+    report(name, mismatches);
+  }
+
+  void verify_pixelcopy(void)
+  {
+    verify_copy<swap565_t, bgr888_t   >("pixelcopy swap565 <- bgr888"   , rgb565_2Byte, rgb888_3Byte);
+    verify_copy<swap565_t, rgb332_t   >("pixelcopy swap565 <- rgb332"   , rgb565_2Byte, rgb332_1Byte);
+    verify_copy<swap565_t, bgra8888_t >("pixelcopy swap565 <- bgra8888" , rgb565_2Byte, argb8888_4Byte);
+    verify_copy<swap565_t, grayscale_t>("pixelcopy swap565 <- grayscale", rgb565_2Byte, grayscale_8bit);
+    verify_copy<bgr888_t , swap565_t  >("pixelcopy bgr888 <- swap565"   , rgb888_3Byte, rgb565_2Byte);
+    verify_copy<bgr888_t , bgra8888_t >("pixelcopy bgr888 <- bgra8888"  , rgb888_3Byte, argb8888_4Byte);
+    verify_copy<bgr888_t , grayscale_t>("pixelcopy bgr888 <- grayscale" , rgb888_3Byte, grayscale_8bit);
+    verify_blend<swap565_t>("pixelcopy blend_fill swap565");
+    verify_blend<bgr888_t >("pixelcopy blend_fill bgr888");
+  }
+
+//----------------------------------------------------------------------------
+// floodFill
+
+  // a filled rect inside an outline. floodFill from the inside must fill exactly the inner area.
+  // the value stored in the sprite for the color.
+  uint32_t raw_of(LGFX_Sprite& spr, uint32_t color)
+  {
+    spr.drawPixel(0, 0, color);
+    return spr.readPixelValue(0, 0);
+  }
+
+  int flood_case(LGFX_Sprite& spr, uint32_t bg, uint32_t line, uint32_t fill)
+  {
+    uint32_t raw_bg   = raw_of(spr, bg);
+    uint32_t raw_line = raw_of(spr, line);
+    uint32_t raw_fill = raw_of(spr, fill);
+    spr.fillScreen(bg);
+    spr.drawRect(10, 8, 30, 20, line);
+    spr.setColor(fill);
+    spr.floodFill(20, 15);
+    int mismatches = 0;
+    for (int y = 0; y < spr.height(); ++y)
+    {
+      for (int x = 0; x < spr.width(); ++x)
+      {
+        bool inner = (x > 10 && x < 39 && y > 8 && y < 27);
+        bool edge = !inner && (x >= 10 && x <= 39 && y >= 8 && y <= 27);
+        uint32_t expect = inner ? raw_fill : edge ? raw_line : raw_bg;
+        if (spr.readPixelValue(x, y) != expect) { ++mismatches; }
+      }
+    }
+    return mismatches;
+  }
+
+  void verify_floodfill(void)
+  {
+    for (int bits : { 1, 4, 8 })
+    {
+      for (int rotation : { 0, 1 })
+      {
+        LGFX_Sprite spr;
+        spr.setColorDepth(bits);
+        spr.createSprite(60, 40);
+        spr.createPalette();
+        spr.setRotation(rotation);
+        uint32_t last = (1u << bits) - 1;
+        int mismatches = flood_case(spr, 0, last, last > 1 ? 2 : 1);
+
+        // two palette entries of the same color : the fill value equals the target value, and nothing is done.
+        // (this used to loop forever, since the check compared the colors converted back from rgb)
+        spr.setPaletteColor(1, TFT_BLACK);
+        spr.setPaletteColor(0, TFT_BLACK);
+        spr.fillScreen(1);
+        spr.setColor(1);
+        spr.floodFill(5, 5);
+        for (int y = 0; y < spr.height(); ++y)
+        {
+          for (int x = 0; x < spr.width(); ++x) { if (spr.readPixelValue(x, y) != 1) { ++mismatches; } }
+        }
+        // the same color, another index : the area gets the new index.
+        spr.setColor(0);
+        spr.floodFill(5, 5);
+        for (int y = 0; y < spr.height(); ++y)
+        {
+          for (int x = 0; x < spr.width(); ++x) { if (spr.readPixelValue(x, y) != 0) { ++mismatches; } }
+        }
+
+        char name[48];
+        snprintf(name, sizeof(name), "floodFill palette %dbit rotation %d", bits, rotation);
+        report(name, mismatches);
+      }
+    }
+
+    for (int depth : { 8, 16, 24 })
+    {
+      LGFX_Sprite spr;
+      spr.setColorDepth(depth);
+      spr.createSprite(60, 40);
+      char name[48];
+      snprintf(name, sizeof(name), "floodFill %dbit", depth);
+      uint32_t bg   = spr.color888(0x20, 0x40, 0x60);
+      uint32_t line = spr.color888(0xFF, 0xFF, 0xFF);
+      uint32_t fill = spr.color888(0xE0, 0x20, 0x00);
+      int mismatches = flood_case(spr, bg, line, fill);
+      // filling with the color already there : nothing changes, and it returns.
+      uint32_t raw_bg = raw_of(spr, bg);
+      spr.fillScreen(bg);
+      spr.setColor(bg);
+      spr.floodFill(5, 5);
+      for (int y = 0; y < spr.height(); ++y)
+      {
+        for (int x = 0; x < spr.width(); ++x) { if (spr.readPixelValue(x, y) != raw_bg) { ++mismatches; } }
+      }
+      report(name, mismatches);
+    }
+  }
+
+//----------------------------------------------------------------------------
+// image cache : a cached draw must give the same pixels as the streaming draw
+
+  // 24bit bottom-up bmp. the last row is white, which must not be taken for the untouched area.
+  std::vector<uint8_t> make_bmp(int w, int h)
+  {
+    uint32_t stride = (w * 3 + 3) & ~3;
+    uint32_t size = 54 + stride * h;
+    std::vector<uint8_t> bmp(size);
+    auto u32 = [&](size_t pos, uint32_t v) { for (int i = 0; i < 4; ++i) { bmp[pos + i] = v >> (i * 8); } };
+    bmp[0] = 'B'; bmp[1] = 'M';
+    u32( 2, size);
+    u32(10, 54);
+    u32(14, 40);
+    u32(18, w);
+    u32(22, h);
+    bmp[26] = 1; bmp[28] = 24;
+    for (int y = 0; y < h; ++y)
+    {
+      auto row = &bmp[54 + (h - 1 - y) * stride];
+      for (int x = 0; x < w; ++x)
+      {
+        bool white = (y == h - 1);
+        row[x * 3 + 0] = white ? 0xFF : (x * 40);
+        row[x * 3 + 1] = white ? 0xFF : (y * 50);
+        row[x * 3 + 2] = white ? 0xFF : 0x80;
+      }
+    }
+    return bmp;
+  }
+
+  // 21x13 baseline jpeg (4:2:0) with a white last row.
+  const uint8_t jpg_21x13[] =
+  {
+    0xFF, 0xD8, 0xFF, 0xDB, 0x00, 0x84, 0x00, 0x10, 0x0B, 0x0C, 0x0E, 0x0C, 0x0A, 0x10, 0x0E, 0x0D,
+    0x0E, 0x12, 0x11, 0x10, 0x13, 0x18, 0x28, 0x1A, 0x18, 0x16, 0x16, 0x18, 0x31, 0x23, 0x25, 0x1D,
+    0x28, 0x3A, 0x33, 0x3D, 0x3C, 0x39, 0x33, 0x38, 0x37, 0x40, 0x48, 0x5C, 0x4E, 0x40, 0x44, 0x57,
+    0x45, 0x37, 0x38, 0x50, 0x6D, 0x51, 0x57, 0x5F, 0x62, 0x67, 0x68, 0x67, 0x3E, 0x4D, 0x71, 0x79,
+    0x70, 0x64, 0x78, 0x5C, 0x65, 0x67, 0x63, 0x01, 0x11, 0x12, 0x12, 0x18, 0x15, 0x18, 0x2F, 0x1A,
+    0x1A, 0x2F, 0x63, 0x42, 0x38, 0x42, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63,
+    0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63,
+    0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63,
+    0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0x63, 0xFF, 0xC0, 0x00, 0x11, 0x08, 0x00, 0x0D, 0x00,
+    0x15, 0x03, 0x01, 0x22, 0x00, 0x02, 0x11, 0x01, 0x03, 0x11, 0x01, 0xFF, 0xC4, 0x00, 0x1F, 0x00,
+    0x00, 0x01, 0x05, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0xFF, 0xC4, 0x00, 0xB5,
+    0x10, 0x00, 0x02, 0x01, 0x03, 0x03, 0x02, 0x04, 0x03, 0x05, 0x05, 0x04, 0x04, 0x00, 0x00, 0x01,
+    0x7D, 0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61,
+    0x07, 0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xA1, 0x08, 0x23, 0x42, 0xB1, 0xC1, 0x15, 0x52, 0xD1,
+    0xF0, 0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0A, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x25, 0x26, 0x27,
+    0x28, 0x29, 0x2A, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48,
+    0x49, 0x4A, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68,
+    0x69, 0x6A, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88,
+    0x89, 0x8A, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9A, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6,
+    0xA7, 0xA8, 0xA9, 0xAA, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA, 0xC2, 0xC3, 0xC4,
+    0xC5, 0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA, 0xE1,
+    0xE2, 0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xE8, 0xE9, 0xEA, 0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7,
+    0xF8, 0xF9, 0xFA, 0xFF, 0xC4, 0x00, 0x1F, 0x01, 0x00, 0x03, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0A, 0x0B, 0xFF, 0xC4, 0x00, 0xB5, 0x11, 0x00, 0x02, 0x01, 0x02, 0x04, 0x04, 0x03,
+    0x04, 0x07, 0x05, 0x04, 0x04, 0x00, 0x01, 0x02, 0x77, 0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05,
+    0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71, 0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42,
+    0x91, 0xA1, 0xB1, 0xC1, 0x09, 0x23, 0x33, 0x52, 0xF0, 0x15, 0x62, 0x72, 0xD1, 0x0A, 0x16, 0x24,
+    0x34, 0xE1, 0x25, 0xF1, 0x17, 0x18, 0x19, 0x1A, 0x26, 0x27, 0x28, 0x29, 0x2A, 0x35, 0x36, 0x37,
+    0x38, 0x39, 0x3A, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4A, 0x53, 0x54, 0x55, 0x56, 0x57,
+    0x58, 0x59, 0x5A, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6A, 0x73, 0x74, 0x75, 0x76, 0x77,
+    0x78, 0x79, 0x7A, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8A, 0x92, 0x93, 0x94, 0x95,
+    0x96, 0x97, 0x98, 0x99, 0x9A, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7, 0xA8, 0xA9, 0xAA, 0xB2, 0xB3,
+    0xB4, 0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA, 0xC2, 0xC3, 0xC4, 0xC5, 0xC6, 0xC7, 0xC8, 0xC9, 0xCA,
+    0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA, 0xE2, 0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xE8,
+    0xE9, 0xEA, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8, 0xF9, 0xFA, 0xFF, 0xDA, 0x00, 0x0C, 0x03,
+    0x01, 0x00, 0x02, 0x11, 0x03, 0x11, 0x00, 0x3F, 0x00, 0xE7, 0x61, 0xD3, 0xB6, 0x7F, 0x0F, 0xFF,
+    0x00, 0x5A, 0xB4, 0xA1, 0xD3, 0xBC, 0xDF, 0xE1, 0xDB, 0x8F, 0xC6, 0xBB, 0x1F, 0xF8, 0x46, 0x63,
+    0xE3, 0xFD, 0x23, 0xA7, 0xFD, 0x33, 0xFF, 0x00, 0xEB, 0xD4, 0xD1, 0x78, 0x7E, 0x38, 0xFF, 0x00,
+    0xE5, 0xB6, 0x7F, 0xE0, 0x1F, 0xFD, 0x7A, 0xA9, 0x56, 0xA9, 0x19, 0x38, 0x25, 0x78, 0x7F, 0x5F,
+    0x3D, 0xFF, 0x00, 0xAE, 0xD1, 0x86, 0xAD, 0x5A, 0x1F, 0x12, 0xB1, 0xCB, 0x47, 0xA7, 0x10, 0xBF,
+    0x2A, 0x8C, 0x7B, 0x8A, 0x7F, 0xD8, 0x1F, 0xFB, 0xAB, 0xF9, 0x57, 0x5B, 0x1E, 0x93, 0x1A, 0x0C,
+    0x6F, 0xCF, 0xFC, 0x06, 0x9F, 0xFD, 0x97, 0x1F, 0xF7, 0xBF, 0x4A, 0x4A, 0xBD, 0x56, 0xBB, 0x7C,
+    0xCF, 0x61, 0x63, 0xEC, 0x8F, 0xFF, 0xD9,
+  };
+
+  void verify_image_cache(void)
+  {
+    auto bmp_5x5 = make_bmp(5, 5);
+    auto bmp_21x13 = make_bmp(21, 13);
+
+    struct image_t { const char* name; bool jpg; const uint8_t* data; uint32_t len; };
+    const image_t images[] =
+    {
+      { "image cache bmp 5x5"  , false, bmp_5x5.data()  , (uint32_t)bmp_5x5.size()   },
+      { "image cache bmp 21x13", false, bmp_21x13.data(), (uint32_t)bmp_21x13.size() },
+      { "image cache jpg 21x13", true , jpg_21x13       , sizeof(jpg_21x13)          },
+    };
+
+    LGFX_Sprite plain;
+    LGFX_Sprite cached;
+    plain.setColorDepth(16);
+    cached.setColorDepth(16);
+    plain.createSprite(80, 60);
+    cached.createSprite(80, 60);
+    cached.setImageCacheSize(1 << 20);
+
+    for (auto& img : images)
+    {
+      int mismatches = 0;
+      for (int zx = 0; zx < 30; ++zx)
+      {
+        for (int zy = 0; zy < 30; ++zy)
+        {
+          float zoom_x = 0.3f + zx * 0.05f;
+          float zoom_y = 0.3f + zy * 0.05f;
+          int32_t off = (zx + zy) % 3;
+          // the background differs from black and white, so the untouched pixels are compared too.
+          plain.fillScreen(0x1234u);
+          cached.fillScreen(0x1234u);
+          if (img.jpg)
+          {
+            plain .drawJpg(img.data, img.len, 3, 2, 0, 0, off, off, zoom_x, zoom_y);
+            cached.drawJpg(img.data, img.len, 3, 2, 0, 0, off, off, zoom_x, zoom_y);
+          }
+          else
+          {
+            plain .drawBmp(img.data, img.len, 3, 2, 0, 0, off, off, zoom_x, zoom_y);
+            cached.drawBmp(img.data, img.len, 3, 2, 0, 0, off, off, zoom_x, zoom_y);
+          }
+          if (memcmp(plain.getBuffer(), cached.getBuffer(), plain.bufferLength())) { ++mismatches; }
+        }
+      }
+      report(img.name, mismatches);
+    }
+  }
+
+//----------------------------------------------------------------------------
+// partial decode : a clipped or offset draw skips the invisible part of the image,
+// and must give the same pixels as the full image cropped to the visible area.
+
+  // 29x23 rgb png, Adam7 interlaced.
+  const uint8_t png_interlaced_29x23[] =
+  {
+    0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A, 0x00, 0x00, 0x00, 0x0D, 0x49, 0x48, 0x44, 0x52,
+    0x00, 0x00, 0x00, 0x1D, 0x00, 0x00, 0x00, 0x17, 0x08, 0x02, 0x00, 0x00, 0x01, 0x0F, 0x6D, 0xE3,
+    0xA8, 0x00, 0x00, 0x02, 0x9C, 0x49, 0x44, 0x41, 0x54, 0x78, 0xDA, 0x5D, 0x95, 0xB1, 0x8D, 0xEC,
+    0x30, 0x0C, 0x44, 0x09, 0x18, 0x5B, 0x86, 0xB1, 0xC0, 0x07, 0x14, 0xB8, 0x05, 0x97, 0xA0, 0xD0,
+    0x89, 0xCA, 0x50, 0xA2, 0x6C, 0xAB, 0x10, 0xA0, 0x12, 0x1C, 0x2B, 0x57, 0x0D, 0x82, 0x5B, 0x50,
+    0xBC, 0x15, 0x38, 0xFE, 0x14, 0x29, 0x7A, 0xA9, 0x3B, 0x4C, 0xC8, 0xA5, 0x47, 0xE4, 0x1B, 0x1E,
+    0x00, 0x80, 0x85, 0x35, 0x81, 0x6B, 0x10, 0x00, 0x8E, 0xD5, 0x1E, 0x2E, 0x1D, 0xA1, 0x1D, 0x19,
+    0xE0, 0x72, 0xF6, 0x0A, 0xE9, 0xCA, 0xED, 0xFA, 0x82, 0x01, 0xF0, 0xB0, 0x17, 0x08, 0x0B, 0x44,
+    0x30, 0xC7, 0xEE, 0x8F, 0x50, 0x8E, 0xB8, 0x1C, 0x15, 0xCC, 0x15, 0xFC, 0x15, 0xCB, 0x55, 0x17,
+    0x2C, 0x83, 0x0D, 0xCC, 0xB6, 0xDA, 0x6D, 0xF7, 0x9B, 0x4B, 0x5B, 0x28, 0x5B, 0x68, 0x5B, 0x5C,
+    0x36, 0x6C, 0x76, 0xEE, 0xE6, 0x74, 0xF6, 0x0C, 0xFE, 0x0C, 0xE9, 0x8C, 0xE5, 0xCC, 0xED, 0xAC,
+    0xCB, 0x89, 0xBF, 0xB8, 0x83, 0xB9, 0x83, 0xBD, 0xA3, 0xBF, 0x73, 0xBA, 0x6B, 0xB9, 0xBF, 0xED,
+    0xFE, 0x2E, 0xF7, 0x0B, 0x7D, 0xE1, 0x47, 0x57, 0x0B, 0x3B, 0x7E, 0x17, 0xED, 0xE1, 0xA7, 0x1B,
+    0x7E, 0x1A, 0xB6, 0xD5, 0x6C, 0xBB, 0xFA, 0x40, 0x6C, 0xBD, 0xFB, 0xB1, 0xA3, 0x27, 0xB4, 0x8E,
+    0xB6, 0xD2, 0x11, 0xCB, 0x91, 0xE9, 0x01, 0xBF, 0x6F, 0xC6, 0x74, 0x66, 0xFE, 0x66, 0x7F, 0x16,
+    0x5A, 0xB6, 0x57, 0xF4, 0x57, 0xC6, 0xC7, 0xA1, 0xF1, 0xFE, 0x3E, 0xB2, 0x11, 0xED, 0x9D, 0x95,
+    0x0D, 0xF2, 0xC0, 0x36, 0xD8, 0x09, 0x9B, 0xF1, 0xE0, 0x52, 0x57, 0x28, 0x24, 0x74, 0x85, 0x5A,
+    0xA0, 0xBB, 0x58, 0x51, 0x66, 0x78, 0x61, 0x3B, 0xEC, 0xA8, 0xAB, 0x74, 0x5F, 0xB1, 0x91, 0xB5,
+    0xA5, 0xBB, 0xFB, 0xEC, 0x28, 0xD3, 0xE5, 0x6C, 0x57, 0xF0, 0xA4, 0xF4, 0x89, 0xA8, 0xF2, 0xC9,
+    0xA8, 0xD6, 0x55, 0x97, 0x4F, 0xED, 0x6F, 0x81, 0xD3, 0x99, 0xAE, 0x60, 0x49, 0xF8, 0x28, 0x7E,
+    0x17, 0x3F, 0xAD, 0x9C, 0xB5, 0x75, 0x7D, 0x79, 0xA8, 0x8E, 0xE7, 0xCA, 0xA3, 0xE5, 0xE9, 0xD2,
+    0xCB, 0xF8, 0x71, 0x63, 0xCC, 0x32, 0xE9, 0x77, 0x40, 0x99, 0x77, 0x44, 0xD9, 0x77, 0x46, 0xF9,
+    0xAE, 0x9A, 0xBA, 0xBE, 0x85, 0xD4, 0xDE, 0x2F, 0xD4, 0xF2, 0xFE, 0xF7, 0x67, 0x26, 0xEB, 0x3C,
+    0x13, 0xA7, 0x67, 0xC2, 0x95, 0xEB, 0x3C, 0x3E, 0x37, 0x8F, 0x2F, 0x4A, 0xE9, 0xB6, 0xD2, 0x6A,
+    0xC7, 0x76, 0xED, 0xE6, 0x3C, 0x09, 0x77, 0xCC, 0x6B, 0xA6, 0x4D, 0x8F, 0x65, 0xEB, 0x31, 0xBB,
+    0x79, 0xCC, 0x51, 0x8F, 0x99, 0x4B, 0x77, 0x2A, 0x75, 0x52, 0x1A, 0x98, 0x11, 0x29, 0xCD, 0x54,
+    0x5A, 0x9F, 0x75, 0xB8, 0x79, 0x1D, 0x71, 0x5E, 0x47, 0x6D, 0xF3, 0x2E, 0xDC, 0xBC, 0x8B, 0x38,
+    0xEF, 0xA2, 0x97, 0xBA, 0x79, 0x6D, 0x71, 0x5E, 0x5B, 0x7D, 0xD6, 0xD6, 0xB9, 0x64, 0x34, 0x99,
+    0x4E, 0x02, 0x74, 0x30, 0x9A, 0xAE, 0x5A, 0x48, 0x48, 0x2A, 0xC3, 0xFA, 0xAC, 0x37, 0xCE, 0xEB,
+    0xAD, 0xF3, 0x7A, 0x5F, 0x9D, 0x6B, 0x46, 0x5B, 0x4A, 0x33, 0x95, 0x56, 0x29, 0xFD, 0x32, 0xE9,
+    0x4D, 0x30, 0x88, 0x33, 0x06, 0x75, 0xC6, 0xE0, 0xC5, 0x18, 0x80, 0xFE, 0x33, 0xB2, 0xE1, 0x87,
+    0x07, 0x95, 0x14, 0xBD, 0xF0, 0x29, 0x35, 0x9A, 0x13, 0x49, 0x50, 0xA7, 0x80, 0xF5, 0xB0, 0xA0,
+    0x89, 0x18, 0xF2, 0x82, 0x06, 0xD1, 0x31, 0x00, 0xE1, 0x5B, 0x53, 0x26, 0x52, 0x06, 0x2F, 0x74,
+    0x7D, 0xA8, 0xA3, 0x66, 0x8C, 0x25, 0x4D, 0x9D, 0x55, 0x4D, 0xBD, 0x74, 0xD4, 0xEC, 0x69, 0x02,
+    0x59, 0xCB, 0x83, 0xA2, 0xA2, 0x6C, 0xD7, 0x58, 0x6A, 0x38, 0x85, 0xBB, 0x41, 0xE9, 0x03, 0xAA,
+    0x62, 0x30, 0xCB, 0x6D, 0xE8, 0x30, 0xAE, 0xCC, 0xA3, 0x5C, 0x08, 0x0D, 0xE6, 0x74, 0x2D, 0xF4,
+    0xCD, 0x10, 0x54, 0x07, 0xAD, 0x72, 0x3F, 0x06, 0xB6, 0x74, 0x45, 0xA4, 0xE9, 0x83, 0xBA, 0x06,
+    0x9E, 0x25, 0x4D, 0xA3, 0x57, 0x4D, 0x93, 0x74, 0xD4, 0x41, 0x50, 0x7D, 0x7B, 0x22, 0x76, 0x05,
+    0xFB, 0x74, 0xA9, 0x74, 0x46, 0x74, 0x52, 0xD4, 0xED, 0xD2, 0x51, 0xD0, 0x77, 0x8C, 0x32, 0x21,
+    0xC9, 0x18, 0xE1, 0xA0, 0x7C, 0xB0, 0x9E, 0x94, 0xE8, 0xAC, 0x0C, 0x15, 0x09, 0x0D, 0xE5, 0x66,
+    0x44, 0x07, 0x45, 0xFF, 0xA6, 0x7E, 0x7D, 0x83, 0x51, 0xE2, 0x8E, 0x3A, 0x7D, 0x2C, 0x69, 0x5A,
+    0x93, 0x6A, 0x5A, 0xA4, 0xA3, 0xF4, 0x7D, 0x8D, 0x60, 0x4A, 0xE6, 0x46, 0x42, 0x9F, 0x90, 0xAA,
+    0xFC, 0x65, 0x1D, 0x58, 0x1D, 0x5B, 0x49, 0xE4, 0xC8, 0x2F, 0xEA, 0x77, 0xA1, 0xF5, 0x9D, 0x96,
+    0x98, 0x8E, 0xA4, 0xCA, 0xCD, 0xD6, 0x91, 0x9D, 0xEE, 0xB7, 0xBE, 0xE2, 0x72, 0xCB, 0x5F, 0xFF,
+    0x01, 0x2F, 0xFE, 0x89, 0xDC, 0x1B, 0x62, 0x59, 0x32, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4E,
+    0x44, 0xAE, 0x42, 0x60, 0x82,
+  };
+
+  bool png_put(void* user, const uint8_t* data, uint32_t len)
+  {
+    auto v = static_cast<std::vector<uint8_t>*>(user);
+    v->insert(v->end(), data, data + len);
+    return true;
+  }
+
+  enum image_kind_t { kind_jpg, kind_png, kind_qoi };
+
+  bool draw_image(LGFX_Sprite& spr, image_kind_t kind, const uint8_t* data, uint32_t len, int32_t x, int32_t y, int32_t maxWidth, int32_t maxHeight, int32_t offX, int32_t offY, float zoom)
+  {
+    switch (kind)
+    {
+    case kind_jpg: return spr.drawJpg(data, len, x, y, maxWidth, maxHeight, offX, offY, zoom, zoom);
+    case kind_png: return spr.drawPng(data, len, x, y, maxWidth, maxHeight, offX, offY, zoom, zoom);
+    default:       return spr.drawQoi(data, len, x, y, maxWidth, maxHeight, offX, offY, zoom, zoom);
+    }
+  }
+
+  void verify_partial_decode(void)
+  {
+    // png and qoi of a pattern, encoded here.
+    LGFX_Sprite pattern;
+    pattern.setColorDepth(24);
+    pattern.createSprite(53, 41);
+    for (int i = 0; i < 60; ++i)
+    {
+      pattern.fillRect(next_rand() % 53, next_rand() % 41, 1 + next_rand() % 20, 1 + next_rand() % 15, pattern.color888(next_rand(), next_rand(), next_rand()));
+    }
+    std::vector<uint8_t> png, qoi;
+    pattern.createPng(png_put, &png);
+    pattern.createQoi(png_put, &qoi);
+
+    struct image_t { const char* name; image_kind_t kind; const uint8_t* data; uint32_t len; int32_t w; int32_t h; };
+    const image_t images[] =
+    {
+      { "partial decode jpg 200x200"        , kind_jpg, dog_200_200_jpg     , sizeof(dog_200_200_jpg)     , 200, 200 },
+      { "partial decode jpg 21x13"          , kind_jpg, jpg_21x13           , sizeof(jpg_21x13)           ,  21,  13 },
+      { "partial decode png 53x41"          , kind_png, png.data()          , (uint32_t)png.size()        ,  53,  41 },
+      { "partial decode png 29x23 interlaced", kind_png, png_interlaced_29x23, sizeof(png_interlaced_29x23),  29,  23 },
+      { "partial decode qoi 53x41"          , kind_qoi, qoi.data()          , (uint32_t)qoi.size()        ,  53,  41 },
+    };
+    const float zooms[] = { 1.0f, 0.5f, 0.75f, 1.3f, 2.0f };
+
+    LGFX_Sprite full;
+    LGFX_Sprite expect;
+    LGFX_Sprite drawn;
+    full.setColorDepth(16);
+    expect.setColorDepth(16);
+    drawn.setColorDepth(16);
+    expect.createSprite(120, 100);
+    drawn.createSprite(120, 100);
+
+    for (auto& img : images)
+    {
+      int mismatches = 0;
+      for (float zoom : zooms)
+      {
+        int32_t sw = ceilf(img.w * zoom);
+        int32_t sh = ceilf(img.h * zoom);
+        full.createSprite(sw, sh);
+        full.fillScreen(0x1234u);
+        draw_image(full, img.kind, img.data, img.len, 0, 0, 0, 0, 0, 0, zoom);
+
+        for (int i = 0; i < 40; ++i)
+        {
+          int32_t cl = next_rand() % 60;
+          int32_t ct = next_rand() % 50;
+          int32_t cw = 1 + next_rand() % (120 - cl);
+          int32_t ch = 1 + next_rand() % (100 - ct);
+          int32_t x  = (int32_t)(next_rand() % 100) - 40;
+          int32_t y  = (int32_t)(next_rand() % 90) - 40;
+          int32_t mw = (next_rand() & 1) ? 1 + next_rand() % 80 : 0;
+          int32_t mh = (next_rand() & 1) ? 1 + next_rand() % 80 : 0;
+          int32_t ox = next_rand() % 24;
+          int32_t oy = next_rand() % 24;
+
+          drawn.clearClipRect();
+          drawn.fillScreen(0x1234u);
+          drawn.setClipRect(cl, ct, cw, ch);
+          draw_image(drawn, img.kind, img.data, img.len, x, y, mw, mh, ox, oy, zoom);
+          drawn.clearClipRect();
+
+          // the full image placed at the same position, inside the clip rect and the max size.
+          int32_t vl = std::max(cl, x);
+          int32_t vt = std::max(ct, y);
+          int32_t vr = std::min(cl + cw, mw ? x + mw : INT16_MAX);
+          int32_t vb = std::min(ct + ch, mh ? y + mh : INT16_MAX);
+          expect.clearClipRect();
+          expect.fillScreen(0x1234u);
+          if (vl < vr && vt < vb)
+          {
+            expect.setClipRect(vl, vt, vr - vl, vb - vt);
+            full.pushSprite(&expect, x - ox, y - oy);
+            expect.clearClipRect();
+          }
+          if (memcmp(expect.getBuffer(), drawn.getBuffer(), expect.bufferLength())) { ++mismatches; }
+        }
+      }
+      report(img.name, mismatches);
+    }
+  }
+
+//----------------------------------------------------------------------------
+// jpeg output : the native pixel formats and the direct write into the sprite memory,
+// against the bgr888 output of the decoder drawn with pushImage.
+
+  struct jpg_source_t
+  {
+    const uint8_t* data;
+    uint32_t len;
+    uint32_t pos;
+    LGFX_Sprite* dst;
+    int32_t x;
+    int32_t y;
+  };
+
+  uint32_t jpg_source_read(void* device, uint8_t* buf, uint32_t len)
+  {
+    auto src = static_cast<jpg_source_t*>(device);
+    len = std::min(len, src->len - src->pos);
+    if (buf) { memcpy(buf, &src->data[src->pos], len); }
+    src->pos += len;
+    return len;
+  }
+
+  uint32_t jpg_source_push(void* device, void* bitmap, JRECT* rect)
+  {
+    auto src = static_cast<jpg_source_t*>(device);
+    src->dst->pushImage(src->x + rect->left, src->y + rect->top, rect->right - rect->left + 1, rect->bottom - rect->top + 1, (const bgr888_t*)bitmap);
+    return 1;
+  }
+
+  // keeps the decoded image in memory. (`image` has `image_w` pixels of `bytes` per line)
+  struct jpg_capture_t : public jpg_source_t
+  {
+    uint8_t* image;
+    int32_t image_w;
+    int32_t bytes;
+    int32_t w;  // size of the decoded image
+    int32_t h;
+  };
+
+  uint32_t jpg_capture(void* device, void* bitmap, JRECT* rect)
+  {
+    auto cap = static_cast<jpg_capture_t*>(device);
+    int32_t len = (rect->right - rect->left + 1) * cap->bytes;
+    auto src = static_cast<const uint8_t*>(bitmap);
+    for (uint32_t y = rect->top; y <= rect->bottom; ++y, src += len)
+    {
+      memcpy(&cap->image[(y * cap->image_w + rect->left) * cap->bytes], src, len);
+    }
+    cap->w = std::max<int32_t>(cap->w, rect->right + 1);
+    cap->h = std::max<int32_t>(cap->h, rect->bottom + 1);
+    return 1;
+  }
+
+  // decodes the whole image at 1 / (1 << scale) into cap.image.
+  bool jpg_decode(jpg_capture_t& cap, const uint8_t* data, uint32_t len, uint8_t scale, uint8_t format)
+  {
+    cap.data = data;
+    cap.len = len;
+    cap.pos = 0;
+    cap.w = cap.h = 0;
+    cap.bytes = (format == JD_FORMAT_RGB888) ? 3 : 1;
+    std::vector<uint8_t> pool(3900);
+    lgfxJdec jd;
+    if (lgfx_jd_prepare(&jd, jpg_source_read, pool.data(), pool.size(), &cap) != JDR_OK) { return false; }
+    jd.format = format;
+    return lgfx_jd_decomp(&jd, jpg_capture, scale) == JDR_OK;
+  }
+
+  // decodes the whole image to bgr888 at 1 / (1 << scale), and pushes it at (x, y).
+  bool jpg_reference(LGFX_Sprite& dst, const uint8_t* data, uint32_t len, int32_t x, int32_t y, uint8_t scale = 0)
+  {
+    jpg_source_t src = { data, len, 0, &dst, x, y };
+    std::vector<uint8_t> pool(3900);
+    lgfxJdec jd;
+    if (lgfx_jd_prepare(&jd, jpg_source_read, pool.data(), pool.size(), &src) != JDR_OK) { return false; }
+    jd.format = JD_FORMAT_RGB888;
+    return lgfx_jd_decomp(&jd, jpg_source_push, scale) == JDR_OK;
+  }
+
+  struct placement_t { int32_t cl, ct, cw, ch, x, y, mw, mh, ox, oy; };
+
+  // random clip rect, position, max size and offset in a w x h target.
+  placement_t random_placement(int32_t w, int32_t h, int32_t img_w, int32_t img_h)
+  {
+    placement_t p;
+    p.cl = next_rand() % (w / 2);
+    p.ct = next_rand() % (h / 2);
+    p.cw = 1 + next_rand() % (w - p.cl);
+    p.ch = 1 + next_rand() % (h - p.ct);
+    p.x  = (int32_t)(next_rand() % (img_w + w)) - img_w;  // the right / bottom edge of the image is visible at times
+    p.y  = (int32_t)(next_rand() % (img_h + h)) - img_h;
+    p.mw = (next_rand() & 1) ? 1 + next_rand() % w : 0;
+    p.mh = (next_rand() & 1) ? 1 + next_rand() % h : 0;
+    p.ox = next_rand() % 24;
+    p.oy = next_rand() % 24;
+    return p;
+  }
+
+  // the area the image is drawn in : the clip rect and the max size. false if empty.
+  bool placement_rect(const placement_t& p, int32_t& l, int32_t& t, int32_t& w, int32_t& h)
+  {
+    l = std::max(p.cl, p.x);
+    t = std::max(p.ct, p.y);
+    int32_t r = std::min(p.cl + p.cw, p.mw ? p.x + p.mw : INT16_MAX);
+    int32_t b = std::min(p.ct + p.ch, p.mh ? p.y + p.mh : INT16_MAX);
+    w = r - l;
+    h = b - t;
+    return w > 0 && h > 0;
+  }
+
+  void verify_jpg_output(void)
+  {
+    struct image_t { const char* name; const uint8_t* data; uint32_t len; int32_t w; int32_t h; };
+    const image_t images[] =
+    {
+      { "jpg output 200x200", dog_200_200_jpg      , sizeof(dog_200_200_jpg)      , 200, 200 },
+      { "jpg output 201x197", lgfx_logo_201x197_jpg, sizeof(lgfx_logo_201x197_jpg), 201, 197 },  // the last MCU is cut off
+      { "jpg output 21x13"  , jpg_21x13            , sizeof(jpg_21x13)            ,  21,  13 },
+    };
+
+    for (auto& img : images)
+    {
+      int mismatches = 0;
+      for (auto depth : { rgb332_1Byte, rgb565_2Byte, rgb888_3Byte })
+      {
+        LGFX_Sprite expect;
+        LGFX_Sprite drawn;
+        expect.setColorDepth(depth);
+        drawn.setColorDepth(depth);
+        expect.createSprite(120, 100);
+        drawn.createSprite(120, 100);
+        // rotation 0 writes into the memory directly, the others go through pushImage in the native format.
+        for (int rotation = 0; rotation < 4; ++rotation)
+        {
+          expect.setRotation(rotation);
+          drawn.setRotation(rotation);
+          for (int i = 0; i < 25; ++i)
+          {
+            auto p = random_placement(drawn.width(), drawn.height(), img.w, img.h);
+            drawn.clearClipRect();
+            drawn.fillScreen(0x1234u);
+            drawn.setClipRect(p.cl, p.ct, p.cw, p.ch);
+            drawn.drawJpg(img.data, img.len, p.x, p.y, p.mw, p.mh, p.ox, p.oy);
+            drawn.clearClipRect();
+
+            expect.clearClipRect();
+            expect.fillScreen(0x1234u);
+            int32_t l, t, w, h;
+            if (placement_rect(p, l, t, w, h))
+            {
+              expect.setClipRect(l, t, w, h);
+              jpg_reference(expect, img.data, img.len, p.x - p.ox, p.y - p.oy);
+              expect.clearClipRect();
+            }
+            if (memcmp(expect.getBuffer(), drawn.getBuffer(), expect.bufferLength())) { ++mismatches; }
+          }
+        }
+      }
+      report(img.name, mismatches);
+    }
+  }
+
+//----------------------------------------------------------------------------
+// jpeg luma : grayscale and palette targets decode only the luma.
+
+  // 45x30 grayscale jpeg.
+  const uint8_t jpg_gray_45x30[] =
+  {
+    0xFF, 0xD8, 0xFF, 0xDB, 0x00, 0x43, 0x00, 0x10, 0x0B, 0x0C, 0x0E, 0x0C, 0x0A, 0x10, 0x0E, 0x0D,
+    0x0E, 0x12, 0x11, 0x10, 0x13, 0x18, 0x28, 0x1A, 0x18, 0x16, 0x16, 0x18, 0x31, 0x23, 0x25, 0x1D,
+    0x28, 0x3A, 0x33, 0x3D, 0x3C, 0x39, 0x33, 0x38, 0x37, 0x40, 0x48, 0x5C, 0x4E, 0x40, 0x44, 0x57,
+    0x45, 0x37, 0x38, 0x50, 0x6D, 0x51, 0x57, 0x5F, 0x62, 0x67, 0x68, 0x67, 0x3E, 0x4D, 0x71, 0x79,
+    0x70, 0x64, 0x78, 0x5C, 0x65, 0x67, 0x63, 0xFF, 0xC0, 0x00, 0x0B, 0x08, 0x00, 0x1E, 0x00, 0x2D,
+    0x01, 0x01, 0x11, 0x00, 0xFF, 0xC4, 0x00, 0x1F, 0x00, 0x00, 0x01, 0x05, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06,
+    0x07, 0x08, 0x09, 0x0A, 0x0B, 0xFF, 0xC4, 0x00, 0xB5, 0x10, 0x00, 0x02, 0x01, 0x03, 0x03, 0x02,
+    0x04, 0x03, 0x05, 0x05, 0x04, 0x04, 0x00, 0x00, 0x01, 0x7D, 0x01, 0x02, 0x03, 0x00, 0x04, 0x11,
+    0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07, 0x22, 0x71, 0x14, 0x32, 0x81, 0x91,
+    0xA1, 0x08, 0x23, 0x42, 0xB1, 0xC1, 0x15, 0x52, 0xD1, 0xF0, 0x24, 0x33, 0x62, 0x72, 0x82, 0x09,
+    0x0A, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2A, 0x34, 0x35, 0x36, 0x37,
+    0x38, 0x39, 0x3A, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4A, 0x53, 0x54, 0x55, 0x56, 0x57,
+    0x58, 0x59, 0x5A, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6A, 0x73, 0x74, 0x75, 0x76, 0x77,
+    0x78, 0x79, 0x7A, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8A, 0x92, 0x93, 0x94, 0x95, 0x96,
+    0x97, 0x98, 0x99, 0x9A, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7, 0xA8, 0xA9, 0xAA, 0xB2, 0xB3, 0xB4,
+    0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA, 0xC2, 0xC3, 0xC4, 0xC5, 0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xD2,
+    0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA, 0xE1, 0xE2, 0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xE8,
+    0xE9, 0xEA, 0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8, 0xF9, 0xFA, 0xFF, 0xDA, 0x00, 0x08,
+    0x01, 0x01, 0x00, 0x00, 0x3F, 0x00, 0xC7, 0xD2, 0xF4, 0xD9, 0x01, 0x1B, 0x13, 0x27, 0xDC, 0x8A,
+    0xEC, 0xB4, 0x98, 0x12, 0x35, 0x55, 0x90, 0xED, 0x90, 0x76, 0xC5, 0x73, 0x9A, 0xDC, 0x66, 0xFB,
+    0xC5, 0x57, 0x80, 0xA4, 0xAA, 0x61, 0x08, 0x98, 0x77, 0x07, 0xB6, 0x72, 0xA3, 0xB0, 0x3D, 0x71,
+    0xEE, 0x49, 0xC6, 0x70, 0x36, 0x74, 0x9B, 0x17, 0x8D, 0x95, 0xA4, 0x5D, 0xB1, 0x8E, 0xF5, 0x81,
+    0xE3, 0x3B, 0x99, 0xA5, 0xD6, 0x22, 0xB6, 0x96, 0x26, 0x8E, 0x28, 0x41, 0x68, 0x77, 0x10, 0x77,
+    0x29, 0xC0, 0x2D, 0xC7, 0xA9, 0x53, 0xD4, 0xF4, 0xC7, 0x00, 0xE7, 0x3A, 0x56, 0x9A, 0x61, 0xF2,
+    0xBA, 0x1A, 0xD4, 0xB1, 0xD3, 0x82, 0x46, 0x5D, 0xB7, 0x28, 0x51, 0xB8, 0xED, 0x42, 0x49, 0xC7,
+    0xA0, 0x1C, 0x9F, 0xA0, 0xAC, 0xDD, 0x37, 0xC5, 0x3E, 0x76, 0x1F, 0xFB, 0x37, 0x1B, 0xBB, 0xF9,
+    0xD9, 0xFF, 0x00, 0xD9, 0x6A, 0xA9, 0x63, 0x67, 0xA9, 0x5C, 0x5E, 0x34, 0x6B, 0x31, 0xBD, 0x90,
+    0xBE, 0xC5, 0x01, 0x7C, 0xBC, 0x1E, 0x9C, 0x0E, 0x7A, 0xF5, 0xE3, 0x38, 0xCF, 0x7A, 0xE8, 0xB4,
+    0xDB, 0xFF, 0x00, 0x3B, 0x09, 0xF6, 0x7C, 0x6E, 0xED, 0xBF, 0x3F, 0xD2, 0xB8, 0xBF, 0x12, 0x24,
+    0x83, 0x5F, 0x26, 0x6B, 0xF8, 0xEF, 0x24, 0x29, 0xF3, 0x79, 0x7F, 0x2A, 0xC4, 0x43, 0x11, 0xE5,
+    0x81, 0x93, 0x8C, 0x63, 0xEB, 0xCF, 0x3C, 0xF3, 0x5D, 0x16, 0xAF, 0xE2, 0x3B, 0x6D, 0x1A, 0xE1,
+    0x6D, 0x60, 0xB5, 0x5B, 0xD7, 0x00, 0x99, 0x0A, 0xC8, 0x00, 0x8C, 0xE4, 0x8D, 0xA7, 0x00, 0xF3,
+    0xC1, 0xC8, 0xE3, 0x1C, 0x56, 0x4E, 0xA1, 0xE2, 0x4B, 0xAD, 0x42, 0x79, 0xA2, 0xB4, 0x66, 0x8B,
+    0x4E, 0x96, 0x3F, 0x2F, 0xCA, 0x68, 0xD7, 0x73, 0x02, 0x3E, 0x6C, 0x9E, 0x7D, 0x48, 0xE0, 0xF4,
+    0xC7, 0x7A, 0x8A, 0xC2, 0x07, 0x8D, 0xB6, 0xC6, 0x76, 0xC6, 0x3B, 0x62, 0xB7, 0x52, 0xD3, 0xED,
+    0x1E, 0x56, 0x47, 0xDD, 0xCF, 0x5F, 0xC2, 0xB5, 0xE3, 0x4B, 0x5D, 0x3A, 0xDD, 0xAE, 0x25, 0x65,
+    0x84, 0xA0, 0x27, 0x71, 0x39, 0xE8, 0x09, 0x6C, 0x0E, 0xFC, 0x06, 0x38, 0x03, 0xB5, 0x79, 0xDD,
+    0xD4, 0x96, 0x13, 0xDF, 0xAB, 0x69, 0x76, 0xB2, 0x5B, 0x5B, 0x04, 0x00, 0x2B, 0xB6, 0xE2, 0xC7,
+    0xB9, 0x39, 0x27, 0x1E, 0x98, 0xCF, 0x6F, 0x7A, 0x9E, 0xD3, 0x4C, 0x1E, 0x57, 0x41, 0x5A, 0x9A,
+    0x75, 0xAA, 0xC6, 0x01, 0x1F, 0x4E, 0x6A, 0xE7, 0x89, 0x75, 0x29, 0x34, 0xCD, 0x1E, 0x0B, 0x78,
+    0x62, 0x8D, 0x8D, 0xF2, 0x4A, 0x8E, 0xCF, 0x9F, 0x95, 0x40, 0xC1, 0xC0, 0xF5, 0xF9, 0xBA, 0xFB,
+    0x74, 0xAC, 0x4D, 0x02, 0xDD, 0x64, 0xDD, 0xBB, 0xB6, 0x3A, 0x57, 0x49, 0x77, 0x77, 0x2E, 0x95,
+    0xA4, 0xCD, 0x77, 0x6E, 0xB1, 0xB4, 0x91, 0x6D, 0x0A, 0x24, 0x04, 0x83, 0x96, 0x03, 0x9C, 0x11,
+    0xEB, 0x5C, 0x85, 0xB6, 0xF9, 0xAE, 0x5E, 0x69, 0x58, 0x3C, 0x92, 0xB1, 0x91, 0xD8, 0x8C, 0x65,
+    0x89, 0xC9, 0x3C, 0x57, 0x5D, 0x69, 0x64, 0x9E, 0x57, 0x53, 0x5F, 0xFF, 0xD9,
+  };
+
+  void verify_jpg_luma(void)
+  {
+    // rgb targets do not take the luma path, at every scale of the decoder.
+    {
+      int mismatches = 0;
+      for (auto depth : { rgb332_1Byte, rgb565_2Byte, rgb888_3Byte })
+      {
+        LGFX_Sprite expect;
+        LGFX_Sprite drawn;
+        expect.setColorDepth(depth);
+        drawn.setColorDepth(depth);
+        expect.createSprite(120, 100);
+        drawn.createSprite(120, 100);
+        for (uint8_t scale = 0; scale < 4; ++scale)
+        {
+          for (int i = 0; i < 10; ++i)
+          {
+            auto p = random_placement(drawn.width(), drawn.height(), 200 >> scale, 200 >> scale);
+            drawn.clearClipRect();
+            drawn.fillScreen(0x1234u);
+            drawn.setClipRect(p.cl, p.ct, p.cw, p.ch);
+            drawn.drawJpg(dog_200_200_jpg, sizeof(dog_200_200_jpg), p.x, p.y, p.mw, p.mh, p.ox, p.oy, 1.0f / (1 << scale), 1.0f / (1 << scale));
+            drawn.clearClipRect();
+
+            expect.clearClipRect();
+            expect.fillScreen(0x1234u);
+            int32_t l, t, w, h;
+            if (placement_rect(p, l, t, w, h))
+            {
+              expect.setClipRect(l, t, w, h);
+              jpg_reference(expect, dog_200_200_jpg, sizeof(dog_200_200_jpg), p.x - p.ox, p.y - p.oy, scale);
+              expect.clearClipRect();
+            }
+            if (memcmp(expect.getBuffer(), drawn.getBuffer(), expect.bufferLength())) { ++mismatches; }
+          }
+        }
+      }
+      report("jpg luma rgb targets", mismatches);
+    }
+
+    // the luma output of a grayscale jpeg, against its bgr888 output (r = g = b = luma + the bayer dither)
+    // and against the average of the full size luma on the scaled outputs.
+    {
+      static constexpr int8_t bayer[16] = { 0, 4, 1, 5,-2, 2,-1, 3, 1, 5, 0, 4,-1, 3,-2, 2};  // JD_BAYER of lgfx_tjpgd.c
+      static constexpr int32_t gw = 45, gh = 30;
+      int mismatches = 0;
+      std::vector<uint8_t> rgb(gw * gh * 3);
+      std::vector<uint8_t> full(gw * gh);
+      std::vector<uint8_t> gray(gw * gh);
+      jpg_capture_t fc = {};
+      fc.image = full.data();
+      fc.image_w = gw;
+      if (!jpg_decode(fc, jpg_gray_45x30, sizeof(jpg_gray_45x30), 0, JD_FORMAT_GRAY8) || fc.w != gw || fc.h != gh) { ++mismatches; }
+      for (uint8_t scale = 0; scale < 4; ++scale)
+      {
+        jpg_capture_t rc = {}, gc = {};
+        rc.image = rgb.data();  rc.image_w = gw;
+        gc.image = gray.data(); gc.image_w = gw;
+        if (!jpg_decode(rc, jpg_gray_45x30, sizeof(jpg_gray_45x30), scale, JD_FORMAT_RGB888)
+         || !jpg_decode(gc, jpg_gray_45x30, sizeof(jpg_gray_45x30), scale, JD_FORMAT_GRAY8)
+         || rc.w != gc.w || rc.h != gc.h)
+        {
+          ++mismatches;
+          continue;
+        }
+        int32_t size = 1 << scale;
+        for (int32_t y = 0; y < gc.h; ++y)
+        {
+          for (int32_t x = 0; x < gc.w; ++x)
+          {
+            uint8_t v = gray[y * gw + x];
+            if (scale == 0)
+            { // away from the clipping, the dither is added to the luma.
+              if (v >= 8 && v <= 247 && v + bayer[(y & 3) * 4 + (x & 3)] != rgb[(y * gw + x) * 3]) { ++mismatches; }
+            }
+            else if (scale == 3)
+            { // the DC value of each block, without the dither.
+              if (v != rgb[(y * gw + x) * 3]) { ++mismatches; }
+            }
+            else if ((x + 1) * size <= gw && (y + 1) * size <= gh)
+            { // the average of the square. (the squares in the image only, the MCUs are cut off at the edges)
+              uint32_t sum = 0;
+              for (int32_t j = 0; j < size; ++j)
+              {
+                for (int32_t i = 0; i < size; ++i) { sum += full[(y * size + j) * gw + x * size + i]; }
+              }
+              if (v != (sum >> (scale * 2))) { ++mismatches; }
+            }
+          }
+        }
+      }
+      report("jpg luma descale", mismatches);
+    }
+
+    // grayscale and palette sprites get the luma, shifted to the bits of the pixel.
+    struct target_t { const char* name; color_depth_t depth; bool palette; };
+    const target_t targets[] =
+    {
+      { "jpg luma grayscale 8bit", grayscale_8bit, false },
+      { "jpg luma palette 1bit"  , grayscale_1bit, true  },
+      { "jpg luma palette 2bit"  , grayscale_2bit, true  },
+      { "jpg luma palette 4bit"  , grayscale_4bit, true  },
+    };
+    struct image_t { const uint8_t* data; uint32_t len; int32_t w; int32_t h; };
+    const image_t images[] =
+    {
+      { dog_200_200_jpg, sizeof(dog_200_200_jpg), 200, 200 },
+      { jpg_gray_45x30 , sizeof(jpg_gray_45x30) ,  45,  30 },
+    };
+    for (auto& target : targets)
+    {
+      int mismatches = 0;
+      LGFX_Sprite drawn;
+      drawn.setColorDepth(target.depth);
+      drawn.createSprite(120, 100);
+      if (target.palette) { drawn.createPalette(); }
+      uint8_t shift = 8 - (target.depth & color_depth_t::bit_mask);
+      for (auto& img : images)
+      {
+        std::vector<uint8_t> luma(img.w * img.h);
+        for (uint8_t scale = 0; scale < 4; ++scale)
+        {
+          jpg_capture_t cap = {};
+          cap.image = luma.data();
+          cap.image_w = img.w;
+          if (!jpg_decode(cap, img.data, img.len, scale, JD_FORMAT_GRAY8)) { ++mismatches; continue; }
+          for (int i = 0; i < 10; ++i)
+          {
+            auto p = random_placement(drawn.width(), drawn.height(), cap.w, cap.h);
+            drawn.clearClipRect();
+            drawn.fillScreen(1u);
+            uint32_t bg = drawn.readPixelValue(0, 0);
+            drawn.setClipRect(p.cl, p.ct, p.cw, p.ch);
+            drawn.drawJpg(img.data, img.len, p.x, p.y, p.mw, p.mh, p.ox, p.oy, 1.0f / (1 << scale), 1.0f / (1 << scale));
+            drawn.clearClipRect();
+
+            int32_t l, t, w, h;
+            if (!placement_rect(p, l, t, w, h)) { l = t = w = h = 0; }
+            for (int32_t y = 0; y < drawn.height(); ++y)
+            {
+              for (int32_t x = 0; x < drawn.width(); ++x)
+              {
+                int32_t ix = x - (p.x - p.ox);
+                int32_t iy = y - (p.y - p.oy);
+                bool inside = x >= l && x < l + w && y >= t && y < t + h
+                           && ix >= 0 && ix < cap.w && iy >= 0 && iy < cap.h;
+                uint32_t expect = inside ? (luma[iy * img.w + ix] >> shift) : bg;
+                if (drawn.readPixelValue(x, y) != expect) { ++mismatches; }
+              }
+            }
+          }
+        }
+      }
+      report(target.name, mismatches);
+    }
+  }
+}
+
+/// @return the number of failed checks.
+int run_verify(void)
+{
+  failures = 0;
+  verify_pixelcopy();
+  verify_floodfill();
+  verify_image_cache();
+  verify_partial_decode();
+  verify_jpg_output();
+  verify_jpg_luma();
+  fprintf(stderr, "verify : %d failed\n", failures);
+  return failures;
+}
@@ -0,0 +1,156 @@
+// Runs the same drawing workload on several panel drivers connected to a Bus_Trace,
+// and reports the bytes on the wire and the estimated transfer time of each.
+
+#include <LovyanGFX.hpp>
+#include <lgfx/v1/misc/Bus_Trace.hpp>
+#include <lgfx/v1/panel/Panel_ST7789.hpp>
+#include <lgfx/v1/panel/Panel_ILI9341.hpp>
+#include <lgfx/v1/panel/Panel_SSD1306.hpp>
+#include <lgfx/v1/panel/Panel_IT8951.hpp>
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+struct LGFX_Trace : public lgfx::LGFX_Device
+{
+  lgfx::Bus_Trace _bus_instance;
+
+  LGFX_Trace(lgfx::Panel_Device* panel, uint16_t width, uint16_t height, const lgfx::Bus_Trace::config_t& bus_cfg)
+  {
+    _bus_instance.config(bus_cfg);
+    panel->setBus(&_bus_instance);
+
+    auto cfg = panel->config();
+    cfg.memory_width  = cfg.panel_width  = width;
+    cfg.memory_height = cfg.panel_height = height;
+    cfg.readable = false;
+    panel->config(cfg);
+    setPanel(panel);
+  }
+};
+
+static void workload(LGFX_Trace& lcd)
+{
+  static uint16_t image[64 * 64];
+  for (int y = 0; y < 64; ++y)
+  {
+    for (int x = 0; x < 64; ++x)
+    {
+      image[x + y * 64] = lcd.swap565(x * 4, y * 4, (x + y) * 2);
+    }
+  }
+
+  uint32_t rnd = 1;
+  auto random = [&rnd](int range) { rnd = rnd * 1103515245 + 12345; return (int)((rnd >> 16) % range); };
+  int w = lcd.width();
+  int h = lcd.height();
+
+  lcd.startWrite();
+  lcd.fillScreen(TFT_BLACK);
+  for (int i = 0; i < 100; ++i)
+  {
+    lcd.fillRect(random(w), random(h), random(32) + 1, random(32) + 1, random(65536));
+  }
+  for (int i = 0; i < 50; ++i)
+  {
+    lcd.drawLine(random(w), random(h), random(w), random(h), random(65536));
+  }
+  lcd.fillCircle(w >> 1, h >> 1, std::min(w, h) >> 2, TFT_YELLOW);
+  lcd.setTextColor(TFT_WHITE, TFT_BLUE);
+  lcd.drawString("LovyanGFX Bus_Trace", 0, 0, &fonts::Font2);
+  lcd.pushImage((w - 64) >> 1, (h - 64) >> 1, 64, 64, image);
+  lcd.endWrite();
+  lcd.display();
+  lcd.waitDisplay();
+}
+
+static bool run(const char* name, lgfx::Panel_Device* panel, uint16_t width, uint16_t height, lgfx::Bus_Trace::config_t bus_cfg, const char* out_dir)
+{
+  std::string path;
+  if (out_dir)
+  {
+    path = std::string(out_dir) + "/" + name + ".trace";
+    bus_cfg.file_path = path.c_str();
+  }
+  else
+  {
+    bus_cfg.record = false;
+  }
+
+  LGFX_Trace lcd(panel, width, height, bus_cfg);
+  auto& bus = lcd._bus_instance;
+  if (!lcd.init())
+  {
+    fprintf(stderr, "%s: init failed\n", name);
+    return false;
+  }
+  auto init_bytes = bus.getWriteBytes();
+  bus.clearTrace();
+
+  workload(lcd);
+
+  printf("%-8s %4dx%-4d %9u Hz x%-2u %8llu %10llu %8u %6u %10.3f\n", name, width, height
+        , bus_cfg.freq_write, bus_cfg.bus_width
+        , (unsigned long long)init_bytes
+        , (unsigned long long)bus.getWriteBytes()
+        , bus.getCommandCount()
+        , bus.getTransactionCount()
+        , bus.getEstimatedTime() / 1000000.0);
+  bus.release();
+  return true;
+}
+
+int main(int argc, char** argv)
+{
+  const char* out_dir = nullptr;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (0 == strcmp(argv[i], "-o") && i + 1 < argc) { out_dir = argv[++i]; }
+    else
+    {
+      fprintf(stderr, "usage: %s [-o trace_dir]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  printf("%-8s %-9s %-18s %8s %10s %8s %6s %10s\n", "panel", "size", "bus", "init[B]", "bytes", "commands", "trans", "time[ms]");
+
+  bool ok = true;
+  {
+    lgfx::Bus_Trace::config_t cfg;
+    cfg.freq_write = 40000000;
+    lgfx::Panel_ST7789 panel;
+    ok &= run("ST7789", &panel, 240, 320, cfg, out_dir);
+  }
+  {
+    lgfx::Bus_Trace::config_t cfg;
+    cfg.freq_write = 40000000;
+    lgfx::Panel_ILI9341 panel;
+    ok &= run("ILI9341", &panel, 240, 320, cfg, out_dir);
+  }
+  {
+    lgfx::Bus_Trace::config_t cfg;
+    cfg.freq_write = 16000000;
+    cfg.bus_width = 8;
+    cfg.bus_type = lgfx::bus_parallel8;
+    cfg.command_ns = 50;
+    lgfx::Panel_ILI9341 panel;
+    ok &= run("ILI9341p", &panel, 240, 320, cfg, out_dir);
+  }
+  {
+    lgfx::Bus_Trace::config_t cfg;
+    cfg.freq_write = 400000;
+    cfg.bus_type = lgfx::bus_i2c;
+    cfg.transaction_ns = 50000;
+    lgfx::Panel_SSD1306 panel;
+    ok &= run("SSD1306", &panel, 128, 64, cfg, out_dir);
+  }
+  {
+    lgfx::Bus_Trace::config_t cfg;
+    cfg.freq_write = 24000000;
+    lgfx::Panel_IT8951 panel;
+    ok &= run("IT8951", &panel, 960, 540, cfg, out_dir);
+  }
+  return ok ? 0 : 1;
+}
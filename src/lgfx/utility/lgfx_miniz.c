@@ -841,7 +841,7 @@ void *tdefl_write_image_to_png_file_in_memory(const void *pImage, int w, int h,
 
 typedef lgfx_mz_uint8 *(*tdefl_get_png_row_func)(lgfx_mz_uint8 *pImage, lgfx_mz_bool flip, int w, int h, int y, int bpl, void *target);
 lgfx_mz_uint8 *tdefl_get_png_row_default( lgfx_mz_uint8 *pImage, lgfx_mz_bool flip, int w, int h, int y, int bpl, void *target );
-void *tdefl_write_image_to_png_file_in_memory_ex_with_cb(const void *pImage, int w, int h, int num_chans, size_t *pLen_out, lgfx_mz_uint level, lgfx_mz_bool flip, tdefl_get_png_row_func cb, void *target);
+void *tdefl_write_image_to_png_file_in_memory_ex_with_cb(void *pImage, int w, int h, int num_chans, size_t *pLen_out, lgfx_mz_uint level, lgfx_mz_bool flip, tdefl_get_png_row_func cb, void *target);
 
 // Output stream interface. The compressor uses this interface to write compressed data. It'll typically be called TDEFL_OUT_BUF_SIZE at a time.
 typedef lgfx_mz_bool (*tdefl_put_buf_func_ptr)(const void* pBuf, int len, void *pUser);
@@ -849,6 +849,11 @@ typedef lgfx_mz_bool (*tdefl_put_buf_func_ptr)(const void* pBuf, int len, void *
 // tdefl_compress_mem_to_output() compresses a block to an output stream. The above helpers use this function internally.
 lgfx_mz_bool tdefl_compress_mem_to_output(const void *pBuf, size_t buf_len, tdefl_put_buf_func_ptr pPut_buf_func, void *pPut_buf_user, int flags);
 
+// tdefl_write_image_to_png_stream() writes the same PNG file as above, but passes it to pPut_buf_func piece by piece.
+// Each block of compressed data is written as its own IDAT chunk, so only the compressor state and one scanline (pImage, w*num_chans bytes) are needed.
+// Returns MZ_FALSE if out of memory or pPut_buf_func returned MZ_FALSE.
+lgfx_mz_bool tdefl_write_image_to_png_stream(void *pImage, int w, int h, int num_chans, lgfx_mz_uint level, lgfx_mz_bool flip, tdefl_get_png_row_func cb, void *target, tdefl_put_buf_func_ptr pPut_buf_func, void *pPut_buf_user);
+
 enum { TDEFL_MAX_HUFF_TABLES = 3, TDEFL_MAX_HUFF_SYMBOLS_0 = 288, TDEFL_MAX_HUFF_SYMBOLS_1 = 32, TDEFL_MAX_HUFF_SYMBOLS_2 = 19, TDEFL_LZ_DICT_SIZE = 4096, TDEFL_LZ_DICT_SIZE_MASK = TDEFL_LZ_DICT_SIZE - 1, TDEFL_MIN_MATCH_LEN = 3, TDEFL_MAX_MATCH_LEN = 258 };
 
 // TDEFL_OUT_BUF_SIZE MUST be large enough to hold a single entire compressed output block (using static/fixed Huffman codes).
@@ -2823,10 +2828,10 @@ lgfx_mz_uint8 *tdefl_get_png_row_default( lgfx_mz_uint8 *pImage, lgfx_mz_bool fl
 // This is actually a modification of Alex's original code so PNG files generated by this function pass pngcheck.
 void *tdefl_write_image_to_png_file_in_memory_ex(const void *pImage, int w, int h, int num_chans, size_t *pLen_out, lgfx_mz_uint level, lgfx_mz_bool flip)
 {
-  return tdefl_write_image_to_png_file_in_memory_ex_with_cb(pImage, w, h, num_chans, pLen_out, level, flip, &tdefl_get_png_row_default, NULL);
+  return tdefl_write_image_to_png_file_in_memory_ex_with_cb((void*)pImage, w, h, num_chans, pLen_out, level, flip, &tdefl_get_png_row_default, NULL);
 }
 
-void *tdefl_write_image_to_png_file_in_memory_ex_with_cb(const void *pImage, int w, int h, int num_chans, size_t *pLen_out, lgfx_mz_uint level, lgfx_mz_bool flip, tdefl_get_png_row_func cb, void *target)
+void *tdefl_write_image_to_png_file_in_memory_ex_with_cb(void *pImage, int w, int h, int num_chans, size_t *pLen_out, lgfx_mz_uint level, lgfx_mz_bool flip, tdefl_get_png_row_func cb, void *target)
 {
   tdefl_get_png_row_func get_row_func = cb;
   // Using a local copy of this array here in case MINIZ_NO_ZLIB_APIS was defined.
@@ -2876,6 +2881,56 @@ void *tdefl_write_image_to_png_file_in_memory_ex_with_cb(const void *pImage, int
   // compute final size of file, grab compressed data buffer and return
   *pLen_out += 57; MZ_FREE(pComp); return out_buf.m_pBuf;
 }
+typedef struct
+{
+  tdefl_put_buf_func_ptr m_pPut_buf_func;
+  void *m_pPut_buf_user;
+} tdefl_png_stream;
+
+static lgfx_mz_bool tdefl_png_stream_chunk(const void *pBuf, int len, const char *type, tdefl_png_stream *p)
+{
+  lgfx_mz_uint8 hdr[8] = { (lgfx_mz_uint8)(len >> 24), (lgfx_mz_uint8)(len >> 16), (lgfx_mz_uint8)(len >> 8), (lgfx_mz_uint8)len, (lgfx_mz_uint8)type[0], (lgfx_mz_uint8)type[1], (lgfx_mz_uint8)type[2], (lgfx_mz_uint8)type[3] };
+  lgfx_mz_uint8 crc[4]; lgfx_mz_uint32 c; int i;
+  c = (lgfx_mz_uint32)lgfx_mz_crc32(MZ_CRC32_INIT, hdr + 4, 4);
+  if (len) c = (lgfx_mz_uint32)lgfx_mz_crc32(c, (const lgfx_mz_uint8*)pBuf, len);
+  for (i = 0; i < 4; ++i, c <<= 8) crc[i] = (lgfx_mz_uint8)(c >> 24);
+  return p->m_pPut_buf_func(hdr, 8, p->m_pPut_buf_user)
+      && (!len || p->m_pPut_buf_func(pBuf, len, p->m_pPut_buf_user))
+      && p->m_pPut_buf_func(crc, 4, p->m_pPut_buf_user);
+}
+
+static lgfx_mz_bool tdefl_png_stream_idat(const void *pBuf, int len, void *pUser)
+{
+  return tdefl_png_stream_chunk(pBuf, len, "IDAT", (tdefl_png_stream*)pUser);
+}
+
+lgfx_mz_bool tdefl_write_image_to_png_stream(void *pImage, int w, int h, int num_chans, lgfx_mz_uint level, lgfx_mz_bool flip, tdefl_get_png_row_func cb, void *target, tdefl_put_buf_func_ptr pPut_buf_func, void *pPut_buf_user)
+{
+  static const lgfx_mz_uint s_tdefl_png_num_probes[11] = { 0, 1, 6, 32,  16, 32, 128, 256,  512, 768, 1500 };
+  static const lgfx_mz_uint8 chans[] = {0x00, 0x00, 0x04, 0x02, 0x06};
+  static const lgfx_mz_uint8 signature[8] = {0x89,0x50,0x4e,0x47,0x0d,0x0a,0x1a,0x0a};
+  tdefl_png_stream stream = { pPut_buf_func, pPut_buf_user };
+  lgfx_mz_uint8 ihdr[13] = { 0,0,(lgfx_mz_uint8)(w>>8),(lgfx_mz_uint8)w,0,0,(lgfx_mz_uint8)(h>>8),(lgfx_mz_uint8)h,8,chans[num_chans],0,0,0 };
+  tdefl_compressor *pComp; int bpl = w * num_chans, y; lgfx_mz_uint8 filter = 0; lgfx_mz_bool res;
+
+  if (!pPut_buf_func(signature, 8, pPut_buf_user) || !tdefl_png_stream_chunk(ihdr, 13, "IHDR", &stream)) return MZ_FALSE;
+
+  pComp = (tdefl_compressor *)MZ_MALLOC(sizeof(tdefl_compressor));
+  if (!pComp) return MZ_FALSE;
+  // compress image data. the compressor calls tdefl_png_stream_idat each time its output buffer is flushed.
+  tdefl_init(pComp, tdefl_png_stream_idat, &stream, s_tdefl_png_num_probes[MZ_MIN(10, level)] | TDEFL_WRITE_ZLIB_HEADER);
+  res = MZ_TRUE;
+  for (y = 0; res && y < h; ++y)
+  {
+    res = tdefl_compress_buffer(pComp, &filter, 1, TDEFL_NO_FLUSH) == TDEFL_STATUS_OKAY
+       && tdefl_compress_buffer(pComp, cb( (lgfx_mz_uint8*)pImage, flip, w, h, y, bpl, target ), bpl, TDEFL_NO_FLUSH) == TDEFL_STATUS_OKAY;
+  }
+  res = res && tdefl_compress_buffer(pComp, NULL, 0, TDEFL_FINISH) == TDEFL_STATUS_DONE;
+  MZ_FREE(pComp);
+
+  return res && tdefl_png_stream_chunk(NULL, 0, "IEND", &stream);
+}
+
 void *tdefl_write_image_to_png_file_in_memory(const void *pImage, int w, int h, int num_chans, size_t *pLen_out)
 {
   // Level 6 corresponds to TDEFL_DEFAULT_MAX_PROBES or MZ_DEFAULT_LEVEL (but we can't depend on MZ_DEFAULT_LEVEL being available in case the zlib API's where #defined out)
@@ -100,6 +100,10 @@ struct _pngle_t {
   uint8_t filter_type;
   // interlace
   uint8_t interlace_pass;
+  uint8_t pass_finished; // the draw callback does not need the rest of this pass
+
+  // indexed color : the draw callback receives the palette indices instead of argb (see lgfx_pngle_decomp_index)
+  uint8_t index_output;
 
   // 0 indicates IHDR hasn't been processed yet
   uint8_t channels;
@@ -284,6 +288,29 @@ static void make_pixels(pngle_t *pngle, const uint8_t* buf, uint32_t* rgbbuf, si
   }
 }
 
+static void make_indices(pngle_t *pngle, const uint8_t* buf, uint8_t* idxbuf, size_t len)
+{
+  size_t depth = pngle->hdr.depth;
+  if (depth == 8)
+  {
+    memcpy(idxbuf, buf, len);
+    return;
+  }
+  size_t mask = ((1 << depth) - 1);
+  size_t shift = 8;
+  size_t b = buf[0];
+  uint8_t* last = &idxbuf[len];
+  do
+  {
+    shift -= depth;
+    *idxbuf = (b >> shift) & mask;
+    if (shift == 0) {
+      shift = 8;
+      b = *++buf;
+    }
+  } while (++idxbuf != last);
+}
+
 static inline int paeth(int a, int b, int c)
 {
   int pa = b - c;
@@ -302,6 +329,7 @@ static void set_interlace_pass(pngle_t *pngle, uint_fast8_t pass)
     ++pass;
   }
   pngle->interlace_pass = pass;
+  pngle->pass_finished = 0;
   pngle->drawing_y = pgm_read_byte(&interlace_off_y[pass]);
   size_t div_x = pgm_read_byte(&interlace_div_x[pass]);
   size_t scanline_pixels = (pngle->hdr.width - pgm_read_byte(&interlace_off_x[pass]) + div_x - 1) / div_x;
@@ -316,7 +344,8 @@ static int pngle_on_data(pngle_t *pngle, uint8_t *lzbuf, size_t len, size_t outb
   uint_fast8_t bytes_per_pixel = (pngle->channels * pngle->hdr.depth + 7) >> 3; // 1 if depth <= 8
   size_t filter_type = pngle->filter_type;
   size_t remain_bytes = pngle->scanline_remain_bytes_to_render;
-
+  // indices are 1 byte per pixel, so 4 times as many fit in the buffer.
+  if (pngle->index_output) { outbuf_len = (outbuf_len << 2) & ~7; }
 
   const uint8_t* p = lzbuf;
   uint8_t* scanline = &(pngle->scanline_buf[bytes_per_pixel]);
@@ -365,15 +394,22 @@ static int pngle_on_data(pngle_t *pngle, uint8_t *lzbuf, size_t len, size_t outb
     size_t out_pos = 0;
     size_t out_len = ((((scanline_pixels + 7) & ~7) - 1) % outbuf_len) + 1;
 
-    do
+    while (!pngle->pass_finished && out_pos < scanline_pixels)
     {
       if (out_len > scanline_pixels - out_pos) { out_len = scanline_pixels - out_pos; }
-      make_pixels(pngle, &scanline[(out_pos * pngle->channels * pngle->hdr.depth) >> 3], pngle->out_buf, out_len);
-      pngle->draw_callback(pngle->user_data, draw_x + out_pos * div_x, pngle->drawing_y, div_x, out_len, (const uint8_t*)pngle->out_buf);
+      const uint8_t* src = &scanline[(out_pos * pngle->channels * pngle->hdr.depth) >> 3];
+      if (pngle->index_output) { make_indices(pngle, src, (uint8_t*)pngle->out_buf, out_len); }
+      else                     { make_pixels( pngle, src,            pngle->out_buf, out_len); }
+      if (!pngle->draw_callback(pngle->user_data, draw_x + out_pos * div_x, pngle->drawing_y, div_x, out_len, (const uint8_t*)pngle->out_buf))
+      {
+        // the rows below are not needed. the last pass (or a non-interlaced image) ends here.
+        if (pngle->interlace_pass >= 6) { return 1; }
+        pngle->pass_finished = 1;
+      }
 
       out_pos += out_len;
       out_len = outbuf_len;
-    } while (out_pos < scanline_pixels);
+    }
 
     pngle->drawing_y += pgm_read_byte(&interlace_div_y[pngle->interlace_pass]);
     if (pngle->drawing_y >= pngle->hdr.height) {
@@ -401,6 +437,7 @@ int lgfx_pngle_prepare(pngle_t *pngle, lgfx_pngle_read_callback_t read_cb, void*
   pngle->read_callback = read_cb;
   pngle->user_data = user_data;
   pngle->n_palettes = 0;
+  pngle->index_output = 0;
   pngle->next_out = pngle->lz_buf;
   pngle->avail_out = TINFL_LZ_DICT_SIZE;
   pngle->filter_type = ~0;
@@ -537,7 +574,8 @@ int lgfx_pngle_decomp(pngle_t *pngle, lgfx_pngle_draw_callback_t draw_cb)
 
           if (out_bytes)
           {
-            if (pngle_on_data(pngle, pngle->next_out, out_bytes, (LGFX_PNGLE_OUTBUF_LEN >> 2) + (len ? in_pos >> 2 : (LGFX_PNGLE_READBUF_LEN >> 2))) < 0) return -1;
+            int res = pngle_on_data(pngle, pngle->next_out, out_bytes, (LGFX_PNGLE_OUTBUF_LEN >> 2) + (len ? in_pos >> 2 : (LGFX_PNGLE_READBUF_LEN >> 2)));
+            if (res) { return res < 0 ? -1 : 0; } // error, or the rest of the image is not needed.
           }
           pngle->next_out += out_bytes;
           pngle->avail_out -= out_bytes;
@@ -613,3 +651,18 @@ int lgfx_pngle_decomp(pngle_t *pngle, lgfx_pngle_draw_callback_t draw_cb)
   }
   return 0;
 }
+
+int lgfx_pngle_decomp_index(pngle_t *pngle, lgfx_pngle_draw_callback_t draw_cb)
+{
+  if (pngle == NULL || pngle->channels == 0 || pngle->hdr.color_type != 3) { return PNGLE_STATE_ERROR; }
+  pngle->index_output = 1;
+  int res = lgfx_pngle_decomp(pngle, draw_cb);
+  pngle->index_output = 0;
+  return res;
+}
+
+const uint8_t* lgfx_pngle_get_palette(pngle_t *pngle, uint32_t* count)
+{
+  if (count) { *count = pngle ? pngle->n_palettes : 0; }
+  return pngle ? pngle->palette : NULL;
+}
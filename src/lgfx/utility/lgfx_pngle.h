@@ -43,7 +43,8 @@ typedef struct _pngle_t pngle_t;
 
 // Callback signatures
 typedef uint32_t (*lgfx_pngle_read_callback_t)(void *user_data, uint8_t *buf, uint32_t len);
-typedef void (*lgfx_pngle_draw_callback_t)(void *user_data, uint32_t x, uint32_t y, uint_fast8_t div_x, size_t len, const uint8_t* argb);
+// return 0 when the rest of the image is not needed (the rows below are out of the visible area), and the decoding ends.
+typedef uint32_t (*lgfx_pngle_draw_callback_t)(void *user_data, uint32_t x, uint32_t y, uint_fast8_t div_x, size_t len, const uint8_t* argb);
 
 // ----------------
 // Basic interfaces
@@ -53,6 +54,12 @@ pngle_t *lgfx_pngle_new();
 int lgfx_pngle_prepare(pngle_t *pngle, lgfx_pngle_read_callback_t read_cb, void* user_data);
 int lgfx_pngle_decomp(pngle_t *pngle, lgfx_pngle_draw_callback_t draw_cb);
 
+// indexed color (color type 3) only. the draw callback receives the palette indices (1 byte per pixel) instead of argb.
+int lgfx_pngle_decomp_index(pngle_t *pngle, lgfx_pngle_draw_callback_t draw_cb);
+
+// palette entries (4 bytes each : alpha, red, green, blue). available after the PLTE chunk (from the first draw callback).
+const uint8_t* lgfx_pngle_get_palette(pngle_t *pngle, uint32_t* count);
+
 void lgfx_pngle_destroy(pngle_t *pngle);
 
 uint32_t lgfx_pngle_get_width(pngle_t *pngle);
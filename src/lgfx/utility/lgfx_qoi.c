@@ -207,8 +207,8 @@ int lgfx_qoi_decomp(qoi_t *qoi, lgfx_qoi_draw_callback_t draw_cb)
     if (x < qoi->desc.width) { continue; }
     x = 0;
 
-    draw_cb(qoi->user_data, 0, y, 1, qoi->desc.width, (const uint8_t*)qoi->pixelBuffer);
-    if (++y >= qoi->desc.height)
+    if (!draw_cb(qoi->user_data, 0, y, 1, qoi->desc.width, (const uint8_t*)qoi->pixelBuffer)
+     || ++y >= qoi->desc.height)
     {
       return 0;
     }
@@ -241,31 +241,34 @@ void lgfx_qoi_destroy(qoi_t *qoi)
 
 // Qoi Encoder
 
+// the state of one encoding, so that several images can be encoded at the same time.
+typedef struct {
+  uint8_t* buf;
+  size_t size;
+  uint32_t pos;
+  lfgx_qoi_writer_func writer;
+  void* user;
+} qoi_enc_buffer_t;
 
-static uint8_t* writeBuffer;
-static size_t writeBufferSize;
-static uint32_t writeBufferPos;
-lfgx_qoi_writer_func bytes_writer;
 
-
-static int8_t enc_write_uint8( uint8_t v )
+static int8_t enc_write_uint8( qoi_enc_buffer_t* wb, uint8_t v )
 {
-  writeBuffer[writeBufferPos++] = v;
-  if( writeBufferPos == writeBufferSize )  { // buffer full, write!
+  wb->buf[wb->pos++] = v;
+  if( wb->pos == wb->size )  { // buffer full, write!
     // TODO: handle write errors
-    if( bytes_writer ) bytes_writer( writeBuffer, writeBufferSize );
-    writeBufferPos = 0;
+    if( wb->writer ) wb->writer( wb->user, wb->buf, wb->size );
+    wb->pos = 0;
   }
   return 1;
 }
 
 
-static int8_t enc_write_uint32( uint32_t v )
+static int8_t enc_write_uint32( qoi_enc_buffer_t* wb, uint32_t v )
 {
-  enc_write_uint8( (uint8_t)(v >> 24) );
-  enc_write_uint8( (uint8_t)(v >> 16) );
-  enc_write_uint8( (uint8_t)(v >>  8) );
-  enc_write_uint8( (uint8_t)v );
+  enc_write_uint8( wb, (uint8_t)(v >> 24) );
+  enc_write_uint8( wb, (uint8_t)(v >> 16) );
+  enc_write_uint8( wb, (uint8_t)(v >>  8) );
+  enc_write_uint8( wb, (uint8_t)v );
   return 4;
 }
 
@@ -283,34 +286,44 @@ uint32_t lgfx_qoi_get_height(qoi_t *qoi)
 
 
 
-size_t lgfx_qoi_encoder_write_cb(const void *lineBuffer, uint32_t bufferLen, int w, int h, int num_chans, int flip, lgfx_qoi_encoder_get_row_func get_row, lfgx_qoi_writer_func write_bytes, void *qoienc)
+static size_t qoi_encode_impl(void *lineBuffer, const qoi_desc_t *desc, int flip, lgfx_qoi_encoder_get_row_func get_row, qoi_enc_buffer_t *wb, void *qoienc);
+
+
+size_t lgfx_qoi_encoder_write_cb(void *lineBuffer, uint32_t bufferLen, int w, int h, int num_chans, int flip, lgfx_qoi_encoder_get_row_func get_row, lfgx_qoi_writer_func write_bytes, void *qoienc)
 {
   qoi_desc_t desc;
   desc.width      = w;
   desc.height     = h;
   desc.channels   = num_chans;
   desc.colorspace = QOI_SRGB; // QOI_SRGB=0, QOI_LINEAR=1
-  writeBufferSize = bufferLen;
-  size_t res = lgfx_qoi_encode(lineBuffer, &desc, flip, get_row, write_bytes, qoienc);
+  qoi_enc_buffer_t wb = { NULL, bufferLen, 0, write_bytes, qoienc };
+  size_t res = qoi_encode_impl(lineBuffer, &desc, flip, get_row, &wb, qoienc);
   return res;
 }
 
 
-void *lgfx_qoi_encoder_write_fb(const void *lineBuffer, int w, int h, int num_chans, size_t *out_len, int flip, lgfx_qoi_encoder_get_row_func get_row, void *qoienc)
+void *lgfx_qoi_encoder_write_fb(void *lineBuffer, int w, int h, int num_chans, size_t *out_len, int flip, lgfx_qoi_encoder_get_row_func get_row, void *qoienc)
 {
   qoi_desc_t desc;
   desc.width      = w;
   desc.height     = h;
   desc.channels   = num_chans;
   desc.colorspace = QOI_SRGB; // QOI_SRGB=0, QOI_LINEAR=1
-  writeBufferSize = desc.width * desc.height * (desc.channels + 1) + QOI_HEADER_SIZE + sizeof(qoi_padding);
-  size_t res = lgfx_qoi_encode(lineBuffer, &desc, flip, get_row, NULL, qoienc);
+  qoi_enc_buffer_t wb = { NULL, desc.width * desc.height * (desc.channels + 1) + QOI_HEADER_SIZE + sizeof(qoi_padding), 0, NULL, NULL };
+  size_t res = qoi_encode_impl(lineBuffer, &desc, flip, get_row, &wb, qoienc);
   *out_len = res;
-  return (void*)writeBuffer;
+  return (void*)wb.buf;
+}
+
+
+size_t lgfx_qoi_encode(void *lineBuffer, const qoi_desc_t *desc, int flip, lgfx_qoi_encoder_get_row_func get_row, lfgx_qoi_writer_func write_bytes, void *qoienc)
+{
+  qoi_enc_buffer_t wb = { NULL, 1024, 0, write_bytes, qoienc };
+  return qoi_encode_impl(lineBuffer, desc, flip, get_row, &wb, qoienc);
 }
 
 
-size_t lgfx_qoi_encode(const void *lineBuffer, const qoi_desc_t *desc, int flip, lgfx_qoi_encoder_get_row_func get_row, lfgx_qoi_writer_func write_bytes, void *qoienc)
+static size_t qoi_encode_impl(void *lineBuffer, const qoi_desc_t *desc, int flip, lgfx_qoi_encoder_get_row_func get_row, qoi_enc_buffer_t *wb, void *qoienc)
 {
   int i, p, repeat;
   int px_len, px_end, px_pos, channels;
@@ -328,22 +341,20 @@ size_t lgfx_qoi_encode(const void *lineBuffer, const qoi_desc_t *desc, int flip,
   if (desc->height >= QOI_PIXELS_MAX / desc->width ) { debug_printf( "Too big");        return 0; }
 
   p = 0;
-  writeBufferPos = 0;
-  writeBuffer = (uint8_t*)malloc(writeBufferSize);
-  if (!writeBuffer)
+  wb->pos = 0;
+  wb->buf = (uint8_t*)malloc(wb->size);
+  if (!wb->buf)
   {
-    debug_printf( "Can't malloc %d bytes", (int)writeBufferSize);
+    debug_printf( "Can't malloc %d bytes", (int)wb->size);
     return 0;
   }
 
-  bytes_writer = write_bytes;
-
-  p += enc_write_uint32( qoi_sig);
-  p += enc_write_uint32( desc->width);
-  p += enc_write_uint32( desc->height);
+  p += enc_write_uint32( wb, qoi_sig);
+  p += enc_write_uint32( wb, desc->width);
+  p += enc_write_uint32( wb, desc->height);
 
-  p += enc_write_uint8( desc->channels );
-  p += enc_write_uint8( desc->colorspace );
+  p += enc_write_uint8( wb, desc->channels );
+  p += enc_write_uint8( wb, desc->colorspace );
 
   uint32_t lineBufferLen = desc->width * desc->channels;
 
@@ -380,7 +391,7 @@ size_t lgfx_qoi_encode(const void *lineBuffer, const qoi_desc_t *desc, int flip,
       repeat++;
       if (repeat == 62 || px_pos == px_end)
       {
-        p += enc_write_uint8( (uint8_t)(QOI_OP_RUN | (repeat - 1)) );
+        p += enc_write_uint8( wb, (uint8_t)(QOI_OP_RUN | (repeat - 1)) );
         repeat = 0;
       }
     }
@@ -390,7 +401,7 @@ size_t lgfx_qoi_encode(const void *lineBuffer, const qoi_desc_t *desc, int flip,
 
       if (repeat > 0)
       {
-        p += enc_write_uint8( (uint8_t)(QOI_OP_RUN | (repeat - 1)));
+        p += enc_write_uint8( wb, (uint8_t)(QOI_OP_RUN | (repeat - 1)));
         repeat = 0;
       }
 
@@ -398,7 +409,7 @@ size_t lgfx_qoi_encode(const void *lineBuffer, const qoi_desc_t *desc, int flip,
 
       if (qoi_index[index_pos].v == px.v)
       {
-        p += enc_write_uint8( (uint8_t)(QOI_OP_INDEX | index_pos) );
+        p += enc_write_uint8( wb, (uint8_t)(QOI_OP_INDEX | index_pos) );
       }
       else
       {
@@ -415,28 +426,28 @@ size_t lgfx_qoi_encode(const void *lineBuffer, const qoi_desc_t *desc, int flip,
 
           if ( vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2 )
           {
-            p += enc_write_uint8( (uint8_t)(QOI_OP_DIFF + ((vr + 2) << 4) + ((vg + 2) << 2) + (vb + 2)) );
+            p += enc_write_uint8( wb, (uint8_t)(QOI_OP_DIFF + ((vr + 2) << 4) + ((vg + 2) << 2) + (vb + 2)) );
           }
           else if ( vg_r >  -9 && vg_r <  8 && vg   > -33 && vg   < 32 && vg_b >  -9 && vg_b <  8 )
           {
-            p += enc_write_uint8( (uint8_t)(QOI_OP_LUMA     | (vg   + 32)) );
-            p += enc_write_uint8( (uint8_t)((vg_r + 8) << 4 | (vg_b +  8)) );
+            p += enc_write_uint8( wb, (uint8_t)(QOI_OP_LUMA     | (vg   + 32)) );
+            p += enc_write_uint8( wb, (uint8_t)((vg_r + 8) << 4 | (vg_b +  8)) );
           }
           else
           {
-            p += enc_write_uint8( QOI_OP_RGB );
-            p += enc_write_uint8( px.rgba.r  );
-            p += enc_write_uint8( px.rgba.g  );
-            p += enc_write_uint8( px.rgba.b  );
+            p += enc_write_uint8( wb, QOI_OP_RGB );
+            p += enc_write_uint8( wb, px.rgba.r  );
+            p += enc_write_uint8( wb, px.rgba.g  );
+            p += enc_write_uint8( wb, px.rgba.b  );
           }
         }
         else
         {
-          p += enc_write_uint8( QOI_OP_RGBA );
-          p += enc_write_uint8( px.rgba.r   );
-          p += enc_write_uint8( px.rgba.g   );
-          p += enc_write_uint8( px.rgba.b   );
-          p += enc_write_uint8( px.rgba.a   );
+          p += enc_write_uint8( wb, QOI_OP_RGBA );
+          p += enc_write_uint8( wb, px.rgba.r   );
+          p += enc_write_uint8( wb, px.rgba.g   );
+          p += enc_write_uint8( wb, px.rgba.b   );
+          p += enc_write_uint8( wb, px.rgba.a   );
         }
       }
     }
@@ -445,13 +456,14 @@ size_t lgfx_qoi_encode(const void *lineBuffer, const qoi_desc_t *desc, int flip,
 
   for (i = 0; i < (int)sizeof(qoi_padding); i++)
   {
-    p += enc_write_uint8( qoi_padding[i] );
+    p += enc_write_uint8( wb, qoi_padding[i] );
   }
 
-  if( write_bytes )
+  if( wb->writer )
   {
-    if( writeBufferPos>0 ) write_bytes( writeBuffer, writeBufferPos );
-    free( writeBuffer );
+    if( wb->pos>0 ) wb->writer( wb->user, wb->buf, wb->pos );
+    free( wb->buf );
+    wb->buf = NULL;
   }
 
   free( qoi_index );
@@ -468,7 +468,8 @@ static void block_idct (
 /*-----------------------------------------------------------------------*/
 
 static JRESULT mcu_load (
-	lgfxJdec* jd		/* Pointer to the decompressor object */
+	lgfxJdec* jd,		/* Pointer to the decompressor object */
+	uint_fast8_t output	/* 0:Only extract the huffman coded data (the MCU is not visible) */
 )
 {
 	int32_t *tmp = (int32_t*)jd->workbuf;	/* Block working buffer for de-quantize and IDCT */
@@ -486,6 +487,7 @@ static JRESULT mcu_load (
 	for (blk = 0; blk < nby + nbc; ++blk) {
 		size_t cmp = (blk < nby) ? 0 : blk - nby + 1;	/* Component number 0:Y, 1:Cb, 2:Cr */
 		size_t id = cmp ? 1 : 0;				/* Huffman table ID of the component */
+		uint_fast8_t out = output && (!cmp || jd->format != JD_FORMAT_GRAY8);	/* Luma only output does not need Cb/Cr */
 
 		/* Extract a DC element from input stream */
 		hb = jd->huffbits[id][0];				/* Huffman table for the DC element */
@@ -503,10 +505,12 @@ static JRESULT mcu_load (
 			jd->dcv[cmp] = d;					/* Save current DC value for next block */
 		}
 		const int32_t *dqf = jd->qttbl[jd->qtid[cmp]];			/* De-quantizer table ID for this component */
-		tmp[0] = d * dqf[0] >> 8;				/* De-quantize, apply scale factor of Arai algorithm and descale 8 bits */
+		if (out) {
+			tmp[0] = d * dqf[0] >> 8;			/* De-quantize, apply scale factor of Arai algorithm and descale 8 bits */
+			memset(&tmp[1], 0, 63*sizeof(int32_t));	/* Clear rest of elements */
+		}
 
 		/* Extract following 63 AC elements from input stream */
-		memset(&tmp[1], 0, 63*sizeof(int32_t));	/* Clear rest of elements */
 		hb = jd->huffbits[id][1];				/* Huffman table for the AC elements */
 		hc = jd->huffcode[id][1];
 		hd = jd->huffdata[id][1];
@@ -519,13 +523,17 @@ static JRESULT mcu_load (
 			if (b &= 0x0F) {					/* Bit length */
 				d = bitext(jd, b);				/* Extract data bits */
 				if (d < 0) return (JRESULT)(-d);/* Err: input device */
-				b = 1 << (b - 1);				/* MSB position */
-				if (!(d & b)) d -= (b << 1) - 1;/* Restore negative value if needed */
-				uint_fast8_t z = Zig[i];		/* Zigzag-order to raster-order converted index */
-				tmp[z] = d * dqf[z] >> 8;		/* De-quantize, apply scale factor of Arai algorithm and descale 8 bits */
+				if (out) {
+					b = 1 << (b - 1);				/* MSB position */
+					if (!(d & b)) d -= (b << 1) - 1;/* Restore negative value if needed */
+					uint_fast8_t z = Zig[i];		/* Zigzag-order to raster-order converted index */
+					tmp[z] = d * dqf[z] >> 8;		/* De-quantize, apply scale factor of Arai algorithm and descale 8 bits */
+				}
 			}
 		} while (++i < 64);		/* Next AC element */
 
+		if (!out) continue;	/* The DC value is kept for the following blocks, and the rest is not needed */
+
 		if (i == 1 || (JD_USE_SCALE && jd->scale == 3)) {
 			d = (int16_t)((*tmp >> 8) + 128);	/* If scale ratio is 1/8, IDCT can be ommited and only DC element is used */
 			for (i = 0; i < 64; bp[i++] = d) ;
@@ -542,6 +550,55 @@ static JRESULT mcu_load (
 
 
 
+/*-----------------------------------------------------------------------*/
+/* Pack RGB888 pixels into the output format (in place, forward)         */
+/*-----------------------------------------------------------------------*/
+
+static void pack_rgb (
+	uint8_t* buf,		/* RGB888 pixels, overwritten with the packed pixels */
+	uint_fast8_t format,	/* Output pixel format (JD_FORMAT_xxx) */
+	uint_fast16_t n		/* Number of pixels */
+)
+{
+	const uint8_t *s = buf;
+	uint8_t *d = buf;
+	uint_fast16_t w;
+
+	switch (format) {
+	case JD_FORMAT_RGB565:
+		do {
+			w = (s[0] & 0xF8) << 8;		/* RRRRR----------- */
+			w |= (s[1] & 0xFC) << 3;	/* -----GGGGGG----- */
+			w |= s[2] >> 3;				/* -----------BBBBB */
+			*(uint16_t*)d = w;
+			s += 3; d += 2;
+		} while (--n);
+		break;
+
+	case JD_FORMAT_RGB565_BE:
+		do {
+			w = (s[0] & 0xF8) << 8 | (s[1] & 0xFC) << 3 | s[2] >> 3;
+			d[0] = w >> 8;
+			d[1] = w;
+			s += 3; d += 2;
+		} while (--n);
+		break;
+
+	case JD_FORMAT_RGB332:
+		do {
+			*d++ = (s[0] & 0xE0) | ((s[1] >> 3) & 0x1C) | (s[2] >> 6);
+			s += 3;
+		} while (--n);
+		break;
+
+	default:
+		break;
+	}
+}
+
+
+
+
 /*-----------------------------------------------------------------------*/
 /* Output an MCU: Convert YCrCb to RGB and output it in RGB form         */
 /*-----------------------------------------------------------------------*/
@@ -573,12 +630,57 @@ static JRESULT mcu_output (
 	rect.top = y; rect.bottom = y + ry - 1;
 
 	uint8_t* workbuf = (uint8_t*)jd->workbuf;
+	uint_fast8_t fmt = JD_FORMAT_RGB888;	/* Pixel format held in workbuf */
+
+	if (jd->format == JD_FORMAT_GRAY8) {	/* Luma only (the Y blocks are filled with the DC value on 1/8 scaling) */
+		fmt = JD_FORMAT_GRAY8;
+		uint8_t *op = workbuf;
+		iy = 0;
+		do {
+			py = &jd->mcubuf[((iy >> 3) * jd->msx << 6) + ((iy & 7) << 3)];
+			ix = 0;
+			do {
+				for (uint_fast8_t i = 0; i < 8; ++i) {
+					*op++ = BYTECLIP(py[i]);
+				}
+				py += 64;	/* Next block on the right */
+			} while ((ix += 8) < mx);
+		} while (++iy < my);
 
+		/* Descale the MCU rectangular if needed */
+		if (JD_USE_SCALE && jd->scale) {
+			uint32_t x_, y_, s_, w_, sum;
+			s_ = jd->scale * 2;
+			w_ = 1 << jd->scale;
+			op = workbuf;
+			iy = 0;
+			do {
+				ix = 0;
+				do {
+					uint8_t *ip = &workbuf[iy * mx + ix];
+					sum = 0;
+					y_ = 0;
+					do {
+						x_ = 0;
+						do {
+							sum += ip[x_];
+						} while (++x_ < w_);
+						ip += mx;
+					} while (++y_ < w_);
+					*op++ = sum >> s_;
+				} while ((ix += w_) < mx);
+			} while ((iy += w_) < my);
+		}
+
+	} else
 	if (!JD_USE_SCALE || jd->scale != 3) {	/* Not for 1/8 scaling */
 
 		uint_fast8_t ixshift = (mx == 16);
 		uint_fast8_t iyshift = (my == 16);
 
+		/* Without descaling, pack the pixels into the output format directly */
+		if (!JD_USE_SCALE || !jd->scale) fmt = jd->format;
+
 		/* Build an RGB MCU from discrete comopnents */
 		rgb24 = workbuf;
 		iy = 0;
@@ -608,10 +710,29 @@ static JRESULT mcu_output (
 #endif
 						++py;
 					/* Convert YCbCr to RGB */
-						rgb24[0] = BYTECLIP(yy + rr);
-						rgb24[1] = BYTECLIP(yy - gg);
-						rgb24[2] = BYTECLIP(yy + bb);
-						rgb24 += 3;
+						uint_fast8_t r8 = BYTECLIP(yy + rr);
+						uint_fast8_t g8 = BYTECLIP(yy - gg);
+						uint_fast8_t b8 = BYTECLIP(yy + bb);
+						switch (fmt) {
+						default:
+							rgb24[0] = r8;
+							rgb24[1] = g8;
+							rgb24[2] = b8;
+							rgb24 += 3;
+							break;
+						case JD_FORMAT_RGB565:
+							*(uint16_t*)rgb24 = (r8 & 0xF8) << 8 | (g8 & 0xFC) << 3 | b8 >> 3;
+							rgb24 += 2;
+							break;
+						case JD_FORMAT_RGB565_BE:
+							rgb24[0] = (r8 & 0xF8) | g8 >> 5;
+							rgb24[1] = (g8 & 0x1C) << 3 | b8 >> 3;
+							rgb24 += 2;
+							break;
+						case JD_FORMAT_RGB332:
+							*rgb24++ = (r8 & 0xE0) | ((g8 >> 3) & 0x1C) | (b8 >> 6);
+							break;
+						}
 					} while (++ix & ixshift);
 				} while (ix & 7);
 				py += 64 - 8;	/* Jump to next block if double block heigt */
@@ -681,26 +802,17 @@ static JRESULT mcu_output (
 	/* Squeeze up pixel table if a part of MCU is to be truncated */
 	mx >>= jd->scale;
 	if (rx < mx) {
+		uint_fast8_t bpp = (fmt == JD_FORMAT_RGB888) ? 3 : (fmt == JD_FORMAT_RGB332 || fmt == JD_FORMAT_GRAY8) ? 1 : 2;
 		uint8_t *s_, *d;
 		s_ = d = workbuf;
 		for (size_t y_ = 1; y_ < ry; ++y_) {
-			memcpy(d += rx * 3, s_ += mx * 3, rx * 3);	/* Copy effective pixels */
+			memmove(d += rx * bpp, s_ += mx * bpp, rx * bpp);	/* Copy effective pixels */
 		}
 	}
 
-	/* Convert RGB888 to RGB565 if needed */
-	if (JD_FORMAT == 1) {
-		uint8_t *s = workbuf;
-		uint16_t *d = (uint16_t*)s;
-		uint_fast16_t w;
-		uint_fast16_t n = rx * ry;
-
-		do {
-			w = (*s++ & 0xF8) << 8;		/* RRRRR----------- */
-			w |= (*s++ & 0xFC) << 3;	/* -----GGGGGG----- */
-			w |= *s++ >> 3;				/* -----------BBBBB */
-			*d++ = w;
-		} while (--n);
+	/* Convert RGB888 to the output format if needed */
+	if (fmt != jd->format) {
+		pack_rgb(workbuf, jd->format, rx * ry);
 	}
 
 	/* Output the RGB rectangular */
@@ -780,6 +892,7 @@ JRESULT lgfx_jd_prepare (
 	jd->infunc = infunc;	/* Stream input function */
 	jd->device = dev;		/* I/O device identifier */
 	jd->nrst = 0;			/* No restart interval (default) */
+	jd->format = JD_FORMAT;	/* Output pixel format (default) */
 
 //	memset(jd->huffbits, 0, sizeof(uint8_t*) * 4);	/* Nulls pointers */
 //	memset(jd->huffcode, 0, sizeof(uint16_t*) * 4);
@@ -812,6 +925,9 @@ JRESULT lgfx_jd_prepare (
 
 			jd->width = LDB_WORD(seg+3);		/* Image width in unit of pixel */
 			jd->height = LDB_WORD(seg+1);		/* Image height in unit of pixel */
+			jd->vis_left = jd->vis_top = 0;		/* Output the whole image by default */
+			jd->vis_right = jd->width - 1;
+			jd->vis_bottom = jd->height - 1;
 			jd->comps_in_frame = seg[5];
 			if (seg[5] != 1 && seg[5] != 3)
 				return JDR_FMT3;	/* Err: Supports only Y/Cb/Cr or Y(Grayscale) format */
@@ -967,7 +1083,8 @@ JRESULT lgfx_jd_decomp (
 
 	rc = JDR_OK;
 
-	for (y = 0; y < jd->height; y += my) {		/* Vertical loop of MCUs */
+	for (y = 0; y < jd->height && y <= jd->vis_bottom; y += my) {	/* Vertical loop of MCUs (ends after the visible area) */
+		uint_fast8_t vis_y = (y + my > jd->vis_top);
 		x = 0;
 		do {	/* Horizontal loop of MCUs */
 			if (nrst && rst++ == nrst) {	/* Process restart interval if enabled */
@@ -975,8 +1092,11 @@ JRESULT lgfx_jd_decomp (
 				if (rc != JDR_OK) return rc;
 				rst = 1;
 			}
-			rc = mcu_load(jd);					/* Load an MCU (decompress huffman coded stream and apply IDCT) */
+			/* The MCUs outside of the visible area are only extracted from the stream, to keep the DC values */
+			uint_fast8_t vis = vis_y && x <= jd->vis_right && x + mx > jd->vis_left;
+			rc = mcu_load(jd, vis);				/* Load an MCU (decompress huffman coded stream and apply IDCT) */
 			if (rc != JDR_OK) return rc;
+			if (!vis) continue;
 			rc = mcu_output(jd, outfunc, x, y);	/* Output the MCU (color space conversion, scaling and output) */
 			if (rc != JDR_OK) return rc;
 		} while ( (x += mx) < jd->width);
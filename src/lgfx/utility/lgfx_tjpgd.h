@@ -7,6 +7,8 @@
 / add support grayscale jpeg
 / add bayer pattern
 / tweak for 32bit processor
+/ skip the MCUs outside of the visible area
+/ add luma only output
 /----------------------------------------------------------------------------*/
 #ifndef __LGFX_TJPGDEC_H__
 #define __LGFX_TJPGDEC_H__
@@ -14,11 +16,18 @@
 /* System Configurations */
 
 #define	JD_SZBUF		512	/* Size of stream input buffer */
-#define JD_FORMAT		0	/* Output pixel format 0:RGB888 (3 BYTE/pix), 1:RGB565 (1 WORD/pix) */
+#define JD_FORMAT		0	/* Default output pixel format (JD_FORMAT_xxx), can be changed with lgfxJdec::format */
 #define	JD_USE_SCALE	1	/* Use descaling feature for output */
 #define JD_TBLCLIP		0	/* Use table for saturation (might be a bit faster but increases 1K bytes of code size) */
 #define JD_BAYER		1	/* Use bayer pattern table */
 
+/* Output pixel formats */
+#define JD_FORMAT_RGB888	0	/* 3 BYTE/pix  R,G,B */
+#define JD_FORMAT_RGB565	1	/* 1 WORD/pix  native endian */
+#define JD_FORMAT_RGB565_BE	2	/* 2 BYTE/pix  RRRRRGGG,GGGBBBBB (LGFX rgb565_2Byte) */
+#define JD_FORMAT_RGB332	3	/* 1 BYTE/pix  RRRGGGBB */
+#define JD_FORMAT_GRAY8		4	/* 1 BYTE/pix  luma only (Cb/Cr are not decoded) */
+
 /*---------------------------------------------------------------------------*/
 
 #ifdef __cplusplus
@@ -81,6 +90,8 @@ struct lgfxJdec {
 	uint32_t (*infunc)(void*, uint8_t*, uint32_t);/* Pointer to jpeg stream input function */
 	void* device;				/* Pointer to I/O device identifiler for the session */
 	uint8_t comps_in_frame;		/* 1=Y(grayscale)  3=YCrCb */
+	uint8_t format;				/* Output pixel format (JD_FORMAT_xxx), may be changed between prepare and decomp */
+	uint16_t vis_left, vis_top, vis_right, vis_bottom;	/* Area of the image to output (pixel, inclusive), may be narrowed between prepare and decomp */
 };
 
 
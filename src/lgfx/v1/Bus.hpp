@@ -20,6 +20,11 @@ Contributors:
 #include <stdint.h>
 
 #include "misc/enum.hpp"
+#include "misc/perf_counter.hpp"
+
+#if defined ( LGFX_USE_PERF_COUNTER )
+#include "misc/pixelcopy.hpp"
+#endif
 
 namespace lgfx
 {
@@ -154,6 +159,56 @@ namespace lgfx
     virtual void setInvert(uint8_t invert) { (void)invert; }
   };
 
+#if defined ( LGFX_USE_PERF_COUNTER )
+
+  /// @brief 別のバスへ処理を中継しつつ、転送量と呼出し回数を計数する;
+  /// Forwards every call to another bus while counting the traffic.
+  struct Bus_PerfCounter : public IBus
+  {
+    void setTarget(IBus* bus) { _target = bus; }
+    IBus* getTarget(void) const { return _target; }
+    bus_perf_counter_t* getPerfCounter(void) { return &_perf; }
+
+    bus_type_t busType(void) const override { return _target->busType(); }
+    bool init(void) override { return _target->init(); }
+    void release(void) override { _target->release(); }
+    uint32_t getClock(void) const override { return _target->getClock(); }
+    uint32_t getReadClock(void) const override { return _target->getReadClock(); }
+    void setClock(uint32_t freq) override { _target->setClock(freq); }
+    void setReadClock(uint32_t freq) override { _target->setReadClock(freq); }
+
+    void beginTransaction(void) override { ++_perf.begin_transaction; _target->beginTransaction(); }
+    void endTransaction(void) override { _target->endTransaction(); }
+    void wait(void) override { _target->wait(); }
+    bool busy(void) const override { return _target->busy(); }
+
+    void initDMA(void) override { _target->initDMA(); }
+    void addDMAQueue(const uint8_t* data, uint32_t length) override { ++_perf.dma_queue; _perf.bytes_written += length; _target->addDMAQueue(data, length); }
+    void execDMAQueue(void) override { ++_perf.dma_flush; _target->execDMAQueue(); }
+    uint8_t* getDMABuffer(uint32_t length) override { return _target->getDMABuffer(length); }
+
+    void flush(void) override { _target->flush(); }
+    bool writeCommand(uint32_t data, uint_fast8_t bit_length) override { ++_perf.write_command; _perf.bytes_written += bit_length >> 3; return _target->writeCommand(data, bit_length); }
+    void writeData(uint32_t data, uint_fast8_t bit_length) override { _perf.bytes_written += bit_length >> 3; _target->writeData(data, bit_length); }
+    void writeDataRepeat(uint32_t data, uint_fast8_t bit_length, uint32_t count) override { _perf.bytes_written += (uint64_t)(bit_length >> 3) * count; _target->writeDataRepeat(data, bit_length, count); }
+    void writePixels(pixelcopy_t* pc, uint32_t length) override { _perf.bytes_written += (uint64_t)length * pc->dst_bits >> 3; _target->writePixels(pc, length); }
+    void writeBytes(const uint8_t* data, uint32_t length, bool dc, bool use_dma) override { _perf.bytes_written += length; _target->writeBytes(data, length, dc, use_dma); }
+
+    void beginRead(uint_fast8_t dummy_bits) override { _target->beginRead(dummy_bits); }
+    void beginRead(void) override { _target->beginRead(); }
+    void endRead(void) override { _target->endRead(); }
+    uint32_t readData(uint_fast8_t bit_length) override { _perf.bytes_read += bit_length >> 3; return _target->readData(bit_length); }
+    bool readBytes(uint8_t* dst, uint32_t length, bool use_dma) override { _perf.bytes_read += length; return _target->readBytes(dst, length, use_dma); }
+    bool readBytes(uint8_t* dst, uint32_t length, bool use_dma, bool last_nack) override { _perf.bytes_read += length; return _target->readBytes(dst, length, use_dma, last_nack); }
+    void readPixels(void* dst, pixelcopy_t* pc, uint32_t length) override { _perf.bytes_read += (uint64_t)length * pc->src_bits >> 3; _target->readPixels(dst, pc, length); }
+
+  protected:
+    IBus* _target = nullptr;
+    bus_perf_counter_t _perf = {};
+  };
+
+#endif
+
 //----------------------------------------------------------------------------
  }
 }
@@ -31,7 +31,8 @@ Contributors:
 #include <stdarg.h>
 #include <stdint.h>
 #include <math.h>
-#include <list>
+#include <vector>
+#include <algorithm>
 
 #ifdef min
 #undef min
@@ -106,6 +107,28 @@ namespace lgfx
     endWrite();
   }
 
+  bool LGFXBase::getPerfCounter(perf_counter_t* dst) const
+  {
+    *dst = perf_counter_t {};
+#if defined ( LGFX_USE_PERF_COUNTER )
+    dst->panel = *_panel->getPerfCounter();
+    auto bus = _panel->getBusPerfCounter();
+    if (bus) { dst->bus = *bus; }
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  void LGFXBase::resetPerfCounter(void)
+  {
+#if defined ( LGFX_USE_PERF_COUNTER )
+    *_panel->getPerfCounter() = panel_perf_counter_t {};
+    auto bus = _panel->getBusPerfCounter();
+    if (bus) { *bus = bus_perf_counter_t {}; }
+#endif
+  }
+
   void LGFXBase::getClipRect(int32_t *x, int32_t *y, int32_t *w, int32_t *h)
   {
     *x = _clip_l;
@@ -681,6 +704,161 @@ namespace lgfx
     endWrite();
   }
 
+  void LGFXBase::drawPolygon(const point_t* points, size_t count)
+  {
+    if (count == 0) return;
+    startWrite();
+    if (count == 1)
+    {
+      drawPixel(points[0].x, points[0].y);
+    }
+    else
+    {
+      for (size_t i = 0; i < count; ++i)
+      {
+        auto& p0 = points[i];
+        auto& p1 = points[(i + 1 == count) ? 0 : i + 1];
+        drawLine(p0.x, p0.y, p1.x, p1.y);
+      }
+    }
+    endWrite();
+  }
+
+  struct polygon_edge_t
+  {
+    int32_t y_start;
+    int32_t y_end;    // exclusive
+    int32_t x0;
+    int32_t y0;
+    int32_t dx;
+    int32_t dy;       // > 0
+    int32_t step;     // floor(dx / dy)
+    int32_t step_rem; // dx - step * dy
+    int32_t x;        // floor of the crossing on the current row
+    int32_t rem;      // 0 <= rem < dy
+    int32_t dir;
+
+    /// the first pixel whose center is on or right of the crossing.
+    int32_t ceil_x(void) const { return x + (rem != 0); }
+
+    void seek(int32_t y)
+    {
+      int64_t num = (int64_t)dx * (y - y0);
+      int64_t q = num / dy;
+      int64_t r = num - q * dy;
+      if (r < 0) { --q; r += dy; }
+      x = x0 + (int32_t)q;
+      rem = (int32_t)r;
+    }
+
+    void next(void)
+    {
+      x += step;
+      rem += step_rem;
+      if (rem >= dy) { rem -= dy; ++x; }
+    }
+  };
+
+  void LGFXBase::fillPolygon(const point_t* points, size_t count, fill_rule_t rule)
+  {
+    if (count < 3) return;
+
+    std::vector<polygon_edge_t> edges;
+    edges.reserve(count);
+    int32_t ymin = INT32_MAX;
+    int32_t ymax = INT32_MIN;
+    for (size_t i = 0; i < count; ++i)
+    {
+      auto p0 = points[i];
+      auto p1 = points[(i + 1 == count) ? 0 : i + 1];
+      if (p0.y == p1.y) continue;  // horizontal edges never cross a sampling row.
+      int32_t dir = 1;
+      if (p0.y > p1.y) { std::swap(p0, p1); dir = -1; }
+      polygon_edge_t e;
+      e.y_start = p0.y;
+      e.y_end   = p1.y;
+      e.x0 = p0.x;
+      e.y0 = p0.y;
+      e.dx = p1.x - p0.x;
+      e.dy = p1.y - p0.y;
+      e.step = e.dx / e.dy;
+      e.step_rem = e.dx - e.step * e.dy;
+      if (e.step_rem < 0) { --e.step; e.step_rem += e.dy; }
+      e.dir = dir;
+      edges.push_back(e);
+      if (ymin > p0.y) ymin = p0.y;
+      if (ymax < p1.y) ymax = p1.y;
+    }
+    if (edges.empty()) return;
+
+    int32_t y  = std::max<int32_t>(ymin, _clip_t);
+    int32_t ye = std::min<int32_t>(ymax, _clip_b + 1);
+    if (y >= ye) return;
+
+    std::sort(edges.begin(), edges.end(), [](const polygon_edge_t& a, const polygon_edge_t& b) { return a.y_start < b.y_start; });
+
+    std::vector<polygon_edge_t*> active;
+    active.reserve(edges.size());
+    size_t next_edge = 0;
+    int32_t cl = _clip_l;
+    int32_t cr = _clip_r + 1;
+    bool evenodd = (rule == fill_evenodd);
+
+    startWrite();
+    do
+    {
+      // drop the finished edges, and advance the remaining ones.
+      size_t n = 0;
+      for (auto e : active)
+      {
+        if (e->y_end <= y) continue;
+        e->next();
+        active[n++] = e;
+      }
+      active.resize(n);
+
+      // add the edges which start on (or above the clipped top of) this row.
+      while (next_edge < edges.size() && edges[next_edge].y_start <= y)
+      {
+        auto e = &edges[next_edge++];
+        if (e->y_end <= y) continue;
+        e->seek(y);
+        active.push_back(e);
+      }
+
+      // the order changes little from row to row, so an insertion sort is enough.
+      for (size_t i = 1; i < active.size(); ++i)
+      {
+        auto e = active[i];
+        int32_t cx = e->ceil_x();
+        size_t j = i;
+        for (; j > 0 && active[j - 1]->ceil_x() > cx; --j)
+        {
+          active[j] = active[j - 1];
+        }
+        active[j] = e;
+      }
+
+      int32_t winding = 0;
+      int32_t left = 0;
+      for (auto e : active)
+      {
+        bool inside = evenodd ? (winding & 1) : (winding != 0);
+        winding += evenodd ? 1 : e->dir;
+        if (inside == (evenodd ? (winding & 1) : (winding != 0))) continue;
+        if (!inside)
+        {
+          left = e->ceil_x();
+          continue;
+        }
+        int32_t l = std::max(left, cl);
+        int32_t r = std::min(e->ceil_x(), cr);
+        if (l < r) { writeFillRectPreclipped(l, y, r - l, 1); }
+      }
+    } while (++y < ye);
+    endWrite();
+  }
+
   void LGFXBase::drawBezier( int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2)
   {
     int32_t x = x0 - x1, y = y0 - y1;
@@ -1092,8 +1270,12 @@ namespace lgfx
 
       rgb888_t scanline[w];
 
+      // lines outside the clip rect are not calculated.
+      int32_t ys = std::max<int32_t>(0, _clip_t - y);
+      int32_t ye = std::min<int32_t>(h, _clip_b + 1 - y);
+
       startWrite();
-      for( int _y=0;_y<h;_y++ ) {
+      for( int _y=ys;_y<ye;_y++ ) {
         // only half of the scan line needs to be calculated, the other half is mirrored
         for( int _x=0;_x<=w/2;_x++ ) {
           auto distance       = pixelDistance( fmidx, fmidy, _x*vratio, _y*hratio );
@@ -1195,6 +1377,196 @@ namespace lgfx
     endWrite();
   }
 
+  struct polygon_cell_t
+  {
+    int32_t y;
+    int32_t x;
+    float cover;
+  };
+
+  struct polygon_raster_t
+  {
+    std::vector<polygon_cell_t> cells;
+    float left;    // left edge of the clip (raster coordinates)
+    float right;   // right edge of the clip + 1 pixel
+    float top;
+    float bottom;
+
+    void add(int32_t x, int32_t y, float cover)
+    {
+      if (x < left) { x = left; }
+      else if (x >= right) { return; }  // never reaches a visible pixel.
+      cells.push_back({ y, x, cover });
+    }
+
+    // accumulates the signed area on the right side of a line. (same as font-rs)
+    void accumulate(float x0, float y0, float x1, float y1)
+    {
+      float dir = 1.0f;
+      if (y0 > y1) { dir = -1.0f; std::swap(x0, x1); std::swap(y0, y1); }
+      float dxdy = (x1 - x0) / (y1 - y0);
+      float x = x0;
+      int32_t ys = floorf(y0);
+      int32_t ye = ceilf(y1);
+      for (int32_t y = ys; y < ye; ++y)
+      {
+        float dy = std::min((float)(y + 1), y1) - std::max((float)y, y0);
+        float xnext = x + dxdy * dy;
+        float d = dy * dir;
+        float xa = x, xb = xnext;
+        if (xa > xb) std::swap(xa, xb);
+        float xa_floor = floorf(xa);
+        int32_t xai = xa_floor;
+        int32_t xbi = ceilf(xb);
+        if (xbi <= xai + 1)
+        {
+          float xmf = 0.5f * (x + xnext) - xa_floor;
+          add(xai    , y, d - d * xmf);
+          add(xai + 1, y, d * xmf);
+        }
+        else
+        {
+          float s = 1.0f / (xb - xa);
+          float xaf = xa - xa_floor;
+          float a0 = 0.5f * s * (1.0f - xaf) * (1.0f - xaf);
+          float xbf = xb - xbi + 1.0f;
+          float am = 0.5f * s * xbf * xbf;
+          add(xai, y, d * a0);
+          if (xbi == xai + 2)
+          {
+            add(xai + 1, y, d * (1.0f - a0 - am));
+          }
+          else
+          {
+            float a1 = s * (1.5f - xaf);
+            add(xai + 1, y, d * (a1 - a0));
+            for (int32_t xi = xai + 2; xi < xbi - 1; ++xi)
+            {
+              add(xi, y, d * s);
+            }
+            float a2 = a1 + (xbi - xai - 3) * s;
+            add(xbi - 1, y, d * (1.0f - a2 - am));
+          }
+          add(xbi, y, d * am);
+        }
+        x = xnext;
+      }
+    }
+
+    void line(float x0, float y0, float x1, float y1)
+    {
+      if (y0 == y1) return;
+      { // clip vertically.
+        float ya = std::max(std::min(y0, y1), top);
+        float yb = std::min(std::max(y0, y1), bottom);
+        if (ya >= yb) return;
+        float dxdy = (x1 - x0) / (y1 - y0);
+        if (y0 < ya || y0 > yb) { float ny = (y0 < ya) ? ya : yb; x0 += (ny - y0) * dxdy; y0 = ny; }
+        if (y1 < ya || y1 > yb) { float ny = (y1 < ya) ? ya : yb; x1 += (ny - y1) * dxdy; y1 = ny; }
+      }
+      // the parts outside the clip are projected onto its left and right edges,
+      // which leaves the coverage of the visible pixels unchanged.
+      float t[4] = { 0.0f, 1.0f, 1.0f, 1.0f };
+      int n = 1;
+      float dx = x1 - x0;
+      if (dx != 0.0f)
+      {
+        float tl = (left  - x0) / dx;
+        float tr = (right - x0) / dx;
+        if (tl > tr) std::swap(tl, tr);
+        if (0.0f < tl && tl < 1.0f) { t[n++] = tl; }
+        if (0.0f < tr && tr < 1.0f) { t[n++] = tr; }
+      }
+      t[n] = 1.0f;
+      float dy = y1 - y0;
+      float px = x0, py = y0;
+      for (int i = 1; i <= n; ++i)
+      {
+        float nx = (i == n) ? x1 : x0 + dx * t[i];
+        float ny = (i == n) ? y1 : y0 + dy * t[i];
+        accumulate(std::min(std::max(px, left), right), py, std::min(std::max(nx, left), right), ny);
+        px = nx;
+        py = ny;
+      }
+    }
+  };
+
+  void LGFXBase::fillSmoothPolygon(const pointf_t* points, size_t count, fill_rule_t rule)
+  {
+    if (count < 3) return;
+
+    polygon_raster_t raster;
+    raster.left   = _clip_l;
+    raster.right  = _clip_r + 1;
+    raster.top    = _clip_t;
+    raster.bottom = _clip_b + 1;
+    raster.cells.reserve(count * 4);
+    for (size_t i = 0; i < count; ++i)
+    {
+      auto& p0 = points[i];
+      auto& p1 = points[(i + 1 == count) ? 0 : i + 1];
+      // pixel centers are on integer coordinates, the raster has them on +0.5.
+      raster.line(p0.x + 0.5f, p0.y + 0.5f, p1.x + 0.5f, p1.y + 0.5f);
+    }
+    auto& cells = raster.cells;
+    if (cells.empty()) return;
+    std::sort(cells.begin(), cells.end(), [](const polygon_cell_t& a, const polygon_cell_t& b) { return a.y != b.y ? a.y < b.y : a.x < b.x; });
+
+    bool evenodd = (rule == fill_evenodd);
+    // not support 1, 2, 4, and palette mode. (coverage is rounded to solid or none)
+    bool blend = (getColorDepth() & color_depth_t::bit_mask) >= 8 && !hasPalette();
+    uint32_t argb = _write_conv.revert_rgb888(_color.raw);
+    int32_t cl = _clip_l;
+    int32_t cr = _clip_r + 1;
+    auto buffer = (argb8888_t*)alloca((cr - cl) * sizeof(argb8888_t));
+    int32_t run_x = 0;
+    int32_t run_len = 0;
+
+    startWrite();
+    size_t i = 0;
+    size_t cell_count = cells.size();
+    do
+    {
+      int32_t y = cells[i].y;
+      float acc = 0.0f;
+      do
+      {
+        int32_t x = cells[i].x;
+        do { acc += cells[i].cover; } while (++i < cell_count && cells[i].y == y && cells[i].x == x);
+        int32_t xe = (i < cell_count && cells[i].y == y) ? cells[i].x : cr;
+
+        // the pixel of the cell and the ones up to the next cell have the same coverage.
+        float a = fabsf(acc);
+        if (evenodd) { a = fmodf(a, 2.0f); if (a > 1.0f) a = 2.0f - a; }
+        else if (a > 1.0f) { a = 1.0f; }
+
+        bool solid = blend ? (a > HiAlphaTheshold) : (a >= 0.5f);
+        bool empty = blend ? (a < LoAlphaTheshold) : !solid;
+        if (run_len && (solid || empty))
+        {
+          pushAlphaImage(run_x, y, run_len, 1, buffer);
+          run_len = 0;
+        }
+        if (solid)
+        {
+          writeFillRectPreclipped(x, y, xe - x, 1);
+        }
+        else if (!empty)
+        {
+          if (run_len == 0) { run_x = x; }
+          uint32_t c = argb | (uint32_t)(a * 255) << 24;
+          for (int32_t xi = x; xi < xe; ++xi) { buffer[run_len++].raw = c; }
+        }
+      } while (i < cell_count && cells[i].y == y);
+      if (run_len)
+      {
+        pushAlphaImage(run_x, y, run_len, 1, buffer);
+        run_len = 0;
+      }
+    } while (i < cell_count);
+    endWrite();
+  }
+
   void LGFXBase::drawEllipseArc(int32_t x, int32_t y, int32_t r0x, int32_t r1x, int32_t r0y, int32_t r1y, float start, float end)
   {
     if (r0x < r1x) std::swap(r0x, r1x);
@@ -1437,6 +1809,7 @@ namespace lgfx
     param->src_y = dy;
 
     startWrite();
+    LGFX_PERF_COUNT(_panel->getPerfCounter()->addWriteImage(dw * dh));
     _panel->writeImage(x, y, dw, dh, param, use_dma);
     endWrite();
   }
@@ -1458,6 +1831,7 @@ namespace lgfx
     param->src_y = dy;
 
     startWrite();
+    LGFX_PERF_COUNT(_panel->getPerfCounter()->addWriteImage(dw * dh));
     _panel->writeImageARGB(x, y, dw, dh, param);
     endWrite();
   }
@@ -1663,6 +2037,7 @@ namespace lgfx
           {
             pc->src_x32_add = iA[0];
             pc->src_y32_add = iA[3];
+            LGFX_PERF_COUNT(_panel->getPerfCounter()->addWriteImage(right - left));
             _panel->writeImage(left, y + max_y, right - left, 1, pc, true);
           }
         }
@@ -1741,6 +2116,7 @@ namespace lgfx
         pc2->src_y32_add = 0;
         pc2->src_x32 = 0;
         pc2->src_y32 = 0;
+        LGFX_PERF_COUNT(_panel->getPerfCounter()->addWriteImage(len));
         _panel->writeImageARGB(left, min_y, len, 1, pc2);
       }
     } while (++min_y != max_y);
@@ -1841,34 +2217,207 @@ namespace lgfx
     if (h > height() - y) h = height() - y;
     if (h < 1) return;
 
+    LGFX_PERF_COUNT(_panel->getPerfCounter()->addReadRect(w * h));
     _panel->readRect(x, y, w, h, dst, param);
   }
 
-  struct paint_point_t { int32_t lx,rx,y,oy; };
+  // a span [lx, rx] of line y to be scanned. dy is the direction away from the line it came from.
+  struct paint_point_t { int32_t lx, rx, y, dy; };
 
-  static void paint_add_points(std::list<paint_point_t>& points, int32_t lx, int32_t rx, int32_t y, int32_t oy, uint8_t* linebuf)
+  // line access through readRect. a few blocks of lines are cached as match flags.
+  struct paint_read_line_t
   {
-    paint_point_t pt { 0, 0, y, oy };
-    do
+    static constexpr size_t block_bytes = 2048;
+    static constexpr size_t block_count = 4;
+
+    IPanel* panel;
+    pixelcopy_t* param;
+    uint8_t* buf[block_count];
+    int32_t buf_y[block_count];
+    uint32_t buf_used[block_count];
+    uint32_t counter = 0;
+    int32_t cl, ct, cb, w, block_h;
+    uint8_t* line = nullptr;
+
+    paint_read_line_t(IPanel* panel_, pixelcopy_t* param_, int32_t cl_, int32_t ct_, int32_t cr_, int32_t cb_)
+    : panel(panel_), param(param_), cl(cl_), ct(ct_), cb(cb_), w(cr_ - cl_ + 1)
+    {
+      block_h = std::max<int32_t>(1, std::min<int32_t>(cb - ct + 1, block_bytes / w));
+      for (size_t i = 0; i < block_count; ++i)
+      {
+        buf[i] = new uint8_t[w * block_h];
+        buf_y[i] = INT32_MIN;
+        buf_used[i] = 0;
+      }
+    }
+
+    ~paint_read_line_t(void)
+    {
+      for (size_t i = 0; i < block_count; ++i) { delete[] buf[i]; }
+    }
+
+    void select(int32_t y)
     {
-      while (lx < rx && !linebuf[lx]) ++lx;
-      if (!linebuf[lx]) break;
-      pt.lx = lx;
-      while (++lx <= rx && linebuf[lx]);
-      pt.rx = lx - 1;
-      points.emplace_back(pt);
-    } while (lx <= rx);
+      size_t i = 0;
+      for (; i < block_count; ++i)
+      {
+        if (buf_y[i] <= y && y < buf_y[i] + block_h) break;
+      }
+      if (i == block_count)
+      { // replace the least recently used block. blocks are aligned so they never overlap.
+        i = 0;
+        for (size_t j = 1; j < block_count; ++j)
+        {
+          if (buf_used[j] < buf_used[i]) i = j;
+        }
+        int32_t by = y - (y - ct) % block_h;
+        buf_y[i] = by;
+        param->src_x32_add = 1 << pixelcopy_t::FP_SCALE;
+        param->src_y32_add = 0;
+        LGFX_PERF_COUNT(panel->getPerfCounter()->addReadRect(w * std::min(block_h, cb - by + 1)));
+        panel->readRect(cl, by, w, std::min(block_h, cb - by + 1), buf[i], param);
+      }
+      buf_used[i] = ++counter;
+      line = &buf[i][(y - buf_y[i]) * w - cl];
+    }
+
+    bool match(int32_t x) const { return line[x]; }
+    void fill(int32_t lx, int32_t rx) { memset(&line[lx], 0, rx - lx + 1); }
+  };
+
+  // direct access to the pixel memory of Panel_Sprite / Panel_FrameBufferBase.
+  template <typename T>
+  struct paint_direct_line_t
+  {
+    IPanel* panel;
+    T target;
+    const T* line = nullptr;
+
+    void select(int32_t y) { line = static_cast<const T*>(panel->getFrameBufferLine(y)); }
+    bool match(int32_t x) const { return line[x] == target; }
+    void fill(int32_t, int32_t) {}
+  };
+
+  template <typename TLine>
+  static void paint_spans(LGFXBase* gfx, TLine& line, int32_t x, int32_t y, int32_t cl, int32_t ct, int32_t cr, int32_t cb)
+  {
+    std::vector<paint_point_t> stack;
+    stack.reserve(64);
+    auto push = [&](int32_t lx, int32_t rx, int32_t py, int32_t dy)
+    {
+      int32_t ny = py + dy;
+      if (ny >= ct && ny <= cb) { stack.push_back({ lx, rx, ny, dy }); }
+    };
+    push(x, x, y - 1,  1);
+    push(x, x, y    , -1);
+
+    while (!stack.empty())
+    {
+      auto pt = stack.back();
+      stack.pop_back();
+      int32_t x1 = pt.lx;
+      int32_t x2 = pt.rx;
+      int32_t py = pt.y;
+      int32_t dy = pt.dy;
+      line.select(py);
+
+      int32_t l;
+      int32_t px = x1;
+      if (line.match(px))
+      { // the span may extend to the left of the parent span.
+        while (px > cl && line.match(px - 1)) --px;
+        l = px;
+        px = x1 + 1;
+      }
+      else
+      {
+        while (++px <= x2 && !line.match(px));
+        if (px > x2) continue;
+        l = px++;
+      }
+
+      for (;;)
+      {
+        while (px <= cr && line.match(px)) ++px;
+        line.fill(l, px - 1);
+        gfx->writeFillRectPreclipped(l, py, px - l, 1);
+
+        push(l, px - 1, py, dy);
+        // the parts wider than the parent span can leak back to the parent line.
+        if (l < x1)      { push(l, x1 - 1, py, -dy); }
+        if (px - 1 > x2) { push(x2 + 1, px - 1, py, -dy); }
+
+        while (++px <= x2 && !line.match(px));
+        if (px > x2) break;
+        l = px;
+      }
+    }
   }
 
   void LGFXBase::floodFill(int32_t x, int32_t y)
   {
     if (x < _clip_l || x > _clip_r || y < _clip_t || y > _clip_b) return;
+    uint32_t raw_mask = (_write_conv.bits >= 32) ? ~0u : (1u << _write_conv.bits) - 1;
+    uint32_t fill_raw = _color.raw & raw_mask;
+
+    // the stored value of the target pixel is compared with the fill value,
+    // since palettes and grayscale do not convert back from rgb to the same value.
     bgr888_t target;
-    readRectRGB(x, y, 1, 1, &target);
-    if (_color.raw == _write_conv.convert(lgfx::color888(target.r, target.g, target.b))) return;
+    uint32_t target_raw = 0;
+    bool raw_compare = hasPalette() || _read_conv.bits < 8;
+    if (auto ptr = (const uint8_t*)_panel->getFrameBufferLine(y))
+    {
+      memcpy(&target_raw, &ptr[x * (_write_conv.bits >> 3)], _write_conv.bits >> 3);
+      if (target_raw == fill_raw) return;
+    }
+    else if (raw_compare)
+    { // read the stored index (or bits) of the target pixel.
+      pixelcopy_t p(nullptr, palette_8bit, _read_conv.depth, true);
+      _panel->readRect(x, y, 1, 1, &target_raw, &p);
+      if (target_raw == fill_raw) return;
+    }
+    if (!raw_compare)
+    {
+      readRectRGB(x, y, 1, 1, &target);
+      if (_color.raw == _write_conv.convert(lgfx::color888(target.r, target.g, target.b))) return;
+    }
+
+    startWrite();
+    if (auto ptr = (const uint8_t*)_panel->getFrameBufferLine(y))
+    {
+      switch (_write_conv.bits)
+      {
+      case 8:
+        {
+          paint_direct_line_t<uint8_t> line { _panel, ptr[x] };
+          paint_spans(this, line, x, y, _clip_l, _clip_t, _clip_r, _clip_b);
+        }
+        break;
+      case 16:
+        {
+          paint_direct_line_t<uint16_t> line { _panel, ((const uint16_t*)ptr)[x] };
+          paint_spans(this, line, x, y, _clip_l, _clip_t, _clip_r, _clip_b);
+        }
+        break;
+      case 24:
+        {
+          paint_direct_line_t<bgr888_t> line { _panel, ((const bgr888_t*)ptr)[x] };
+          paint_spans(this, line, x, y, _clip_l, _clip_t, _clip_r, _clip_b);
+        }
+        break;
+      default:
+        ptr = nullptr;
+        break;
+      }
+      if (ptr)
+      {
+        endWrite();
+        return;
+      }
+    }
 
     pixelcopy_t p;
-    p.transp = _read_conv.convert(lgfx::color888(target.r, target.g, target.b));
+    p.transp = raw_compare ? target_raw : _read_conv.convert(lgfx::color888(target.r, target.g, target.b));
     p.src_bits = _read_conv.depth & color_depth_t::bit_mask;
     switch (_read_conv.depth)
     {
@@ -1882,91 +2431,10 @@ namespace lgfx
       break;
     }
 
-    const int32_t cl = _clip_l;
-    const int32_t w = _clip_r - cl + 1;
-    size_t bufIdx = 0;
-    uint8_t* linebufs[3] = { new uint8_t[w], new uint8_t[w], new uint8_t[w] };
-    int32_t bufY[3] = {y, -2, -2};  // 3 line buffer (default: out of range.)
-    _panel->readRect(cl, y, w, 1, linebufs[0], &p);
-    std::list<paint_point_t> points;
-    points.push_back({x, x, y, y});
-
-    startWrite();
-    while (!points.empty())
     {
-      int32_t y0 = bufY[bufIdx];
-
-      auto it = points.begin();
-      int32_t counter = 0;
-      while (it->y != y0 && ++it != points.end()) ++counter;
-      if (it == points.end())
-      {
-        if (counter < 256)
-        {
-          ++bufIdx;
-          int32_t y1 = bufY[(bufIdx  )%3];
-          int32_t y2 = bufY[(bufIdx+1)%3];
-          it = points.begin();
-
-          while ((it->y != y1) && (it->y != y2) && (++it != points.end()));
-        }
-        bufIdx = 0;
-        if (it == points.end())
-        {
-          it = points.begin();
-
-          bufY[0] = it->y;
-          p.src_x32_add = 1 << FP_SCALE;
-          p.src_y32_add = 0;
-          _panel->readRect(cl, it->y, w, 1, linebufs[0], &p);
-        }
-        else
-        {
-          for (; bufIdx < 2; ++bufIdx) if (it->y == bufY[bufIdx]) break;
-        }
-      }
-      auto linebuf = &linebufs[bufIdx][- cl];
-
-      int32_t lx = it->lx;
-      int32_t rx = it->rx;
-      int32_t ly = it->y;
-      int32_t oy = it->oy;
-      points.erase(it);
-      if (!linebuf[lx]) continue;
-
-      int32_t lxsav = lx - 1;
-      int32_t rxsav = rx + 1;
-
-      const int32_t cr = _clip_r;
-      while (lx > cl && linebuf[lx - 1]) --lx;
-      while (rx < cr && linebuf[rx + 1]) ++rx;
-      bool flg_noexpanded = lx >= lxsav && rxsav >= rx;
-
-      memset(&linebuf[lx], 0, rx - lx + 1);
-      writeFillRectPreclipped(lx, ly, rx - lx + 1, 1);
-
-      int32_t nexty[2] = { ly - 1, ly + 1 };
-      if (ly < y) std::swap(nexty[0], nexty[1]);
-      size_t i = 0;
-      do
-      {
-        int32_t newy = nexty[i];
-        if (newy == oy && flg_noexpanded) continue;
-        if (newy < _clip_t || newy > _clip_b) continue;
-        size_t bidx = 0;
-        while (newy != bufY[bidx] && ++bidx != 3);
-        if (bidx == 3) {
-          for (bidx = 0; bidx < 2 && (abs(bufY[bidx] - ly) <= 1); ++bidx);
-          bufY[bidx] = newy;
-          p.src_x32_add = 1 << FP_SCALE;
-          p.src_y32_add = 0;
-          _panel->readRect(cl, newy, w, 1, linebufs[bidx], &p);
-        }
-        paint_add_points(points, lx ,rx, newy, ly, &linebufs[bidx][- cl]);
-      } while (++i < 2);
+      paint_read_line_t line(_panel, &p, _clip_l, _clip_t, _clip_r, _clip_b);
+      paint_spans(this, line, x, y, _clip_l, _clip_t, _clip_r, _clip_b);
     }
-    size_t i = 0;
-    do { delete[] linebufs[i]; } while (++i != 3);
     endWrite();
   }
 
@@ -2223,6 +2691,11 @@ namespace lgfx
     {
       font->getDefaultMetric(&metrics);
     }
+    if (_string_cache && string)
+    {
+      size_t result;
+      if (_string_cache->draw(this, _panel, string, x, y, datum, font, &_text_style, &result)) { return result; }
+    }
     int16_t sumX = 0;
     int32_t cwidth = text_width(string, font, &metrics); // Find the pixel width of the string in the font
     int32_t sy = 65536 * _text_style.size_y;
@@ -2434,6 +2907,10 @@ namespace lgfx
   {
     if (_font == font) return;
 
+    if (_runtime_font && _string_cache)
+    { // the address of the released font may be reused by the next one.
+      _string_cache->clear();
+    }
     _runtime_font.reset();
     if (font == nullptr) font = &fonts::Font0;
     _font = font;
@@ -2508,6 +2985,10 @@ namespace lgfx
       result = true;
       this->_font = this->_runtime_font.get();
       this->_font->getDefaultMetric(&this->_font_metrics);
+      if (_font_cache_glyphs && this->_font->getType() == IFont::font_type_t::ft_vlw)
+      {
+        static_cast<VLWfont*>(this->_runtime_font.get())->setGlyphCache(_font_cache_glyphs, _font_cache_bytes);
+      }
     } else {
       this->unloadFont();
     }
@@ -2519,6 +3000,49 @@ namespace lgfx
     if (_runtime_font.get() != nullptr) { setFont(&fonts::Font0); }
   }
 
+  bool LGFXBase::setFontCacheSize(uint16_t glyphs, size_t bytes)
+  {
+    _font_cache_glyphs = glyphs;
+    _font_cache_bytes = bytes;
+    if (_runtime_font.get() == nullptr || _runtime_font->getType() != IFont::font_type_t::ft_vlw) return true;
+    return static_cast<VLWfont*>(_runtime_font.get())->setGlyphCache(glyphs, bytes);
+  }
+
+  void LGFXBase::setStringCacheSize(size_t bytes)
+  {
+    if (bytes == 0)
+    {
+      _string_cache.reset();
+      return;
+    }
+    if (_string_cache.get() == nullptr)
+    {
+      _string_cache.reset(new LGFX_StringCache());
+    }
+    _string_cache->setMaxBytes(bytes);
+  }
+
+  void LGFXBase::setImageCacheSize(size_t bytes, bool psram)
+  {
+    if (bytes == 0)
+    {
+      _image_cache.reset();
+      return;
+    }
+    if (_image_cache.get() == nullptr)
+    {
+      _image_cache.reset(new LGFX_ImageCache());
+    }
+    _image_cache->setPsram(psram);
+    _image_cache->setMaxBytes(bytes);
+  }
+
+  size_t LGFXBase::preloadFont(uint16_t first, uint16_t last)
+  {
+    if (_runtime_font.get() == nullptr || _runtime_font->getType() != IFont::font_type_t::ft_vlw) return 0;
+    return static_cast<VLWfont*>(_runtime_font.get())->preloadGlyphs(first, last);
+  }
+
   void LGFXBase::showFont(uint32_t td)
   {
     int_fast16_t x = 0;
@@ -2663,20 +3187,7 @@ namespace lgfx
       {
         float fit_width  = (maxWidth_  > 0) ? maxWidth_  : gfx_->width();
         float fit_height = (maxHeight_ > 0) ? maxHeight_ : gfx_->height();
-        if (zoom_x_ <= -1.0f) { zoom_x_ = fit_width  / w_; }
-        if (zoom_y_ <= -1.0f) { zoom_y_ = fit_height / h_; }
-        if (zoom_x_ <= 0.0f)
-        {
-          if (zoom_y_ <= 0.0f)
-          {
-            zoom_y_ = std::min<float>(fit_width / w_, fit_height / h_);
-          }
-          zoom_x_ = zoom_y_;
-        }
-        if (zoom_y_ <= 0.0f)
-        {
-          zoom_y_ = zoom_x_;
-        }
+        LGFX_ImageCache::fitZoom(&zoom_x_, &zoom_y_, fit_width, fit_height, w_, h_);
       }
 
       if (datum_)
@@ -2818,6 +3329,7 @@ namespace lgfx
     do
     {
       data->preRead();
+      p.src_data = lineBuffer;
       if (bmpdata.biCompression == 1)
       {
         bmpdata.load_bmp_rle8(data, lineBuffer, w);
@@ -2827,8 +3339,10 @@ namespace lgfx
         bmpdata.load_bmp_rle4(data, lineBuffer, w);
       }
       else
-      {
-        data->read(lineBuffer, buffersize);
+      { // use the line in the wrapper's memory when it is available. (mmap, buffered)
+        auto span = data->readSpan(buffersize);
+        if (span) { p.src_data = span; }
+        else { data->read(lineBuffer, buffersize); }
       }
       data->postRead();
       y32 += dst_y32_add;
@@ -2871,8 +3385,55 @@ namespace lgfx
   struct draw_jpg_info_t : public image_decoder_t
   {
     pixelcopy_t *pc;
+
+    // the decoder outputs the luma only. (JD_FORMAT_GRAY8)
+    bool luma;
+    // for the palette or less than 8bit : the luma is shifted to the bits of the index.
+    uint8_t luma_shift;
+
+    // used by jpg_write_direct.
+    IPanel* panel;
+    int32_t clip_l, clip_t, clip_r, clip_b;
+    uint32_t bytes;
   };
 
+  /// 回転なしのメモリ上のパネルへ、デコーダが出力したネイティブ形式のMCUを直接書込む;
+  /// writes the MCU in the native format straight into the memory of an unrotated panel.
+  static uint32_t jpg_write_direct(void *device, void *bitmap, JRECT *rect)
+  {
+    draw_jpg_info_t *jpeg = static_cast<draw_jpg_info_t*>(device);
+    jpeg->data->postRead();
+    int32_t x = jpeg->x + rect->left;
+    int32_t y = jpeg->y + rect->top;
+    int32_t w = rect->right  - rect->left + 1;
+    int32_t h = rect->bottom - rect->top + 1;
+    int32_t xs = std::max(x, jpeg->clip_l);
+    int32_t ys = std::max(y, jpeg->clip_t);
+    int32_t xe = std::min(x + w, jpeg->clip_r + 1);
+    int32_t ye = std::min(y + h, jpeg->clip_b + 1);
+    if (xs >= xe || ys >= ye) return 1;
+
+    size_t bytes = jpeg->bytes;
+    size_t len = (xe - xs) * bytes;
+    auto src = static_cast<const uint8_t*>(bitmap) + ((ys - y) * w + (xs - x)) * bytes;
+    auto panel = jpeg->panel;
+    for (int32_t i = ys; i < ye; ++i)
+    {
+      memcpy(static_cast<uint8_t*>(panel->getFrameBufferLine(i)) + xs * bytes, src, len);
+      src += w * bytes;
+    }
+    panel->commitFrameBuffer(xs, ys, xe - xs, ye - ys);
+    return 1;
+  }
+
+  static void jpg_shift_luma(draw_jpg_info_t *jpeg, void *bitmap, size_t len)
+  {
+    auto shift = jpeg->luma_shift;
+    if (shift == 0) { return; }
+    auto p = static_cast<uint8_t*>(bitmap);
+    do { *p >>= shift; ++p; } while (--len);
+  }
+
   static uint32_t jpg_push_image(void *device, void *bitmap, JRECT *rect)
   {
     draw_jpg_info_t *jpeg = static_cast<draw_jpg_info_t*>(device);
@@ -2883,6 +3444,7 @@ namespace lgfx
     int32_t y = rect->top;
     int32_t w = rect->right  - rect->left + 1;
     int32_t h = rect->bottom - rect->top + 1;
+    jpg_shift_luma(jpeg, bitmap, w * h);
     jpeg->pc->src_x32_add = 1 << FP_SCALE;
     jpeg->pc->src_y32_add = 0;
     jpeg->gfx->pushImage( jpeg->x + x
@@ -2909,7 +3471,15 @@ namespace lgfx
     { jpeg->zoom_x, 0.0f , x * jpeg->zoom_x + jpeg->x
     , 0.0f , jpeg->zoom_y, y * jpeg->zoom_y + jpeg->y
     };
-    jpeg->gfx->pushImageAffine( affine, w, h, (bgr888_t*)jpeg->pc->src_data );
+    if (jpeg->luma)
+    {
+      jpg_shift_luma(jpeg, bitmap, w * h);
+      jpeg->gfx->pushImageAffine( affine, w, h, bitmap, grayscale_8bit, (const bgr888_t*)nullptr );
+    }
+    else
+    {
+      jpeg->gfx->pushImageAffine( affine, w, h, (bgr888_t*)jpeg->pc->src_data );
+    }
     return 1;
   }
 
@@ -2972,9 +3542,63 @@ namespace lgfx
       drawinfo.zoom_y *= 1 << div;
     }
 
+    { // decode only the MCUs in the clipping rectangle (with a margin of one output pixel), and end after the last visible row.
+      float sx = (1 << div) / drawinfo.zoom_x;  // source pixels per destination pixel
+      float sy = (1 << div) / drawinfo.zoom_y;
+      int32_t margin = 1 << div;
+      int32_t l = floorf((_clip_l     - drawinfo.x) * sx) - margin;
+      int32_t r =  ceilf((_clip_r + 1 - drawinfo.x) * sx) + margin;
+      int32_t t = floorf((_clip_t     - drawinfo.y) * sy) - margin;
+      int32_t b =  ceilf((_clip_b + 1 - drawinfo.y) * sy) + margin;
+      jpegdec.vis_left   = std::max<int32_t>(l, 0);
+      jpegdec.vis_top    = std::max<int32_t>(t, 0);
+      jpegdec.vis_right  = std::min<int32_t>(r, jpegdec.width  - 1);
+      jpegdec.vis_bottom = std::min<int32_t>(b, jpegdec.height - 1);
+    }
+
+    auto depth = getColorDepth();
+    // grayscale panels and sprites, palettes and less than 8bit : decode only the luma, and skip the chroma.
+    bool bitcopy = hasPalette() || (depth & color_depth_t::bit_mask) < 8;
+    drawinfo.luma = bitcopy || depth == grayscale_8bit || _panel->isGrayscale();
+    drawinfo.luma_shift = 0;
+    if (drawinfo.luma)
+    {
+      jpegdec.format = JD_FORMAT_GRAY8;
+      pc = pixelcopy_t(nullptr, depth, grayscale_8bit, hasPalette());
+      if (bitcopy) { drawinfo.luma_shift = 8 - (depth & color_depth_t::bit_mask); }
+    }
+
+    auto outfunc = jpg_push_image_affine;
+    if (drawinfo.zoom_x == 1.0f && drawinfo.zoom_y == 1.0f)
+    {
+      outfunc = jpg_push_image;
+      // without zooming, let the decoder output the native pixel format and skip the conversion from bgr888.
+      if (drawinfo.luma ? (depth == grayscale_8bit && !bitcopy)
+                        : (!hasPalette() && (depth == rgb565_2Byte || depth == rgb332_1Byte || depth == rgb888_3Byte)))
+      {
+        if (!drawinfo.luma)
+        {
+          jpegdec.format = (depth == rgb565_2Byte) ? JD_FORMAT_RGB565_BE
+                         : (depth == rgb332_1Byte) ? JD_FORMAT_RGB332
+                         : JD_FORMAT_RGB888;
+          pc = pixelcopy_t(nullptr, depth, depth);
+        }
+        if (_panel->getFrameBufferLine(0))
+        { // sprite or frame buffer : write into the memory without pushImage.
+          outfunc = jpg_write_direct;
+          drawinfo.panel = _panel;
+          drawinfo.bytes = (depth & color_depth_t::bit_mask) >> 3;
+          drawinfo.clip_l = _clip_l;
+          drawinfo.clip_t = _clip_t;
+          drawinfo.clip_r = _clip_r;
+          drawinfo.clip_b = _clip_b;
+        }
+      }
+    }
+
     this->startWrite(!data->hasParent());
 
-    jres = lgfx_jd_decomp(&jpegdec, drawinfo.zoom_x == 1.0f && drawinfo.zoom_y == 1.0f ? jpg_push_image : jpg_push_image_affine, div);
+    jres = lgfx_jd_decomp(&jpegdec, outfunc, div);
 
     drawinfo.end();
     this->endWrite();
@@ -2998,25 +3622,26 @@ namespace lgfx
 //-----
 
 
-  static void png_draw_alpha_callback(void *user_data, uint32_t x, uint32_t y, uint_fast8_t div_x, size_t len, const uint8_t* argb)
+  static uint32_t png_draw_alpha_callback(void *user_data, uint32_t x, uint32_t y, uint_fast8_t div_x, size_t len, const uint8_t* argb)
   {
     auto p = (png_file_decoder_t*)user_data;
 
     int32_t y0 = (int32_t)y - p->offY;
     int32_t y1 = y0 + 1;
+    if (y0 >= p->maxHeight) return 0; // below the visible area : the decoding can end.
     if (y0 < 0) y0 = 0;
     if (y1 > p->maxHeight) y1 = p->maxHeight;
-    if (y0 >= y1) return;
+    if (y0 >= y1) return 1;
 
     while (argb[0] == 0)
     {
       argb += 4;
       x += div_x;
-      if (0 == --len) { return; }
+      if (0 == --len) { return 1; }
     }
     while (argb[(len-1)*4] == 0)
     {
-      if (0 == --len) { return; }
+      if (0 == --len) { return 1; }
     }
 /*
     while ((argb[idx * 4 + 3] == 0) && ++idx != len);
@@ -3038,7 +3663,7 @@ namespace lgfx
     }
     x -= p->offX;
 
-    if (!len || (int32_t)x >= p->maxWidth) return;
+    if (!len || (int32_t)x >= p->maxWidth) return 1;
 
     size_t idx = 0;
     while ((argb[idx * 4] == 255) && ++idx != len);
@@ -3112,17 +3737,19 @@ namespace lgfx
         argb += 4;
       } while (--len);
     }
+    return 1;
   }
 
-  static void png_draw_alpha_scale_callback(void *user_data, uint32_t x, uint32_t y, uint_fast8_t div_x, size_t len, const uint8_t* argb)
+  static uint32_t png_draw_alpha_scale_callback(void *user_data, uint32_t x, uint32_t y, uint_fast8_t div_x, size_t len, const uint8_t* argb)
   {
     auto p = (png_file_decoder_t*)user_data;
 
     int32_t y0 = ceilf( y      * p->zoom_y) - p->offY;
+    if (y0 >= p->maxHeight) return 0; // below the visible area : the decoding can end.
     if (y0 < 0) y0 = 0;
     int32_t y1 = ceilf((y + 1) * p->zoom_y) - p->offY;
     if (y1 > p->maxHeight) y1 = p->maxHeight;
-    if (y0 >= y1) return;
+    if (y0 >= y1) return 1;
 
     size_t idx = 0;
 /*
@@ -3282,6 +3909,7 @@ namespace lgfx
         x += div_x;
       } while (--len);
     }
+    return 1;
   }
 
 
@@ -3294,7 +3922,52 @@ namespace lgfx
     }
   }
 
+  static uint32_t png_draw_index_callback(void *user_data, uint32_t x, uint32_t y, uint_fast8_t div_x, size_t len, const uint8_t* index)
+  {
+    auto p = (png_file_decoder_t*)user_data;
+
+    int32_t y0 = (int32_t)y - p->offY;
+    if (y0 >= p->maxHeight) return 0; // below the visible area : the decoding can end.
+    if (y0 < 0) return 1;
+
+    uint32_t count;
+    auto palette = lgfx_pngle_get_palette(pngle, &count);
+    p->data->postRead();
+
+    do
+    { // skip the pixels out of the area and the transparent ones. (palette alpha 0. indices can not be blended, so the others are written as they are)
+      while ((int32_t)x < p->offX || (index[0] < count && palette[index[0] * 4] == 0))
+      {
+        x += div_x;
+        ++index;
+        if (0 == --len) { return 1; }
+      }
+      int32_t dx = x - p->offX;
+      if (dx >= p->maxWidth) { return 1; }
+
+      size_t run = 1;
+      if (div_x == 1)
+      { // a run of opaque pixels.
+        size_t limit = std::min<size_t>(len, p->maxWidth - dx);
+        while (run < limit && (index[run] >= count || palette[index[run] * 4] != 0)) { ++run; }
+      }
+      p->pc->src_data = index;
+      p->pc->src_x32_add = 1 << FP_SCALE;
+      p->pc->src_y32_add = 0;
+      p->gfx->pushImage(p->x + dx, p->y + y0, run, 1, p->pc, false);
+      x += run * div_x;
+      index += run;
+      len -= run;
+    } while (len);
+    return 1;
+  }
+
   bool LGFXBase::draw_png(DataWrapper* data, int32_t x, int32_t y, int32_t maxWidth, int32_t maxHeight, int32_t offX, int32_t offY, float zoom_x, float zoom_y, datum_t datum)
+  {
+    return draw_png_impl(data, x, y, maxWidth, maxHeight, offX, offY, zoom_x, zoom_y, datum, false);
+  }
+
+  bool LGFXBase::draw_png_impl(DataWrapper* data, int32_t x, int32_t y, int32_t maxWidth, int32_t maxHeight, int32_t offX, int32_t offY, float zoom_x, float zoom_y, datum_t datum, bool load_palette)
   {
     /// PNG描画を繰り返し使用した場合、pngleのメモリ確保に失敗するケースがある。
     /// そのため、pngle使用後に解放せず、再利用できる構成に変更した。
@@ -3329,7 +4002,17 @@ namespace lgfx
       return true;
     }
 
+    // indexed PNG into a palette sprite : write the palette indices as they are, without expanding them to argb.
+    auto ihdr = lgfx_pngle_get_ihdr(pngle);
+    bool index = this->hasPalette()
+              && ihdr->color_type == 3
+              && ihdr->depth <= (this->getColorDepth() & color_depth_t::bit_mask)
+              && png.zoom_x == 1.0f && png.zoom_y == 1.0f;
+
     pixelcopy_t pc(nullptr, this->getColorDepth(), bgra8888_t::depth, this->_palette_count);
+    if (index) {
+      pc = pixelcopy_t(nullptr, this->getColorDepth(), palette_8bit, true);
+    } else
     if (this->hasPalette() || pc.dst_bits < 8) {
       pc.fp_copy = pixelcopy_t::copy_bit_affine;
       pc.fp_skip = pixelcopy_t::skip_bit_affine;
@@ -3346,7 +4029,8 @@ namespace lgfx
 
     this->startWrite(!data->hasParent());
 
-    auto res = lgfx_pngle_decomp(pngle, png.zoom_x == 1.0f && png.zoom_y == 1.0f ? png_draw_alpha_callback : png_draw_alpha_scale_callback);
+    auto res = index ? lgfx_pngle_decomp_index(pngle, png_draw_index_callback)
+             : lgfx_pngle_decomp(pngle, png.zoom_x == 1.0f && png.zoom_y == 1.0f ? png_draw_alpha_callback : png_draw_alpha_scale_callback);
 
     this->endWrite();
     if (png.lineBuffer) {
@@ -3355,6 +4039,18 @@ namespace lgfx
     }
     png.end();
 
+    auto dst_palette = this->getPalette();
+    if (index && load_palette && dst_palette)
+    {
+      uint32_t count;
+      auto palette = lgfx_pngle_get_palette(pngle, &count);
+      if (count > _palette_count) { count = _palette_count; }
+      for (uint32_t i = 0; i < count; ++i)
+      {
+        dst_palette[i].set(palette[i * 4 + 1], palette[i * 4 + 2], palette[i * 4 + 3]);
+      }
+    }
+
     return res < 0 ? false : true;
   }
 
@@ -3427,6 +4123,9 @@ namespace lgfx
     LGFXBase* gfx;
     int32_t x;
     int32_t y;
+    LGFXBase::image_writer_t writer;
+    void* user;
+    bool failed;
   };
 
   static uint8_t *png_encoder_get_row( uint8_t *pImage, int flip, int w, int h, int y, int, void *target )
@@ -3437,19 +4136,44 @@ namespace lgfx
     return pImage;
   }
 
-  void* LGFXBase::createPng(size_t* datalen, int32_t x, int32_t y, int32_t w, int32_t h)
+  static lgfx_mz_bool png_encoder_put(const void* buf, int len, void* target)
+  {
+    auto enc = static_cast<png_encoder_t*>(target);
+    return enc->writer(enc->user, static_cast<const uint8_t*>(buf), len);
+  }
+
+  static uint8_t *qoi_encoder_get_row( uint8_t *lineBuffer, int flip, int w, int h, int y, void *qoienc )
+  {
+    return png_encoder_get_row(lineBuffer, flip, w, h, y, 0, qoienc);
+  }
+
+  static int qoi_encoder_put(void* target, uint8_t* buf, size_t len)
   {
-    if (_adjust_abs(x, w)||_adjust_abs(y, h)) return nullptr;
+    auto enc = static_cast<png_encoder_t*>(target);
+    if (!enc->failed && !enc->writer(enc->user, buf, len)) { enc->failed = true; }
+    return !enc->failed;
+  }
+
+  bool LGFXBase::_adjust_capture(int32_t& x, int32_t& y, int32_t& w, int32_t& h)
+  {
+    if (w == 0) { w = width()  - x; }
+    if (h == 0) { h = height() - y; }
+    if (_adjust_abs(x, w)||_adjust_abs(y, h)) return false;
     if (x < 0) { w += x; x = 0; }
     if (w > width() - x)  w = width()  - x;
-    if (w < 1) return nullptr;
+    if (w < 1) return false;
     if (y < 0) { h += y; y = 0; }
     if (h > height() - y) h = height() - y;
-    if (h < 1) return nullptr;
+    return h > 0;
+  }
+
+  void* LGFXBase::createPng(size_t* datalen, int32_t x, int32_t y, int32_t w, int32_t h)
+  {
+    if (!_adjust_capture(x, y, w, h)) return nullptr;
 
     void* rgbBuffer = heap_alloc_dma(w * 3);
 
-    png_encoder_t enc = { this, x, y };
+    png_encoder_t enc = { this, x, y, nullptr, nullptr, false };
 
     auto res = tdefl_write_image_to_png_file_in_memory_ex_with_cb(rgbBuffer, w, h, 3, datalen, 6, 0, (tdefl_get_png_row_func)png_encoder_get_row, &enc);
 
@@ -3458,6 +4182,39 @@ namespace lgfx
     return res;
   }
 
+  bool LGFXBase::createPng(image_writer_t writer, void* user, int32_t x, int32_t y, int32_t w, int32_t h, uint8_t level)
+  {
+    if (writer == nullptr || !_adjust_capture(x, y, w, h)) return false;
+
+    void* rgbBuffer = heap_alloc_dma(w * 3);
+    if (rgbBuffer == nullptr) return false;
+
+    png_encoder_t enc = { this, x, y, writer, user, false };
+
+    bool res = tdefl_write_image_to_png_stream(rgbBuffer, w, h, 3, level, 0, (tdefl_get_png_row_func)png_encoder_get_row, &enc, png_encoder_put, &enc);
+
+    heap_free(rgbBuffer);
+
+    return res;
+  }
+
+  bool LGFXBase::createQoi(image_writer_t writer, void* user, int32_t x, int32_t y, int32_t w, int32_t h)
+  {
+    if (writer == nullptr || !_adjust_capture(x, y, w, h)) return false;
+
+    void* rgbBuffer = heap_alloc_dma(w * 3);
+    if (rgbBuffer == nullptr) return false;
+
+    png_encoder_t enc = { this, x, y, writer, user, false };
+
+    static constexpr uint32_t write_buffer_len = 1024;
+    bool res = lgfx_qoi_encoder_write_cb(rgbBuffer, write_buffer_len, w, h, 3, 0, qoi_encoder_get_row, qoi_encoder_put, &enc) && !enc.failed;
+
+    heap_free(rgbBuffer);
+
+    return res;
+  }
+
 //----------------------------------------------------------------------------
 
   void LGFXBase::prepareTmpTransaction(DataWrapper* data)
@@ -28,8 +28,11 @@ Contributors:
 #include "misc/enum.hpp"
 #include "misc/colortype.hpp"
 #include "misc/pixelcopy.hpp"
+#include "misc/range.hpp"
 #include "misc/DataWrapper.hpp"
 #include "lgfx_fonts.hpp"
+#include "LGFX_StringCache.hpp"
+#include "LGFX_ImageCache.hpp"
 #include "Touch.hpp"
 #include "panel/Panel_Device.hpp"
 #include "../boards.hpp"
@@ -137,8 +140,8 @@ namespace lgfx
     LGFX_INLINE   void startWrite(bool transaction = true) { _panel->startWrite(transaction); }
     /// @brief Release bus for screen communication.
     LGFX_INLINE   void endWrite(void)                      { _panel->endWrite(); }
-    LGFX_INLINE   void beginTransaction(void)              { _panel->beginTransaction(); }
-    LGFX_INLINE   void endTransaction(void)                { _panel->endTransaction(); }
+    LGFX_INLINE   void beginTransaction(void)              { LGFX_PERF_COUNT(++_panel->getPerfCounter()->begin_transaction); _panel->beginTransaction(); }
+    LGFX_INLINE   void endTransaction(void)                { LGFX_PERF_COUNT(++_panel->getPerfCounter()->end_transaction); _panel->endTransaction(); }
     LGFX_INLINE   uint32_t getStartCount(void) const  { return _panel->getStartCount(); }
 
     LGFX_INLINE   void setWindow(uint_fast16_t xs, uint_fast16_t ys, uint_fast16_t xe, uint_fast16_t ye) { _panel->setWindow(xs, ys, xe, ye); }
@@ -151,15 +154,15 @@ namespace lgfx
     LGFX_INLINE_T void writeFillRect   ( int32_t x, int32_t y, int32_t w, int32_t h, const T& color) { setColor(color); writeFillRect (x, y, w, h); }
                   void writeFillRect   ( int32_t x, int32_t y, int32_t w, int32_t h);
     LGFX_INLINE_T void writeFillRectPreclipped( int32_t x, int32_t y, int32_t w, int32_t h, const T& color) { setColor(color); writeFillRectPreclipped(x, y, w, h); }
-    LGFX_INLINE   void writeFillRectPreclipped( int32_t x, int32_t y, int32_t w, int32_t h)                 { _panel->writeFillRectPreclipped(x, y, w, h, getRawColor()); }
-    LGFX_INLINE_T void writeColor      ( const T& color, uint32_t length) { if (0 == length) return; setColor(color);               _panel->writeBlock(getRawColor(), length); }
-    LGFX_INLINE_T void pushBlock       ( const T& color, uint32_t length) { if (0 == length) return; setColor(color); startWrite(); _panel->writeBlock(getRawColor(), length); endWrite(); }
+    LGFX_INLINE   void writeFillRectPreclipped( int32_t x, int32_t y, int32_t w, int32_t h)                 { LGFX_PERF_COUNT(_panel->getPerfCounter()->addFillRect(w * h)); _panel->writeFillRectPreclipped(x, y, w, h, getRawColor()); }
+    LGFX_INLINE_T void writeColor      ( const T& color, uint32_t length) { if (0 == length) return; setColor(color);               LGFX_PERF_COUNT(_panel->getPerfCounter()->addWriteBlock(length)); _panel->writeBlock(getRawColor(), length); }
+    LGFX_INLINE_T void pushBlock       ( const T& color, uint32_t length) { if (0 == length) return; setColor(color); startWrite(); LGFX_PERF_COUNT(_panel->getPerfCounter()->addWriteBlock(length)); _panel->writeBlock(getRawColor(), length); endWrite(); }
 
     /// @brief Draw a pixel.
     /// @param x X-coordinate
     /// @param y Y-coordinate
     /// @note Draws in the color specified by setColor().
-    LGFX_INLINE   void drawPixel       ( int32_t x, int32_t y) { if (x >= _clip_l && x <= _clip_r && y >= _clip_t && y <= _clip_b) { _panel->drawPixelPreclipped(x, y, getRawColor()); } }
+    LGFX_INLINE   void drawPixel       ( int32_t x, int32_t y) { if (x >= _clip_l && x <= _clip_r && y >= _clip_t && y <= _clip_b) { LGFX_PERF_COUNT(_panel->getPerfCounter()->addDrawPixel()); _panel->drawPixelPreclipped(x, y, getRawColor()); } }
     /// @brief Draw a pixel.
     /// @param x X-coordinate
     /// @param y Y-coordinate
@@ -235,6 +238,12 @@ namespace lgfx
                   void drawTriangle    ( int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2);
     LGFX_INLINE_T void fillTriangle    ( int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, const T& color)  { setColor(color); fillTriangle(x0, y0, x1, y1, x2, y2); }
                   void fillTriangle    ( int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2);
+    LGFX_INLINE_T void drawPolygon     ( const point_t* points, size_t count, const T& color)  { setColor(color); drawPolygon(points, count); }
+                  void drawPolygon     ( const point_t* points, size_t count);
+    /// 任意の多角形 (凹形・自己交差を含む) を塗り潰す。左端・上端の画素を含み、右端・下端の画素を含まない;
+    /// Fills an arbitrary (concave / self-intersecting) polygon. Left / top edges are inclusive, right / bottom edges exclusive.
+    LGFX_INLINE_T void fillPolygon     ( const point_t* points, size_t count, const T& color, fill_rule_t rule = fill_nonzero)  { setColor(color); fillPolygon(points, count, rule); }
+                  void fillPolygon     ( const point_t* points, size_t count, fill_rule_t rule = fill_nonzero);
     LGFX_INLINE_T void drawBezier      ( int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, const T& color)  { setColor(color); drawBezier(x0, y0, x1, y1, x2, y2); }
                   void drawBezier      ( int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2);
     LGFX_INLINE_T void drawBezier      ( int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3, const T& color)  { setColor(color); drawBezier(x0, y0, x1, y1, x2, y2, x3, y3); }
@@ -292,6 +301,10 @@ namespace lgfx
 
     LGFX_INLINE_T void fillSmoothRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, const T& color) { setColor(color); fillSmoothRoundRect(x, y, w, h, r); }
                   void fillSmoothRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r);
+    /// アンチエイリアス付きで多角形を塗り潰す。座標は画素の中心を整数とする;
+    /// Fills a polygon with anti-aliasing. Pixel centers are at integer coordinates.
+    LGFX_INLINE_T void fillSmoothPolygon(const pointf_t* points, size_t count, const T& color, fill_rule_t rule = fill_nonzero) { setColor(color); fillSmoothPolygon(points, count, rule); }
+                  void fillSmoothPolygon(const pointf_t* points, size_t count, fill_rule_t rule = fill_nonzero);
 
     LGFX_INLINE_T void fillSmoothCircle(int32_t x, int32_t y, int32_t r, const T& color) { setColor(color); fillSmoothCircle(x, y, r); }
                   void fillSmoothCircle(int32_t x, int32_t y, int32_t r) { fillSmoothRoundRect(x-r, y-r, r*2+1, r*2+1, r); }
@@ -326,18 +339,24 @@ namespace lgfx
     LGFX_INLINE   bool displayBusy(void) { return _panel->displayBusy(); }
     LGFX_INLINE   void setAutoDisplay(bool flg) { _panel->setAutoDisplay(flg); }
     LGFX_INLINE   void initDMA(void) { _panel->initDMA(); }
-    LGFX_INLINE   void waitDMA(void) { _panel->waitDMA(); }
+    LGFX_INLINE   void waitDMA(void) { LGFX_PERF_COUNT(++_panel->getPerfCounter()->wait_dma); _panel->waitDMA(); }
     LGFX_INLINE   bool dmaBusy(void) { return _panel->dmaBusy(); }
 
+    /// @brief Obtains a snapshot of the panel / bus performance counters.
+    /// @return false if LGFX_USE_PERF_COUNTER is not defined.
+                  bool getPerfCounter(perf_counter_t* dst) const;
+    /// @brief Resets the panel / bus performance counters.
+                  void resetPerfCounter(void);
+
     LGFX_INLINE_T void setScrollRect(int32_t x, int32_t y, int32_t w, int32_t h, const T& color) { setBaseColor(color); setScrollRect(x, y, w, h); }
 
-    LGFX_INLINE_T void writePixels(const T*        data, int32_t len           ) { auto pc = create_pc_fast(data      ); _panel->writePixels(&pc, len, false); }
-    LGFX_INLINE   void writePixels(const uint16_t* data, int32_t len, bool swap) { auto pc = create_pc_fast(data, swap); _panel->writePixels(&pc, len, false); }
-    LGFX_INLINE   void writePixels(const void*     data, int32_t len, bool swap) { auto pc = create_pc_fast(data, swap); _panel->writePixels(&pc, len, false); }
+    LGFX_INLINE_T void writePixels(const T*        data, int32_t len           ) { auto pc = create_pc_fast(data      ); LGFX_PERF_COUNT(_panel->getPerfCounter()->addWritePixels(len)); _panel->writePixels(&pc, len, false); }
+    LGFX_INLINE   void writePixels(const uint16_t* data, int32_t len, bool swap) { auto pc = create_pc_fast(data, swap); LGFX_PERF_COUNT(_panel->getPerfCounter()->addWritePixels(len)); _panel->writePixels(&pc, len, false); }
+    LGFX_INLINE   void writePixels(const void*     data, int32_t len, bool swap) { auto pc = create_pc_fast(data, swap); LGFX_PERF_COUNT(_panel->getPerfCounter()->addWritePixels(len)); _panel->writePixels(&pc, len, false); }
 
-    LGFX_INLINE_T void writePixelsDMA(const T*        data, int32_t len           ) { auto pc = create_pc_fast(data      ); _panel->writePixels(&pc, len, true); }
-    LGFX_INLINE   void writePixelsDMA(const uint16_t* data, int32_t len, bool swap) { auto pc = create_pc_fast(data, swap); _panel->writePixels(&pc, len, true); }
-    LGFX_INLINE   void writePixelsDMA(const void*     data, int32_t len, bool swap) { auto pc = create_pc_fast(data, swap); _panel->writePixels(&pc, len, true); }
+    LGFX_INLINE_T void writePixelsDMA(const T*        data, int32_t len           ) { auto pc = create_pc_fast(data      ); LGFX_PERF_COUNT(_panel->getPerfCounter()->addWritePixels(len)); _panel->writePixels(&pc, len, true); }
+    LGFX_INLINE   void writePixelsDMA(const uint16_t* data, int32_t len, bool swap) { auto pc = create_pc_fast(data, swap); LGFX_PERF_COUNT(_panel->getPerfCounter()->addWritePixels(len)); _panel->writePixels(&pc, len, true); }
+    LGFX_INLINE   void writePixelsDMA(const void*     data, int32_t len, bool swap) { auto pc = create_pc_fast(data, swap); LGFX_PERF_COUNT(_panel->getPerfCounter()->addWritePixels(len)); _panel->writePixels(&pc, len, true); }
 
     LGFX_INLINE_T void pushPixels(T*              data, int32_t len           ) { startWrite(); writePixels(data, len      ); endWrite(); }
     LGFX_INLINE   void pushPixels(const uint16_t* data, int32_t len, bool swap) { startWrite(); writePixels(data, len, swap); endWrite(); }
@@ -358,6 +377,7 @@ namespace lgfx
     void fillRectAlpha(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t alpha, const T& color)
     {
       if (!_clipping(x, y, w, h)) return;
+      LGFX_PERF_COUNT(_panel->getPerfCounter()->addFillRect(w * h));
       _panel->writeFillRectAlphaPreclipped(x, y, w, h, convert_to_rgb888(color) | alpha << 24 );
     }
 
@@ -371,7 +391,7 @@ namespace lgfx
     {
       auto src_depth = (color_depth_t)(depth | color_depth_t::has_palette);
       auto pc = create_pc_fast(data, palette, src_depth);
-      _panel->writePixels(&pc, len, false);
+      LGFX_PERF_COUNT(_panel->getPerfCounter()->addWritePixels(len)); _panel->writePixels(&pc, len, false);
     }
 
     /// Obtains the current scanning line position.
@@ -603,6 +623,7 @@ namespace lgfx
       pixelcopy_t p(nullptr, swap565_t::depth, _read_conv.depth, false, getPalette());
       uint16_t data = 0;
 
+      LGFX_PERF_COUNT(_panel->getPerfCounter()->addReadRect(1));
       _panel->readRect(x, y, 1, 1, &data, &p);
 
       return (data<<8)+(data>>8);
@@ -616,6 +637,7 @@ namespace lgfx
 
       pixelcopy_t p(nullptr, bgr888_t::depth, _read_conv.depth, false, getPalette());
 
+      LGFX_PERF_COUNT(_panel->getPerfCounter()->addReadRect(1));
       _panel->readRect(x, y, 1, 1, data, &p);
 
       return data[0];
@@ -823,6 +845,37 @@ namespace lgfx
     /// unload VLW font
     void unloadFont(void);
 
+    /// Keeps up to `glyphs` glyphs of the VLW font in memory (LRU), so that repeated characters do not read the file.
+    /// Applies to the loaded font and to fonts loaded later. 0 = disable.
+    /// @param bytes total size of the cached glyph bitmaps. 0 = unlimited.
+    bool setFontCacheSize(uint16_t glyphs, size_t bytes = 0);
+
+    /// Reads the glyphs of the code range [first, last] of the loaded VLW font into the font cache.
+    /// @return number of glyphs cached.
+    size_t preloadFont(uint16_t first = 0x20, uint16_t last = 0x7E);
+
+    /// drawString の描画結果を最大 `bytes` バイトまで保持し、同じ文字列の再描画を1回の pushImage にする。;
+    /// Keeps the rendered results of drawString up to `bytes` (LRU), so that redrawing the same text is a single pushImage.
+    /// The text, font, colors, size, padding and datum must all match. 0 = disable.
+    void setStringCacheSize(size_t bytes);
+
+    void clearStringCache(void) { if (_string_cache) { _string_cache->clear(); } }
+
+    /// @return nullptr if the string cache is disabled.
+    const LGFX_StringCache* getStringCache(void) const { return _string_cache.get(); }
+
+    /// drawBmp / drawJpg / drawPng / drawQoi (メモリまたはファイル) のデコード結果を最大 `bytes` バイトまで保持する。;
+    /// Keeps the decoded images of drawBmp / drawJpg / drawPng / drawQoi (from memory or a file) up to `bytes` (LRU),
+    /// so that redrawing the same image at the same scale is a single pushImage. 0 = disable.
+    /// @param psram place the images in PSRAM when it is available.
+    void setImageCacheSize(size_t bytes, bool psram = true);
+
+    /// 画像のファイルやデータを書き換えた場合に呼ぶ。; Call this when the image files or data are modified.
+    void clearImageCache(void) { if (_image_cache) { _image_cache->clear(); } }
+
+    /// @return nullptr if the image cache is disabled.
+    const LGFX_ImageCache* getImageCache(void) const { return _image_cache.get(); }
+
     /// show VLW font
     void showFont(uint32_t td = 2000);
 
@@ -909,7 +962,7 @@ namespace lgfx
 #endif
     void qrcode(const char *string, int32_t x = -1, int32_t y = -1, int32_t width = -1, uint8_t version = 1);
 
-  #define LGFX_FUNCTION_GENERATOR(drawImg, draw_img) \
+  #define LGFX_FUNCTION_GENERATOR(drawImg, draw_img, image_format) \
    protected: \
     bool draw_img(DataWrapper* data, int32_t x, int32_t y, int32_t maxWidth, int32_t maxHeight, int32_t offX, int32_t offY, float scale_x, float scale_y, datum_t datum); \
    public: \
@@ -917,6 +970,8 @@ namespace lgfx
     { \
       PointerWrapper data_wrapper; \
       data_wrapper.set(data, len); \
+      bool res; \
+      if (_image_cache && _image_cache->draw(this, LGFX_ImageCache::image_format, &data_wrapper, nullptr, data, len, x, y, maxWidth, maxHeight, offX, offY, scale_x, scale_y, datum, &res)) { return res; } \
       return this->draw_img(&data_wrapper, x, y, maxWidth, maxHeight, offX, offY, scale_x, scale_y, datum); \
     } \
     inline bool drawImg(DataWrapper *data, int32_t x=0, int32_t y=0, int32_t maxWidth=0, int32_t maxHeight=0, int32_t offX=0, int32_t offY=0, float scale_x = 1.0f, float scale_y = 0.0f, datum_t datum = datum_t::top_left) \
@@ -927,6 +982,7 @@ namespace lgfx
     { \
       bool res = false; \
       this->prepareTmpTransaction(file); \
+      if (_image_cache && _image_cache->draw(this, LGFX_ImageCache::image_format, file, path, nullptr, 0, x, y, maxWidth, maxHeight, offX, offY, scale_x, scale_y, datum, &res)) { return res; } \
       file->preRead(); \
       if (file->open(path)) \
       { \
@@ -952,10 +1008,10 @@ namespace lgfx
       return res; \
     }
 
-    LGFX_FUNCTION_GENERATOR(drawBmp, draw_bmp)
-    LGFX_FUNCTION_GENERATOR(drawJpg, draw_jpg)
-    LGFX_FUNCTION_GENERATOR(drawPng, draw_png)
-    LGFX_FUNCTION_GENERATOR(drawQoi, draw_qoi)
+    LGFX_FUNCTION_GENERATOR(drawBmp, draw_bmp, format_bmp)
+    LGFX_FUNCTION_GENERATOR(drawJpg, draw_jpg, format_jpg)
+    LGFX_FUNCTION_GENERATOR(drawPng, draw_png, format_png)
+    LGFX_FUNCTION_GENERATOR(drawQoi, draw_qoi, format_qoi)
 
   #undef LGFX_FUNCTION_GENERATOR
 
@@ -975,15 +1031,42 @@ namespace lgfx
 
     void* createPng( size_t* datalen, int32_t x = 0, int32_t y = 0, int32_t width = 0, int32_t height = 0);
 
+    /// エンコードした画像を少しずつ受取るコールバック。falseを返すと中断する。;
+    /// Receives the encoded image piece by piece. return false to abort.
+    typedef bool (*image_writer_t)(void* user, const uint8_t* data, uint32_t len);
+
+    /// 指定範囲をPNG形式で writer へ出力する。ファイル全体をメモリに保持しない。;
+    /// Encodes the area as PNG and passes it to writer, without holding the whole file in memory.
+    /// @param level compression level 0~10. (0 = stored)
+    bool createPng( image_writer_t writer, void* user, int32_t x = 0, int32_t y = 0, int32_t width = 0, int32_t height = 0, uint8_t level = 6);
+
+    /// 指定範囲をQOI形式で writer へ出力する。;
+    /// Encodes the area as QOI and passes it to writer.
+    bool createQoi( image_writer_t writer, void* user, int32_t x = 0, int32_t y = 0, int32_t width = 0, int32_t height = 0);
+
+    /// write(const uint8_t*, size_t) を持つファイルやストリームへ出力する。(fs::File , Stream 等);
+    /// Writes to a file or stream having write(const uint8_t*, size_t). (fs::File, Stream etc.)
+    template <typename T>
+    bool createPng( T& dst, int32_t x = 0, int32_t y = 0, int32_t width = 0, int32_t height = 0, uint8_t level = 6)
+    {
+      return createPng(write_to<T>, &dst, x, y, width, height, level);
+    }
+
+    template <typename T>
+    bool createQoi( T& dst, int32_t x = 0, int32_t y = 0, int32_t width = 0, int32_t height = 0)
+    {
+      return createQoi(write_to<T>, &dst, x, y, width, height);
+    }
+
     void releasePngMemory(void);
 
     template<typename T>
     [[deprecated("use pushImage")]] void pushRect( int32_t x, int32_t y, int32_t w, int32_t h, const T* data) { pushImage(x, y, w, h, data); }
 
     template<typename T>
-    [[deprecated("use pushBlock")]] void pushColor(const T& color, uint32_t length) { if (0 != length) { setColor(color); startWrite(); _panel->writeBlock(getRawColor(), length); endWrite(); } }
+    [[deprecated("use pushBlock")]] void pushColor(const T& color, uint32_t length) { if (0 != length) { setColor(color); startWrite(); LGFX_PERF_COUNT(_panel->getPerfCounter()->addWriteBlock(length)); _panel->writeBlock(getRawColor(), length); endWrite(); } }
     template<typename T>
-    [[deprecated("use pushBlock")]] void pushColor(const T& color                     ) {                     setColor(color); startWrite(); _panel->writeBlock(getRawColor(), 1);      endWrite(); }
+    [[deprecated("use pushBlock")]] void pushColor(const T& color                     ) {                     setColor(color); startWrite(); LGFX_PERF_COUNT(_panel->getPerfCounter()->addWriteBlock(1)); _panel->writeBlock(getRawColor(), 1);      endWrite(); }
 
     template<typename T>
     [[deprecated("use pushPixels")]] void pushColors(T*              data, int32_t len           ) { startWrite(); writePixels(data, len            ); endWrite(); }
@@ -1037,6 +1120,10 @@ namespace lgfx
     std::shared_ptr<RunTimeFont> _runtime_font;  // run-time generated font
     std::shared_ptr<DataWrapper> _font_file;  // run-time font file
     PointerWrapper _font_data;
+    size_t _font_cache_bytes = 0;
+    uint16_t _font_cache_glyphs = 0;
+    std::shared_ptr<LGFX_StringCache> _string_cache;  // drawString result cache
+    std::shared_ptr<LGFX_ImageCache> _image_cache;  // decoded image cache
 
     std::shared_ptr<DataWrapperFactory> _data_wrapper_factory;
     DataWrapper* _create_data_wrapper(void) { if (nullptr == _data_wrapper_factory.get()) { clearFileStorage(); } return _data_wrapper_factory->create(); }
@@ -1046,6 +1133,12 @@ namespace lgfx
     bool _textscroll = false;
 
     LGFX_INLINE static bool _adjust_abs(int32_t& x, int32_t& w) { if (w < 0) { x += w; w = -w; } return !w; }
+
+    template <typename T>
+    static bool write_to(void* dst, const uint8_t* data, uint32_t len) { return static_cast<T*>(dst)->write(data, len) == len; }
+
+    /// area of createPng / createQoi. width or height 0 = to the edge.
+    bool _adjust_capture(int32_t& x, int32_t& y, int32_t& w, int32_t& h);
     static bool _adjust_width(int32_t& x, int32_t& dx, int32_t& dw, int32_t left, int32_t width)
     {
       if (x < left) { dx = -x; dw += x; x = left; }
@@ -1358,6 +1451,10 @@ namespace lgfx
     void push_image_affine_aa(const float* matrix, int32_t w, int32_t h, pixelcopy_t *pc);
     void push_image_affine_aa(const float* matrix, pixelcopy_t *pre_pc, pixelcopy_t *post_pc);
 
+    /// load_palette : パレットを持つPNGをインデックスのまま描画した場合、PNGのパレットを描画先へ複製する。;
+    /// load_palette : when an indexed PNG is written as palette indices, copies its palette to the destination. (see LGFX_Sprite::createFromPng)
+    bool draw_png_impl(DataWrapper* data, int32_t x, int32_t y, int32_t maxWidth, int32_t maxHeight, int32_t offX, int32_t offY, float zoom_x, float zoom_y, datum_t datum, bool load_palette);
+
     uint16_t decodeUTF8(uint8_t c);
 
     size_t printNumber(unsigned long n, uint8_t base);
@@ -0,0 +1,170 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [FreeBSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+
+#include "LGFX_BandRenderer.hpp"
+
+#include "platforms/common.hpp"
+
+#include <string.h>
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  bool LGFX_BandRenderer::init(LovyanGFX* dst, int32_t band_height, bool double_buffer, bool psram)
+  {
+    release();
+    if (dst == nullptr) return false;
+
+    int32_t w = dst->width();
+    int32_t h = dst->height();
+    if (w < 1 || h < 1 || band_height < 1) return false;
+    if (band_height > h) band_height = h;
+
+    _strip_count = double_buffer ? 2 : 1;
+    for (size_t i = 0; i < _strip_count; ++i)
+    {
+      _strip[i].setPsram(psram);
+      _strip[i].setColorDepth(dst->getColorDepth());
+      if (!_strip[i].createSprite(w, band_height))
+      {
+        if (i == 0)
+        {
+          release();
+          return false;
+        }
+        _strip_count = 1;  // fall back to a single strip.
+        break;
+      }
+      if (dst->hasPalette() && _strip[i].hasPalette())
+      {
+        memcpy(_strip[i].getPalette(), dst->getPalette(), std::min(dst->getPaletteCount(), _strip[i].getPaletteCount()) * sizeof(RGBColor));
+      }
+    }
+
+    _band_count = (h + band_height - 1) / band_height;
+    _band_info = (band_info_t*)heap_alloc(_band_count * sizeof(band_info_t));
+    if (_band_info == nullptr)
+    {
+      release();
+      return false;
+    }
+    memset(_band_info, 0, _band_count * sizeof(band_info_t));
+
+    _list.setPsram(psram);
+    _list.setColorDepth(dst->getColorDepth());
+    _dst = dst;
+    _band_height = band_height;
+    return true;
+  }
+
+  void LGFX_BandRenderer::release(void)
+  {
+    _strip[0].deleteSprite();
+    _strip[1].deleteSprite();
+    _list.deleteList();
+    if (_band_info) { heap_free(_band_info); }
+    _band_info = nullptr;
+    _band_count = 0;
+    _strip_count = 0;
+    _dst = nullptr;
+  }
+
+  void LGFX_BandRenderer::render_impl(draw_band_t draw_band, const void* context)
+  {
+    auto dst = _dst;
+    if (dst == nullptr) return;
+
+    int32_t w = dst->width();
+    int32_t h = dst->height();
+    uint32_t total = micros();
+
+    dst->startWrite();
+    for (uint32_t i = 0; i < _band_count; ++i)
+    {
+      auto strip = &_strip[i % _strip_count];
+      int32_t by = i * _band_height;
+      int32_t bh = std::min(_band_height, h - by);
+
+      uint32_t t = micros();
+      // a single strip is still being sent as the previous band.
+      if (_strip_count == 1) { dst->waitDMA(); }
+      uint32_t t1 = micros();
+      strip->setClipRect(0, 0, w, bh);
+      strip->setBaseColor(dst->getBaseColor());
+      strip->clear();
+      draw_band(this, strip, by, bh, context);
+      uint32_t t2 = micros();
+
+      // with two strips, the previous band is sent from the other one while this band is drawn.
+      dst->waitDMA();
+      uint32_t t3 = micros();
+      dst->pushImageDMA(0, by, w, bh, strip->getBuffer(), strip->getColorDepth(), strip->getPalette());
+      uint32_t t4 = micros();
+
+      auto info = &_band_info[i];
+      info->y = by;
+      info->h = bh;
+      info->render_us = t2 - t1;
+      info->wait_us = (t1 - t) + (t3 - t2);
+      info->push_us = t4 - t3;
+    }
+    dst->endWrite();
+    dst->waitDMA();
+
+    _total_us = micros() - total;
+  }
+
+  void LGFX_BandRenderer::render(scene_cb_t scene, void* user_data)
+  {
+    if (_dst == nullptr || scene == nullptr) return;
+    if (_list.width() != _dst->width() || _list.height() != _dst->height())
+    {
+      if (!_list.createList(_dst->width(), _dst->height())) return;
+    }
+
+    struct context_t { scene_cb_t scene; void* user_data; } ctx = { scene, user_data };
+    render_impl([](LGFX_BandRenderer* self, LGFX_Sprite* strip, int32_t y, int32_t h, const void* context)
+    {
+      auto c = (const context_t*)context;
+      auto list = &self->_list;
+      list->clearList();
+      list->setClipRect(0, y, list->width(), h);
+      c->scene(list, c->user_data);
+      list->replay(strip, 0, -y);
+    }, &ctx);
+    _list.clearList();
+  }
+
+  void LGFX_BandRenderer::render(const LGFX_DisplayList* list, int32_t x, int32_t y)
+  {
+    if (list == nullptr) return;
+
+    struct context_t { const LGFX_DisplayList* list; int32_t x; int32_t y; } ctx = { list, x, y };
+    render_impl([](LGFX_BandRenderer*, LGFX_Sprite* strip, int32_t y, int32_t, const void* context)
+    {
+      auto c = (const context_t*)context;
+      c->list->replay(strip, c->x, c->y - y);
+    }, &ctx);
+  }
+
+//----------------------------------------------------------------------------
+ }
+}
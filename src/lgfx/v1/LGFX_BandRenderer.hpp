@@ -0,0 +1,90 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [FreeBSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+#pragma once
+
+#include "LGFX_Sprite.hpp"
+#include "LGFX_DisplayList.hpp"
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  /// Renders a full screen through a small strip sprite, one band of lines at a time.
+  /// With two strips, a band is pushed by DMA while the next one is rendered.
+  class LGFX_BandRenderer
+  {
+  public:
+    struct band_info_t
+    {
+      int32_t y;
+      int32_t h;
+      uint32_t render_us;  // time spent drawing into the strip
+      uint32_t wait_us;    // time spent waiting for the transfer of the previous band
+      uint32_t push_us;    // time spent sending the strip to the target
+    };
+
+    /// Draws the scene in target coordinates. Called once per band with the clip rect set to that band,
+    /// so it must not depend on state left by the previous call (e.g. the text cursor).
+    typedef void (*scene_cb_t)(LovyanGFX* gfx, void* user_data);
+
+    LGFX_BandRenderer(void) = default;
+    ~LGFX_BandRenderer(void) { release(); }
+
+    /// @param dst target to render onto.
+    /// @param band_height number of lines per band.
+    /// @param double_buffer use two strips so rendering overlaps the DMA transfer.
+    bool init(LovyanGFX* dst, int32_t band_height, bool double_buffer = true, bool psram = false);
+    void release(void);
+
+    /// Renders a scene drawn by a callback. The drawing calls are recorded per band,
+    /// so primitives outside the band are dropped by the usual clipping.
+    void render(scene_cb_t scene, void* user_data = nullptr);
+
+    /// Replays a recorded list offset by (x, y). Commands outside each band are skipped.
+    void render(const LGFX_DisplayList* list, int32_t x = 0, int32_t y = 0);
+
+    LovyanGFX* getTarget(void) const { return _dst; }
+    int32_t getBandHeight(void) const { return _band_height; }
+    uint32_t getBandCount(void) const { return _band_count; }
+    const band_info_t* getBandInfo(uint32_t index) const { return (index < _band_count) ? &_band_info[index] : nullptr; }
+
+    /// total time of the last render() call.
+    uint32_t getRenderTime(void) const { return _total_us; }
+
+  protected:
+    typedef void (*draw_band_t)(LGFX_BandRenderer* self, LGFX_Sprite* strip, int32_t y, int32_t h, const void* context);
+
+    void render_impl(draw_band_t draw_band, const void* context);
+
+    LovyanGFX* _dst = nullptr;
+    LGFX_Sprite _strip[2];
+    LGFX_DisplayList _list;
+    band_info_t* _band_info = nullptr;
+    int32_t _band_height = 0;
+    uint32_t _band_count = 0;
+    uint32_t _total_us = 0;
+    uint8_t _strip_count = 0;
+  };
+
+//----------------------------------------------------------------------------
+ }
+}
+
+using LGFX_BandRenderer = lgfx::LGFX_BandRenderer;
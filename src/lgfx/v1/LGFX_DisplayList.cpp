@@ -0,0 +1,438 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [FreeBSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+
+#include "LGFX_DisplayList.hpp"
+
+#include "platforms/common.hpp"
+#include "../internal/alloca.h"
+
+#include <string.h>
+
+#ifdef min
+#undef min
+#endif
+#ifdef max
+#undef max
+#endif
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  static constexpr size_t command_size = sizeof(Panel_DisplayList::command_t);
+
+  static inline uint32_t read_raw(const uint8_t* src, uint_fast8_t bytes)
+  {
+    uint32_t raw = src[0];
+    if (bytes > 1) { raw |= src[1] << 8; }
+    if (bytes > 2) { raw |= src[2] << 16; }
+    return raw;
+  }
+
+  color_depth_t Panel_DisplayList::setColorDepth(color_depth_t depth)
+  {
+    switch (depth)
+    {
+    case rgb565_2Byte:
+    case rgb332_1Byte:
+    case rgb888_3Byte:
+    case grayscale_8bit:
+      break;
+
+    case argb8888_4Byte:
+    case rgb666_3Byte:
+      depth = rgb888_3Byte;
+      break;
+
+    default:
+      depth = ((depth & color_depth_t::bit_mask) >= 8) ? rgb565_2Byte
+            : (depth & color_depth_t::has_palette)     ? rgb332_1Byte
+                                                       : grayscale_8bit;
+      break;
+    }
+    _write_depth = depth;
+    _read_depth = depth;
+    return depth;
+  }
+
+  bool Panel_DisplayList::createList(int32_t w, int32_t h)
+  {
+    if (w < 1 || h < 1 || w > UINT16_MAX || h > UINT16_MAX) return false;
+    clearList();
+    _width = w;
+    _height = h;
+    _xs = _xpos = 0;
+    _ys = _ypos = 0;
+    _xe = w - 1;
+    _ye = h - 1;
+    return true;
+  }
+
+  void Panel_DisplayList::deleteList(void)
+  {
+    if (_buffer) { heap_free(_buffer); }
+    _buffer = nullptr;
+    _capacity = 0;
+    _width = _height = 0;
+    clearList();
+  }
+
+  void Panel_DisplayList::clearList(void)
+  {
+    _length = 0;
+    _command_count = 0;
+    _overflow = false;
+    _bound_l = _bound_t = INT32_MAX;
+    _bound_r = _bound_b = -1;
+  }
+
+  uint8_t* Panel_DisplayList::_add_command(command_id_t id, uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t param, size_t payload)
+  {
+    payload = (payload + 3) & ~3u;
+    size_t need = _length + command_size + payload;
+    if (need > _capacity)
+    {
+      size_t cap = _capacity ? _capacity : 256;
+      while (cap < need) { cap <<= 1; }
+      auto buf = (uint8_t*)(_psram ? heap_alloc_psram(cap) : heap_alloc(cap));
+      if (buf == nullptr && cap != need)
+      {
+        cap = need;
+        buf = (uint8_t*)(_psram ? heap_alloc_psram(cap) : heap_alloc(cap));
+      }
+      if (buf == nullptr)
+      {
+        _overflow = true;
+        return nullptr;
+      }
+      if (_buffer)
+      {
+        memcpy(buf, _buffer, _length);
+        heap_free(_buffer);
+      }
+      _buffer = buf;
+      _capacity = cap;
+    }
+
+    auto cmd = (command_t*)&_buffer[_length];
+    cmd->id = id;
+    cmd->x = x;
+    cmd->y = y;
+    cmd->w = w;
+    cmd->h = h;
+    cmd->reserved = 0;
+    cmd->param = param;
+    _length = need;
+    ++_command_count;
+
+    if (id != cmd_copy_rect)
+    {
+      if (_bound_l > (int32_t)x) _bound_l = x;
+      if (_bound_t > (int32_t)y) _bound_t = y;
+      if (_bound_r < (int32_t)(x + w - 1)) _bound_r = x + w - 1;
+      if (_bound_b < (int32_t)(y + h - 1)) _bound_b = y + h - 1;
+    }
+    else
+    { // the copied area depends on the destination contents.
+      _bound_l = _bound_t = 0;
+      _bound_r = _bound_b = INT16_MAX;
+    }
+    return (uint8_t*)&cmd[1];
+  }
+
+  void Panel_DisplayList::setWindow(uint_fast16_t xs, uint_fast16_t ys, uint_fast16_t xe, uint_fast16_t ye)
+  {
+    xs = std::min<uint_fast16_t>(_width  - 1, xs);
+    xe = std::min<uint_fast16_t>(_width  - 1, xe);
+    ys = std::min<uint_fast16_t>(_height - 1, ys);
+    ye = std::min<uint_fast16_t>(_height - 1, ye);
+    _xpos = xs;
+    _xs = xs;
+    _xe = xe;
+    _ypos = ys;
+    _ys = ys;
+    _ye = ye;
+  }
+
+  void Panel_DisplayList::drawPixelPreclipped(uint_fast16_t x, uint_fast16_t y, uint32_t rawcolor)
+  {
+    _add_command(cmd_fill_rect, x, y, 1, 1, rawcolor);
+  }
+
+  void Panel_DisplayList::writeFillRectPreclipped(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t rawcolor)
+  {
+    _add_command(cmd_fill_rect, x, y, w, h, rawcolor);
+  }
+
+  void Panel_DisplayList::writeFillRectAlphaPreclipped(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t argb8888)
+  {
+    if ((argb8888 >> 24) == 0) return;
+    _add_command(cmd_fill_alpha, x, y, w, h, argb8888);
+  }
+
+  void Panel_DisplayList::writeBlock(uint32_t rawcolor, uint32_t length)
+  {
+    do
+    {
+      uint32_t h = 1;
+      auto w = std::min<uint32_t>(length, _xe + 1 - _xpos);
+      if (length >= (w << 1) && _xpos == _xs)
+      {
+        h = std::min<uint32_t>(length / w, _ye + 1 - _ypos);
+      }
+      writeFillRectPreclipped(_xpos, _ypos, w, h, rawcolor);
+      if ((_xpos += w) <= _xe) return;
+      _xpos = _xs;
+      if (_ye < (_ypos += h)) { _ypos = _ys; }
+      length -= w * h;
+    } while (length);
+  }
+
+  void Panel_DisplayList::writePixels(pixelcopy_t* param, uint32_t length, bool use_dma)
+  {
+    (void)use_dma;
+    const size_t bytes = _write_bits >> 3;
+    uint32_t linelength;
+    do
+    {
+      linelength = std::min<uint32_t>(_xe - _xpos + 1, length);
+      auto dst = _add_command(cmd_image, _xpos, _ypos, linelength, 1, 0, linelength * bytes);
+      if (dst == nullptr) return;
+      param->fp_copy(dst, 0, linelength, param);
+      if ((_xpos += linelength) > _xe)
+      {
+        _xpos = _xs;
+        _ypos = (_ypos != _ye) ? (_ypos + 1) : _ys;
+      }
+    } while (length -= linelength);
+  }
+
+  void Panel_DisplayList::writeImage(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param, bool)
+  {
+    const size_t bytes = _write_bits >> 3;
+    uint32_t sx32 = param->src_x32;
+    uint32_t sy32 = param->src_y32;
+    uint32_t nexty = 1 << pixelcopy_t::FP_SCALE;
+
+    if (param->transp == pixelcopy_t::NON_TRANSP)
+    { // the whole rectangle is stored as one command.
+      auto dst = _add_command(cmd_image, x, y, w, h, 0, w * h * bytes);
+      if (dst == nullptr) return;
+      do
+      {
+        param->fp_copy(dst, 0, w, param);
+        dst += w * bytes;
+        param->src_x32 = sx32;
+        param->src_y32 = (sy32 += nexty);
+      } while (--h);
+      return;
+    }
+
+    auto buf = (uint8_t*)alloca(w * bytes);
+    h += y;
+    do
+    { // each opaque run becomes its own command.
+      uint32_t pos = 0;
+      for (;;)
+      {
+        uint32_t start = pos;
+        pos = param->fp_copy(buf, pos, w, param);
+        if (start != pos)
+        {
+          auto dst = _add_command(cmd_image, x + start, y, pos - start, 1, 0, (pos - start) * bytes);
+          if (dst == nullptr) return;
+          memcpy(dst, &buf[start * bytes], (pos - start) * bytes);
+        }
+        if (pos == w) break;
+        pos = param->fp_skip(pos, w, param);
+        if (pos == w) break;
+      }
+      param->src_x32 = sx32;
+      param->src_y32 = (sy32 += nexty);
+    } while (++y < h);
+  }
+
+  void Panel_DisplayList::writeImageARGB(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param)
+  {
+    // The blend functions only output the composited result, so each line is
+    // blended onto black and onto white and the alpha is recovered from the difference.
+    // Semi-transparent pixels lose some precision at depths below RGB888.
+    const size_t bytes = _write_bits >> 3;
+    auto dst = (argb8888_t*)_add_command(cmd_image_argb, x, y, w, h, 0, w * h * sizeof(argb8888_t));
+    if (dst == nullptr) return;
+
+    auto lo = (uint8_t*)alloca(w * bytes);
+    auto hi = (uint8_t*)alloca(w * bytes);
+    color_conv_t conv(_write_depth);
+    uint32_t sx32 = param->src_x32;
+    uint32_t sy32 = param->src_y32;
+    do
+    {
+      memset(lo, 0x00, w * bytes);
+      memset(hi, 0xFF, w * bytes);
+      param->fp_copy(lo, 0, w, param);
+      param->src_x32 = sx32;
+      param->src_y32 = sy32;
+      param->fp_copy(hi, 0, w, param);
+
+      for (size_t i = 0; i < w; ++i)
+      {
+        uint32_t b = conv.revert_rgb888(read_raw(&lo[i * bytes], bytes));
+        uint32_t t = conv.revert_rgb888(read_raw(&hi[i * bytes], bytes));
+        int32_t diff = 0;
+        for (int shift = 0; shift < 24; shift += 8)
+        {
+          diff = std::max<int32_t>(diff, (int32_t)((t >> shift) & 0xFF) - (int32_t)((b >> shift) & 0xFF));
+        }
+        uint32_t a = 255 - diff;
+        argb8888_t c;
+        c.raw = 0;
+        if (a == 255)
+        {
+          c.raw = b | 0xFF000000u;
+        }
+        else if (a)
+        {
+          c.a = a;
+          c.r = std::min<uint32_t>(255, (((b >> 16) & 0xFF) * 255 + (a >> 1)) / a);
+          c.g = std::min<uint32_t>(255, (((b >>  8) & 0xFF) * 255 + (a >> 1)) / a);
+          c.b = std::min<uint32_t>(255, (( b        & 0xFF) * 255 + (a >> 1)) / a);
+        }
+        dst[i] = c;
+      }
+      dst += w;
+      param->src_x32 = sx32;
+      param->src_y32 = (sy32 += 1 << pixelcopy_t::FP_SCALE);
+    } while (--h);
+  }
+
+  void Panel_DisplayList::readRect(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, void* dst, pixelcopy_t* param)
+  {
+    (void)x;
+    (void)y;
+    memset(dst, 0, (w * h * param->dst_bits + 7) >> 3);
+  }
+
+  void Panel_DisplayList::copyRect(uint_fast16_t dst_x, uint_fast16_t dst_y, uint_fast16_t w, uint_fast16_t h, uint_fast16_t src_x, uint_fast16_t src_y)
+  {
+    _add_command(cmd_copy_rect, dst_x, dst_y, w, h, src_x | src_y << 16);
+  }
+
+//----------------------------------------------------------------------------
+
+  void Panel_DisplayList::replay(LGFXBase* dst, int32_t x, int32_t y) const
+  {
+    if (_command_count == 0) return;
+
+    int32_t cl, ct, cw, ch;
+    dst->getClipRect(&cl, &ct, &cw, &ch);
+    int32_t cr = cl + cw - 1;
+    int32_t cb = ct + ch - 1;
+
+    if (_bound_l + x > cr || _bound_r + x < cl
+     || _bound_t + y > cb || _bound_b + y < ct) return;
+
+    auto dst_conv = dst->getColorConverter();
+    bool raw_copy = (dst_conv->depth == _write_depth);
+    auto revert = color_conv_t(_write_depth).revert_rgb888;
+    const size_t bytes = _write_bits >> 3;
+    uint32_t last_color = ~0u;
+    // the fills change the drawing color of the target, which is given back at the end.
+    uint32_t raw_color = dst->getRawColor();
+
+    dst->startWrite();
+    const uint8_t* ptr = _buffer;
+    const uint8_t* end = &_buffer[_length];
+    while (ptr < end)
+    {
+      auto cmd = (const command_t*)ptr;
+      auto data = (const uint8_t*)&cmd[1];
+      int32_t w = cmd->w;
+      int32_t h = cmd->h;
+      ptr = data;
+      if (cmd->id == cmd_image)
+      {
+        ptr += (w * h * bytes + 3) & ~3u;
+      }
+      else if (cmd->id == cmd_image_argb)
+      {
+        ptr += w * h * sizeof(argb8888_t);
+      }
+
+      int32_t dx = cmd->x + x;
+      int32_t dy = cmd->y + y;
+
+      if (cmd->id == cmd_copy_rect)
+      {
+        dst->copyRect(dx, dy, w, h, (int32_t)(cmd->param & 0xFFFF) + x, (int32_t)(cmd->param >> 16) + y);
+        continue;
+      }
+
+      if (dx > cr || dx + w <= cl || dy > cb || dy + h <= ct) continue;
+
+      switch (cmd->id)
+      {
+      case cmd_fill_rect:
+        if (last_color != cmd->param)
+        {
+          last_color = cmd->param;
+          if (raw_copy) { dst->setRawColor(last_color); }
+          else          { dst->setColor(revert(last_color)); }
+        }
+        if (dx >= cl && dy >= ct && dx + w - 1 <= cr && dy + h - 1 <= cb)
+        {
+          dst->writeFillRectPreclipped(dx, dy, w, h);
+        }
+        else
+        {
+          dst->writeFillRect(dx, dy, w, h);
+        }
+        break;
+
+      case cmd_fill_alpha:
+        dst->fillRectAlpha(dx, dy, w, h, cmd->param >> 24, cmd->param & 0xFFFFFF);
+        break;
+
+      case cmd_image:
+        switch (_write_depth)
+        {
+        case rgb565_2Byte:   dst->pushImage(dx, dy, w, h, (const swap565_t*  )data); break;
+        case rgb332_1Byte:   dst->pushImage(dx, dy, w, h, (const rgb332_t*   )data); break;
+        case rgb888_3Byte:   dst->pushImage(dx, dy, w, h, (const bgr888_t*   )data); break;
+        case grayscale_8bit: dst->pushImage(dx, dy, w, h, (const grayscale_t*)data); break;
+        default: break;
+        }
+        break;
+
+      case cmd_image_argb:
+        dst->pushAlphaImage(dx, dy, w, h, (const argb8888_t*)data);
+        break;
+
+      default:
+        break;
+      }
+    }
+    dst->setRawColor(raw_color);
+    dst->endWrite();
+  }
+
+//----------------------------------------------------------------------------
+ }
+}
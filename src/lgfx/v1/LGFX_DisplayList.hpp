@@ -0,0 +1,195 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [FreeBSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+#pragma once
+
+#include "LGFXBase.hpp"
+#include "Panel.hpp"
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+  class LGFX_DisplayList;
+
+  /// Recording panel. Stores the preclipped output of LGFXBase as a command list
+  /// instead of pixels. Colors are kept as raw values of the list color depth.
+  struct Panel_DisplayList : public IPanel
+  {
+    friend LGFX_DisplayList;
+
+    enum command_id_t : uint16_t
+    {
+      cmd_fill_rect,   // param = rawcolor
+      cmd_fill_alpha,  // param = argb8888
+      cmd_image,       // payload = w * h pixels of the list color depth
+      cmd_image_argb,  // payload = w * h argb8888_t
+      cmd_copy_rect,   // param = src_x | src_y << 16
+    };
+
+    struct command_t
+    {
+      uint16_t id;
+      uint16_t x;
+      uint16_t y;
+      uint16_t w;
+      uint16_t h;
+      uint16_t reserved;
+      uint32_t param;
+    };
+
+    Panel_DisplayList(void) { _start_count = INT32_MAX; }
+    virtual ~Panel_DisplayList(void) { deleteList(); }
+
+    void beginTransaction(void) override {}
+    void endTransaction(void) override {}
+    void setInvert(bool) override {}
+    void setSleep(bool) override {}
+    void setPowerSave(bool) override {}
+    void writeCommand(uint32_t, uint_fast8_t) override {}
+    void writeData(uint32_t, uint_fast8_t) override {}
+    void initDMA(void) override {}
+    void waitDMA(void) override {}
+    bool dmaBusy(void) override { return false; }
+    void waitDisplay(void) override {}
+    bool displayBusy(void) override { return false; }
+    void display(uint_fast16_t, uint_fast16_t, uint_fast16_t, uint_fast16_t) override {}
+    bool isReadable(void) const override { return false; }
+    bool isBusShared(void) const override { return false; }
+
+    uint32_t readCommand(uint_fast16_t, uint_fast8_t, uint_fast8_t) override { return 0; }
+    uint32_t readData(uint_fast8_t, uint_fast8_t) override { return 0; }
+
+    color_depth_t setColorDepth(color_depth_t depth) override;
+    void setRotation(uint_fast8_t) override {}
+
+    void setWindow(uint_fast16_t xs, uint_fast16_t ys, uint_fast16_t xe, uint_fast16_t ye) override;
+    void drawPixelPreclipped(uint_fast16_t x, uint_fast16_t y, uint32_t rawcolor) override;
+    void writeFillRectPreclipped(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t rawcolor) override;
+    void writeFillRectAlphaPreclipped(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t argb8888) override;
+    void writeBlock(uint32_t rawcolor, uint32_t len) override;
+    void writePixels(pixelcopy_t* param, uint32_t len, bool use_dma) override;
+    void writeImage(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param, bool use_dma) override;
+    void writeImageARGB(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param) override;
+
+    void readRect(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, void* dst, pixelcopy_t* param) override;
+    void copyRect(uint_fast16_t dst_x, uint_fast16_t dst_y, uint_fast16_t w, uint_fast16_t h, uint_fast16_t src_x, uint_fast16_t src_y) override;
+
+    bool createList(int32_t w, int32_t h);
+    void deleteList(void);
+    void clearList(void);
+
+    /// Replays the recorded commands onto dst, offset by (x, y).
+    void replay(LGFXBase* dst, int32_t x, int32_t y) const;
+
+    const uint8_t* getBuffer(void) const { return _buffer; }
+    size_t getLength(void) const { return _length; }
+    uint32_t getCommandCount(void) const { return _command_count; }
+    bool isOverflow(void) const { return _overflow; }
+
+  protected:
+    uint8_t* _add_command(command_id_t id, uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t param, size_t payload = 0);
+
+    uint8_t* _buffer = nullptr;
+    size_t _length = 0;
+    size_t _capacity = 0;
+    uint32_t _command_count = 0;
+
+    uint_fast16_t _xpos = 0;
+    uint_fast16_t _ypos = 0;
+
+    // bounding box of the recorded commands.
+    int32_t _bound_l = INT32_MAX;
+    int32_t _bound_t = INT32_MAX;
+    int32_t _bound_r = -1;
+    int32_t _bound_b = -1;
+
+    bool _psram = false;
+    bool _overflow = false;
+  };
+
+//----------------------------------------------------------------------------
+
+  /// Drawing target that records instead of rendering.
+  /// A screen built once can be replayed onto any LovyanGFX / LGFX_Sprite
+  /// without repeating the clipping, color conversion and setWindow work.
+  class LGFX_DisplayList : public LovyanGFX
+  {
+  public:
+
+    LGFX_DisplayList(void)
+    : LovyanGFX()
+    {
+      _panel = &_panel_list;
+      setColorDepth(_write_conv.depth);
+    }
+
+    virtual ~LGFX_DisplayList(void) { deleteList(); }
+
+    /// @param w,h size of the recording canvas. commands are clipped to it.
+    bool createList(int32_t w, int32_t h)
+    {
+      if (!_panel_list.createList(w, h)) return false;
+      clearClipRect();
+      clearScrollRect();
+      _xpivot = w >> 1;
+      _ypivot = h >> 1;
+      return true;
+    }
+
+    void deleteList(void)
+    {
+      _panel_list.deleteList();
+      _clip_l = 0;
+      _clip_t = 0;
+      _clip_r = -1;
+      _clip_b = -1;
+    }
+
+    /// Discards the recorded commands. The buffer is kept for the next recording.
+    void clearList(void) { _panel_list.clearList(); }
+
+    void setPsram(bool enabled) { _panel_list._psram = enabled; }
+
+    /// Supported depths are 8bit grayscale, RGB332, RGB565 and RGB888.
+    /// Other depths are recorded with the nearest one. Changing the depth clears the list.
+    void setColorDepth(int bits) { setColorDepth((color_depth_t)(bits & color_depth_t::bit_mask)); }
+    void setColorDepth(color_depth_t depth)
+    {
+      _panel_list.clearList();
+      LGFXBase::setColorDepth(depth);
+    }
+
+    void replay(LGFXBase* dst, int32_t x = 0, int32_t y = 0) const { _panel_list.replay(dst, x, y); }
+
+    const uint8_t* getListBuffer(void) const { return _panel_list.getBuffer(); }
+    size_t getListLength(void) const { return _panel_list.getLength(); }
+    uint32_t getCommandCount(void) const { return _panel_list.getCommandCount(); }
+
+    /// true if a command was dropped because the buffer could not be grown.
+    bool isOverflow(void) const { return _panel_list.isOverflow(); }
+
+  protected:
+    Panel_DisplayList _panel_list;
+  };
+
+//----------------------------------------------------------------------------
+ }
+}
+
+using LGFX_DisplayList = lgfx::LGFX_DisplayList;
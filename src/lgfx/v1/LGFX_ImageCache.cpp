@@ -0,0 +1,546 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [FreeBSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+#include "LGFX_ImageCache.hpp"
+#include "LGFX_Sprite.hpp"
+#include "misc/bitmap.hpp"
+#include "platforms/common.hpp"
+
+#include "../utility/lgfx_pngle.h"
+#include "../utility/lgfx_qoi.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  namespace
+  {
+    // receives the rows of png / qoi as argb, scaled in the same way as png_draw_alpha_scale_callback.
+    struct capture_t
+    {
+      DataWrapper* data;
+      bgra8888_t* image;
+      int32_t w;
+      int32_t h;
+      float zoom_x;
+      float zoom_y;
+
+      static uint32_t read_data(void* self, uint8_t* buf, uint32_t len)
+      {
+        auto data = ((capture_t*)self)->data;
+        auto res = len;
+        data->preRead();
+        if (buf) {
+          res = data->read(buf, len, (len > 1) ? 2 : 1);
+        } else {
+          data->skip(len);
+        }
+        return res;
+      }
+
+      static uint32_t draw(void* self, uint32_t x, uint32_t y, uint_fast8_t div_x, size_t len, const uint8_t* argb)
+      {
+        auto c = (capture_t*)self;
+        int32_t y0 = ceilf( y      * c->zoom_y);
+        int32_t y1 = ceilf((y + 1) * c->zoom_y);
+        if (y1 > c->h) { y1 = c->h; }
+        for (; len && y0 < y1; --len, x += div_x, argb += 4)
+        {
+          int32_t left  = ceilf( x      * c->zoom_x);
+          int32_t right = ceilf((x + 1) * c->zoom_x);
+          if (right > c->w) { right = c->w; }
+          for (int32_t py = y0; py < y1; ++py)
+          {
+            auto dst = &c->image[py * c->w];
+            for (int32_t px = left; px < right; ++px)
+            {
+              memcpy(&dst[px], argb, sizeof(bgra8888_t));
+            }
+          }
+        }
+        return 1;
+      }
+    };
+
+    // the number of columns (or rows) from the first one (or the last one when `reverse`) whose bytes are all `value`.
+    int32_t count_filled(const uint8_t* image, int32_t w, int32_t h, size_t pixel, uint8_t value, bool column, bool reverse)
+    {
+      int32_t lines = column ? w : h;
+      size_t line_step = column ? pixel : w * pixel;  // from a column (row) to the next one
+      size_t step      = column ? w * pixel : 1;      // along a column (row)
+      size_t count     = column ? h : w * pixel;
+      int32_t n = 0;
+      for (; n < lines; ++n)
+      {
+        auto p = &image[(reverse ? lines - 1 - n : n) * line_step];
+        for (size_t i = 0; i < count; ++i, p += step)
+        {
+          for (size_t j = 0; j < (column ? pixel : 1); ++j)
+          {
+            if (p[j] != value) { return n; }
+          }
+        }
+      }
+      return n;
+    }
+
+    bool read_jpg_size(DataWrapper* data, int32_t* w, int32_t* h)
+    {
+      uint8_t buf[5];
+      if (data->read(buf, 2) != 2 || buf[0] != 0xFF || buf[1] != 0xD8) { return false; }
+      for (;;)
+      {
+        if (data->read(buf, 2) != 2 || buf[0] != 0xFF) { return false; }
+        while (buf[1] == 0xFF)
+        { // fill bytes
+          if (data->read(&buf[1], 1) != 1) { return false; }
+        }
+        uint_fast8_t marker = buf[1];
+        if (data->read(buf, 2) != 2) { return false; }
+        uint32_t seglen = (buf[0] << 8) + buf[1];
+        if (seglen < 2) { return false; }
+        if ((marker & 0xF0) == 0xC0 && marker != 0xC4 && marker != 0xC8 && marker != 0xCC)
+        { // SOFn : precision, height, width
+          if (data->read(buf, 5) != 5) { return false; }
+          *h = (buf[1] << 8) + buf[2];
+          *w = (buf[3] << 8) + buf[4];
+          return true;
+        }
+        data->skip(seglen - 2);
+      }
+    }
+  }
+
+//----------------------------------------------------------------------------
+
+  void LGFX_ImageCache::fitZoom(float* zoom_x, float* zoom_y, float fit_width, float fit_height, int32_t w, int32_t h)
+  {
+    if (*zoom_y > 0.0f && *zoom_x > 0.0f) { return; }
+    if (*zoom_x <= -1.0f) { *zoom_x = fit_width  / w; }
+    if (*zoom_y <= -1.0f) { *zoom_y = fit_height / h; }
+    if (*zoom_x <= 0.0f)
+    {
+      if (*zoom_y <= 0.0f)
+      {
+        *zoom_y = std::min<float>(fit_width / w, fit_height / h);
+      }
+      *zoom_x = *zoom_y;
+    }
+    if (*zoom_y <= 0.0f)
+    {
+      *zoom_y = *zoom_x;
+    }
+  }
+
+  void LGFX_ImageCache::setMaxBytes(size_t bytes)
+  {
+    _max_bytes = bytes;
+    if (bytes == 0) { return; }
+    while (_tail && _bytes > bytes)
+    {
+      remove(_tail);
+    }
+  }
+
+  void LGFX_ImageCache::clear(void)
+  {
+    while (_tail)
+    {
+      remove(_tail);
+    }
+  }
+
+  void LGFX_ImageCache::unlink(entry_t* entry)
+  {
+    if (entry->prev) { entry->prev->next = entry->next; } else { _head = entry->next; }
+    if (entry->next) { entry->next->prev = entry->prev; } else { _tail = entry->prev; }
+  }
+
+  void LGFX_ImageCache::insert(entry_t* entry)
+  {
+    if (_max_bytes)
+    {
+      while (_tail && _bytes + entry->bytes > _max_bytes)
+      {
+        remove(_tail);
+      }
+    }
+    entry->prev = nullptr;
+    entry->next = _head;
+    if (_head) { _head->prev = entry; } else { _tail = entry; }
+    _head = entry;
+
+    auto& slot = _hash[entry->hash % hash_size];
+    entry->hash_next = slot;
+    slot = entry;
+
+    _bytes += entry->bytes;
+    ++_count;
+  }
+
+  void LGFX_ImageCache::remove(entry_t* entry)
+  {
+    unlink(entry);
+
+    auto slot = &_hash[entry->hash % hash_size];
+    while (*slot != entry) { slot = &(*slot)->hash_next; }
+    *slot = entry->hash_next;
+
+    _bytes -= entry->bytes;
+    --_count;
+    heap_free(entry);
+  }
+
+  LGFX_ImageCache::entry_t* LGFX_ImageCache::alloc_entry(size_t path_len, size_t image_bytes)
+  {
+    // rgb888 pixels are read 4 bytes at a time, so the image is padded to the next 4 bytes.
+    size_t bytes = sizeof(entry_t) + ((path_len + 4) & ~3u) + ((image_bytes + 4) & ~3u);
+    if (_max_bytes && bytes > _max_bytes) { return nullptr; }
+    void* mem = _psram ? heap_alloc_psram(bytes) : nullptr;
+    if (mem == nullptr) { mem = heap_alloc(bytes); }
+    if (mem == nullptr) { return nullptr; }
+    auto entry = (entry_t*)mem;
+    memset(entry, 0, sizeof(entry_t));
+    entry->bytes = bytes;
+    entry->path_len = path_len;
+    return entry;
+  }
+
+  LGFX_ImageCache::entry_t* LGFX_ImageCache::find(LGFXBase* gfx, image_format_t format, const char* path, const void* source, uint32_t len, uint32_t hash, color_depth_t depth, int32_t maxWidth, int32_t maxHeight, float zoom_x, float zoom_y)
+  {
+    float fit_width  = (maxWidth  > 0) ? maxWidth  : gfx->width();
+    float fit_height = (maxHeight > 0) ? maxHeight : gfx->height();
+    for (auto entry = _hash[hash % hash_size]; entry; entry = entry->hash_next)
+    {
+      if (entry->hash   != hash
+       || entry->format != format
+       || entry->target != depth) { continue; }
+      if (path ? (entry->source != nullptr || strcmp(entry->path(), path) != 0)
+               : (entry->source != source  || entry->source_len != len)) { continue; }
+      // the fitting scale depends on the size of the image, which is only known here.
+      float zx = zoom_x, zy = zoom_y;
+      fitZoom(&zx, &zy, fit_width, fit_height, entry->src_w, entry->src_h);
+      if (entry->zoom_x == zx && entry->zoom_y == zy)
+      {
+        return entry;
+      }
+    }
+    return nullptr;
+  }
+
+  bool LGFX_ImageCache::draw(LGFXBase* gfx, image_format_t format, DataWrapper* data, const char* path, const void* source, uint32_t len
+                            , int32_t x, int32_t y, int32_t maxWidth, int32_t maxHeight, int32_t offX, int32_t offY, float zoom_x, float zoom_y, datum_t datum, bool* result)
+  {
+    auto depth = gfx->getColorDepth();
+    uint_fast8_t bits = depth & color_depth_t::bit_mask;
+    if (gfx->hasPalette() || bits < 8 || bits > 24) { return false; }
+
+    uint32_t hash = 2166136261u; // FNV-1a
+    if (path)
+    {
+      for (auto p = path; *p; ++p)
+      {
+        hash = (hash ^ (uint8_t)*p) * 16777619u;
+      }
+    }
+    else
+    {
+      hash = (hash ^ (uint32_t)(uintptr_t)source) * 16777619u;
+      hash = (hash ^ len) * 16777619u;
+    }
+    hash = (hash ^ (format + (depth << 8))) * 16777619u;
+
+    auto entry = find(gfx, format, path, source, len, hash, depth, maxWidth, maxHeight, zoom_x, zoom_y);
+    if (entry)
+    {
+      ++_hit_count;
+      if (entry != _head)
+      {
+        unlink(entry);
+        entry->prev = nullptr;
+        entry->next = _head;
+        _head->prev = entry;
+        _head = entry;
+      }
+    }
+    else
+    {
+      ++_miss_count;
+      data->preRead();
+      if (path && !data->open(path))
+      {
+        data->postRead();
+        *result = false;
+        return true;
+      }
+      auto pos = data->tell();
+      entry = decode(gfx, format, data, path, source, len, hash, maxWidth, maxHeight, zoom_x, zoom_y);
+      if (path) { data->close(); }
+      else if (entry == nullptr) { data->seek(pos); }
+      data->postRead();
+      if (entry == nullptr) { return false; }
+      insert(entry);
+    }
+
+    // drawJpg returns false when nothing is visible, the others return true.
+    *result = push(gfx, entry, x, y, maxWidth, maxHeight, offX, offY, datum) || (format != format_jpg);
+    return true;
+  }
+
+  bool LGFX_ImageCache::push(LGFXBase* gfx, entry_t* entry, int32_t x, int32_t y, int32_t maxWidth, int32_t maxHeight, int32_t offX, int32_t offY, datum_t datum)
+  {
+    // same placement as image_info_t::begin.
+    if (datum)
+    {
+      if (datum & (datum_t::top_center | datum_t::top_right))
+      {
+        float fit_width  = (maxWidth  > 0) ? maxWidth  : gfx->width();
+        float fw = fit_width - entry->src_w * entry->zoom_x;
+        if (datum & datum_t::top_center) { fw /= 2; }
+        offX -= fw;
+      }
+      if (datum & (datum_t::middle_left | datum_t::bottom_left | datum_t::baseline_left))
+      {
+        float fit_height = (maxHeight > 0) ? maxHeight : gfx->height();
+        float fh = fit_height - entry->src_h * entry->zoom_y;
+        if (datum & datum_t::middle_left) { fh /= 2; }
+        offY -= fh;
+      }
+    }
+
+    // the visible area is the intersection of the clip rect, the max size and the image.
+    int32_t ix = x - offX + entry->x;
+    int32_t iy = y - offY + entry->y;
+    int32_t cl, ct, cw, ch;
+    gfx->getClipRect(&cl, &ct, &cw, &ch);
+    int32_t left   = std::max(std::max(x, ix), cl);
+    int32_t top    = std::max(std::max(y, iy), ct);
+    int32_t right  = std::min(ix + entry->w, cl + cw);
+    int32_t bottom = std::min(iy + entry->h, ct + ch);
+    if (maxWidth  > 0 && right  > x + maxWidth ) { right  = x + maxWidth;  }
+    if (maxHeight > 0 && bottom > y + maxHeight) { bottom = y + maxHeight; }
+    if (left >= right || top >= bottom) { return false; }
+
+    gfx->setClipRect(left, top, right - left, bottom - top);
+    if (entry->depth == color_depth_t::argb8888_4Byte)
+    {
+      gfx->pushAlphaImage(ix, iy, entry->w, entry->h, (const bgra8888_t*)entry->image());
+    }
+    else
+    {
+      pixelcopy_t pc(entry->image(), gfx->getColorDepth(), entry->depth, false);
+      gfx->pushImage(ix, iy, entry->w, entry->h, &pc);
+    }
+    gfx->setClipRect(cl, ct, cw, ch);
+    return true;
+  }
+
+  LGFX_ImageCache::entry_t* LGFX_ImageCache::decode(LGFXBase* gfx, image_format_t format, DataWrapper* data, const char* path, const void* source, uint32_t len, uint32_t hash, int32_t maxWidth, int32_t maxHeight, float zoom_x, float zoom_y)
+  {
+    auto target = gfx->getColorDepth();
+    size_t path_len = path ? strlen(path) : 0;
+    if (path_len > UINT16_MAX) { return nullptr; }
+
+    capture_t cap;
+    cap.data = data;
+    pngle_t* pngle = nullptr;
+    qoi_t* qoi = nullptr;
+    int32_t w = 0, h = 0;
+    bool argb = false;
+    auto pos = data->tell();
+
+    // read the size of the image. png and qoi continue decoding from here, bmp and jpg start over in a sprite.
+    switch (format)
+    {
+    case format_bmp:
+      {
+        bitmap_header_t bmpdata;
+        if (bmpdata.load_bmp_header(data) && bmpdata.biCompression <= 3)
+        {
+          w = bmpdata.biWidth;
+          h = abs(bmpdata.biHeight);
+        }
+        data->seek(pos);
+      }
+      break;
+
+    case format_jpg:
+      read_jpg_size(data, &w, &h);
+      data->seek(pos);
+      break;
+
+    case format_png:
+      argb = true;
+      pngle = lgfx_pngle_new();
+      if (pngle && lgfx_pngle_prepare(pngle, capture_t::read_data, &cap) >= 0)
+      {
+        w = lgfx_pngle_get_width(pngle);
+        h = lgfx_pngle_get_height(pngle);
+      }
+      break;
+
+    case format_qoi:
+      argb = true;
+      qoi = lgfx_qoi_new();
+      if (qoi && lgfx_qoi_prepare(qoi, capture_t::read_data, &cap) >= 0)
+      {
+        w = lgfx_qoi_get_width(qoi);
+        h = lgfx_qoi_get_height(qoi);
+      }
+      break;
+
+    default:
+      break;
+    }
+
+    entry_t* entry = nullptr;
+    do
+    {
+      if (w <= 0 || h <= 0 || w > UINT16_MAX || h > UINT16_MAX) { break; }
+
+      float fit_width  = (maxWidth  > 0) ? maxWidth  : gfx->width();
+      float fit_height = (maxHeight > 0) ? maxHeight : gfx->height();
+      fitZoom(&zoom_x, &zoom_y, fit_width, fit_height, w, h);
+      int32_t sw = ceilf(w * zoom_x);
+      int32_t sh = ceilf(h * zoom_y);
+      if (sw <= 0 || sh <= 0 || sw > INT16_MAX || sh > INT16_MAX) { break; }
+
+      size_t pixel_bytes = argb ? sizeof(bgra8888_t) : ((target & color_depth_t::bit_mask) >> 3);
+      entry = alloc_entry(path_len, sw * sh * pixel_bytes);
+      if (entry == nullptr) { break; }
+
+      entry->source     = path ? nullptr : source;
+      entry->source_len = path ? 0 : len;
+      entry->hash       = hash;
+      entry->zoom_x     = zoom_x;
+      entry->zoom_y     = zoom_y;
+      entry->src_w      = w;
+      entry->src_h      = h;
+      entry->w          = sw;
+      entry->h          = sh;
+      entry->format     = format;
+      entry->target     = target;
+      entry->depth      = argb ? color_depth_t::argb8888_4Byte : target;
+      if (path) { memcpy(entry->path(), path, path_len + 1); }
+      memset(entry->image(), 0, sw * sh * pixel_bytes);
+
+      bool res;
+      if (argb)
+      {
+        cap.image  = (bgra8888_t*)entry->image();
+        cap.w      = sw;
+        cap.h      = sh;
+        cap.zoom_x = zoom_x;
+        cap.zoom_y = zoom_y;
+        res = (pngle ? lgfx_pngle_decomp(pngle, capture_t::draw)
+                     : lgfx_qoi_decomp(qoi, capture_t::draw)) >= 0;
+      }
+      else
+      {
+        LGFX_Sprite canvas;
+        canvas.setColorDepth(target);
+        canvas.setBuffer(entry->image(), sw, sh);
+        res = (format == format_bmp)
+            ? canvas.drawBmp(data, 0, 0, 0, 0, 0, 0, zoom_x, zoom_y)
+            : canvas.drawJpg(data, 0, 0, 0, 0, 0, 0, zoom_x, zoom_y);
+
+        // a scaled image may not cover the whole area, pushImageAffine only draws the pixels whose center is inside.
+        // the streaming draw leaves the rest untouched, so the columns and rows that stay zero here
+        // and stay 0xFF when decoded once more on a filled canvas are cut off. (the covered area is a rect)
+        if (res && (zoom_x != 1.0f || zoom_y != 1.0f))
+        {
+          size_t pixel = (target & color_depth_t::bit_mask) >> 3;
+          auto img = entry->image();
+          int32_t l = count_filled(img, sw, sh, pixel, 0x00, true , false);
+          int32_t r = count_filled(img, sw, sh, pixel, 0x00, true , true );
+          int32_t t = count_filled(img, sw, sh, pixel, 0x00, false, false);
+          int32_t b = count_filled(img, sw, sh, pixel, 0x00, false, true );
+          if (l | r | t | b)
+          {
+            memset(img, 0xFF, sw * sh * pixel);
+            data->seek(pos);
+            res = (format == format_bmp)
+                ? canvas.drawBmp(data, 0, 0, 0, 0, 0, 0, zoom_x, zoom_y)
+                : canvas.drawJpg(data, 0, 0, 0, 0, 0, 0, zoom_x, zoom_y);
+            l = std::min(l, count_filled(img, sw, sh, pixel, 0xFF, true , false));
+            r = std::min(r, count_filled(img, sw, sh, pixel, 0xFF, true , true ));
+            t = std::min(t, count_filled(img, sw, sh, pixel, 0xFF, false, false));
+            b = std::min(b, count_filled(img, sw, sh, pixel, 0xFF, false, true ));
+            int32_t cw = std::max(0, sw - l - r);
+            int32_t ch = std::max(0, sh - t - b);
+            if (cw != sw || ch != sh)
+            {
+              for (int32_t py = 0; py < ch; ++py)
+              {
+                memmove(&img[py * cw * pixel], &img[((py + t) * sw + l) * pixel], cw * pixel);
+              }
+              entry->x = l;
+              entry->y = t;
+              entry->w = sw = cw;
+              entry->h = sh = ch;
+            }
+          }
+        }
+      }
+      if (!res)
+      {
+        heap_free(entry);
+        entry = nullptr;
+        break;
+      }
+      if (!argb) { break; }
+
+      // an opaque image is kept in the target format, which is smaller and drawn without blending.
+      auto src = (const bgra8888_t*)entry->image();
+      size_t count = sw * sh;
+      size_t i = 0;
+      while (i != count && src[i].a == 255) { ++i; }
+      if (i != count) { break; }
+
+      auto native = alloc_entry(path_len, count * ((target & color_depth_t::bit_mask) >> 3));
+      if (native == nullptr) { break; }
+      auto bytes = native->bytes;
+      memcpy(native, entry, sizeof(entry_t) + ((path_len + 4) & ~3u));
+      native->bytes = bytes;
+      native->depth = target;
+      {
+        LGFX_Sprite canvas;
+        canvas.setColorDepth(target);
+        canvas.setBuffer(native->image(), sw, sh);
+        pixelcopy_t pc(src, target, bgra8888_t::depth);
+        pc.fp_copy = pixelcopy_t::get_fp_copy_rgb_affine<bgra8888_t>(target);
+        canvas.pushImage(0, 0, sw, sh, &pc);
+      }
+      heap_free(entry);
+      entry = native;
+    } while (0);
+
+    if (pngle) { lgfx_pngle_destroy(pngle); }
+    if (qoi) { lgfx_qoi_destroy(qoi); }
+    return entry;
+  }
+
+//----------------------------------------------------------------------------
+ }
+}
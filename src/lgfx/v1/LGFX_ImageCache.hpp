@@ -0,0 +1,126 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [FreeBSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "misc/enum.hpp"
+#include "misc/DataWrapper.hpp"
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  class LGFXBase;
+
+  /// @brief drawBmp / drawJpg / drawPng / drawQoi のデコード結果を保持するキャッシュ (LRU)。LGFXBase::setImageCacheSize で有効になる。;
+  /// Keeps the decoded images of drawBmp / drawJpg / drawPng / drawQoi (LRU). Enabled by LGFXBase::setImageCacheSize.
+  /// 画像はファイルのパスまたはデータのポインタ、倍率、出力先の色深度で区別する。内容が変わった場合は clear を呼ぶこと。;
+  /// Images are keyed by the file path or the data pointer, the scale and the target color depth. Call clear when the source changes.
+  class LGFX_ImageCache
+  {
+  public:
+    enum image_format_t : uint8_t
+    {
+      format_bmp,
+      format_jpg,
+      format_png,
+      format_qoi,
+    };
+
+    LGFX_ImageCache(void) = default;
+    ~LGFX_ImageCache(void) { clear(); }
+
+    /// @param bytes total size of the cached entries. 0 = unlimited.
+    void setMaxBytes(size_t bytes);
+    size_t getMaxBytes(void) const { return _max_bytes; }
+    size_t getBytes(void) const { return _bytes; }
+    uint32_t getCount(void) const { return _count; }
+    uint32_t getHitCount(void) const { return _hit_count; }
+    uint32_t getMissCount(void) const { return _miss_count; }
+
+    /// 新しい画像を PSRAM に置く (PSRAM が無い場合は内部RAM);
+    /// Places new entries in PSRAM. (internal RAM when it is not available)
+    void setPsram(bool enable) { _psram = enable; }
+    bool getPsram(void) const { return _psram; }
+
+    void clear(void);
+
+    /// Draws the image from the cache, decoding it first on a miss.
+    /// @param path file to open with `data`, or nullptr when `data` is the memory at `source`.
+    /// @return false if the image can not be cached. `data` is rewound and the caller draws it as usual.
+    bool draw(LGFXBase* gfx, image_format_t format, DataWrapper* data, const char* path, const void* source, uint32_t len
+             , int32_t x, int32_t y, int32_t maxWidth, int32_t maxHeight, int32_t offX, int32_t offY, float zoom_x, float zoom_y, datum_t datum, bool* result);
+
+    /// Resolves the fitting scale (zero or negative) of an image of w x h into fit_width x fit_height.
+    static void fitZoom(float* zoom_x, float* zoom_y, float fit_width, float fit_height, int32_t w, int32_t h);
+
+  protected:
+    struct entry_t
+    {
+      entry_t* prev;
+      entry_t* next;
+      entry_t* hash_next;
+      const void* source;   // data pointer, nullptr for a file
+      uint32_t source_len;
+      uint32_t hash;
+      uint32_t bytes;
+      float zoom_x;         // resolved scale
+      float zoom_y;
+      uint16_t path_len;
+      uint16_t src_w;       // size of the source image
+      uint16_t src_h;
+      uint16_t x;           // position and size of the drawn area in the scaled image
+      uint16_t y;
+      uint16_t w;
+      uint16_t h;
+      image_format_t format;
+      color_depth_t target; // color depth of the target
+      color_depth_t depth;  // same as target, or argb8888_4Byte for the images with transparency
+      // followed by the path (path_len + 1 bytes) and the image.
+      char* path(void) { return reinterpret_cast<char*>(this + 1); }
+      uint8_t* image(void) { return reinterpret_cast<uint8_t*>(this + 1) + ((path_len + 4) & ~3u); }
+    };
+
+    static constexpr size_t hash_size = 32;
+
+    entry_t* _hash[hash_size] = {};
+    entry_t* _head = nullptr;  // most recently used
+    entry_t* _tail = nullptr;  // least recently used
+    size_t _bytes = 0;
+    size_t _max_bytes = 0;
+    uint32_t _count = 0;
+    uint32_t _hit_count = 0;
+    uint32_t _miss_count = 0;
+    bool _psram = true;
+
+    entry_t* find(LGFXBase* gfx, image_format_t format, const char* path, const void* source, uint32_t len, uint32_t hash, color_depth_t depth, int32_t maxWidth, int32_t maxHeight, float zoom_x, float zoom_y);
+    entry_t* decode(LGFXBase* gfx, image_format_t format, DataWrapper* data, const char* path, const void* source, uint32_t len, uint32_t hash, int32_t maxWidth, int32_t maxHeight, float zoom_x, float zoom_y);
+    entry_t* alloc_entry(size_t path_len, size_t image_bytes);
+    bool push(LGFXBase* gfx, entry_t* entry, int32_t x, int32_t y, int32_t maxWidth, int32_t maxHeight, int32_t offX, int32_t offY, datum_t datum);
+    void insert(entry_t* entry);
+    void remove(entry_t* entry);
+    void unlink(entry_t* entry);
+  };
+
+//----------------------------------------------------------------------------
+ }
+}
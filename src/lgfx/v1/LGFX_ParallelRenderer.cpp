@@ -0,0 +1,199 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [FreeBSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+#include "LGFX_ParallelRenderer.hpp"
+
+#if defined ( __linux__ ) || defined ( __APPLE__ ) || defined ( _WIN32 )
+
+#include <algorithm>
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  bool LGFX_ParallelRenderer::band_t::attach(LGFX_Sprite* target, int32_t line, int32_t lines)
+  {
+    uint_fast8_t r = target->getRotation();
+    int32_t w = target->width();
+    int32_t h = target->height();
+    int32_t pw = (r & 1) ? h : w;
+    int32_t ph = (r & 1) ? w : h;
+
+    if (getBuffer() != target->getBuffer()
+     || getColorDepth() != target->getColorDepth()
+     || getRotation() != r
+     || width() != w || height() != h)
+    {
+      deleteSprite();  // the buffer is not owned, so only the pointer is released.
+      setColorDepth(target->getColorDepth());
+      setBuffer(target->getBuffer(), pw, ph);
+      setRotation(r);
+    }
+    _palette.reset(target->getPalette());
+    _palette_count = target->getPaletteCount();
+    setPivot(target->getPivotX(), target->getPivotY());
+
+    // the band is a range of memory lines. find the matching range in the rotated coordinates.
+    int32_t x = 0, y = 0;
+    if (r & 1)
+    {
+      x = (r & 2) ? w - (line + lines) : line;
+      w = lines;
+    }
+    else
+    {
+      y = ((1u << r) & 0b10010110) ? h - (line + lines) : line;
+      h = lines;
+    }
+
+    int32_t cx, cy, cw, ch;
+    target->getClipRect(&cx, &cy, &cw, &ch);
+    int32_t l = std::max(x, cx);
+    int32_t t = std::max(y, cy);
+    int32_t rr = std::min(x + w, cx + cw);
+    int32_t b = std::min(y + h, cy + ch);
+    if (l >= rr || t >= b) { return false; }
+    setClipRect(l, t, rr - l, b - t);
+    return true;
+  }
+
+//----------------------------------------------------------------------------
+
+  bool LGFX_ParallelRenderer::init(LGFX_Sprite* target, uint32_t threads)
+  {
+    release();
+    if (target == nullptr || target->getBuffer() == nullptr) return false;
+    _target = target;
+    setThreadCount(threads);
+    return true;
+  }
+
+  void LGFX_ParallelRenderer::release(void)
+  {
+    stop_threads();
+    if (_bands) { delete[] _bands; }
+    _bands = nullptr;
+    _thread_count = 0;
+    _target = nullptr;
+  }
+
+  void LGFX_ParallelRenderer::setThreadCount(uint32_t threads)
+  {
+    if (threads == 0)
+    {
+      threads = std::thread::hardware_concurrency();
+      if (threads == 0) { threads = 1; }
+    }
+    if (threads == _thread_count) return;
+
+    stop_threads();
+    if (_bands) { delete[] _bands; }
+    _bands = new band_t[threads];
+    _thread_count = threads;
+
+    _quit = false;
+    _generation = 0;
+    for (uint32_t i = 1; i < threads; ++i)
+    {
+      _threads.emplace_back(&LGFX_ParallelRenderer::worker, this, i);
+    }
+  }
+
+  void LGFX_ParallelRenderer::stop_threads(void)
+  {
+    if (_threads.empty()) return;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _quit = true;
+    }
+    _start_cv.notify_all();
+    for (auto& th : _threads) { th.join(); }
+    _threads.clear();
+  }
+
+  void LGFX_ParallelRenderer::worker(uint32_t index)
+  {
+    uint32_t generation = 0;
+    for (;;)
+    {
+      band_cb_t callback;
+      void* user_data;
+      {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _start_cv.wait(lock, [&] { return _quit || _generation != generation; });
+        if (_quit) return;
+        generation = _generation;
+        if (index >= _band_count) continue;
+        callback = _callback;
+        user_data = _user_data;
+      }
+
+      auto band = &_bands[index];
+      if (band->active) { callback(band, user_data); }
+
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (--_pending) continue;
+      }
+      _done_cv.notify_one();
+    }
+  }
+
+  void LGFX_ParallelRenderer::run(band_cb_t callback, void* user_data)
+  {
+    auto target = _target;
+    if (target == nullptr || callback == nullptr || target->getBuffer() == nullptr) return;
+
+    int32_t lines = (target->getRotation() & 1) ? target->width() : target->height();
+    uint32_t band_count = std::max<int32_t>(1, std::min<int32_t>(_thread_count, lines / _min_band_lines));
+
+    for (uint32_t i = 0; i < band_count; ++i)
+    {
+      int32_t line = lines * i / band_count;
+      int32_t next = lines * (i + 1) / band_count;
+      _bands[i].active = _bands[i].attach(target, line, next - line);
+    }
+
+    if (band_count == 1)
+    {
+      if (_bands[0].active) { callback(&_bands[0], user_data); }
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _callback = callback;
+      _user_data = user_data;
+      _band_count = band_count;
+      _pending = band_count - 1;
+      ++_generation;
+    }
+    _start_cv.notify_all();
+
+    if (_bands[0].active) { callback(&_bands[0], user_data); }
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _done_cv.wait(lock, [&] { return _pending == 0; });
+  }
+
+//----------------------------------------------------------------------------
+ }
+}
+
+#endif
@@ -0,0 +1,125 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [FreeBSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+#pragma once
+
+#if defined ( __linux__ ) || defined ( __APPLE__ ) || defined ( _WIN32 )
+
+#include "LGFX_Sprite.hpp"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <type_traits>
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  /// @brief スプライトを横帯に分割し、帯ごとの描画を複数のスレッドで並列に実行する (PC向け)。;
+  /// Splits a sprite into bands of memory lines and draws each band on its own thread. (host platforms)
+  /// 各帯は同じバッファを共有するスプライトで、クリップ範囲がその帯に制限される。;
+  /// 画素ごとに独立した描画 (回転・拡大縮小、グラデーション、アンチエイリアス図形など) は単一スレッドと同じ結果になる。;
+  /// Each band is a sprite sharing the buffer, clipped to the band, so per-pixel primitives
+  /// (rotate / zoom, gradients, anti-aliased shapes...) give the same result as a single thread.
+  /// floodFill and other operations that read outside their own band must not be used.
+  class LGFX_ParallelRenderer
+  {
+  public:
+    /// Draws in the coordinates of the target. Called once per band, concurrently.
+    typedef void (*band_cb_t)(LGFX_Sprite* band, void* user_data);
+
+    LGFX_ParallelRenderer(void) = default;
+    ~LGFX_ParallelRenderer(void) { release(); }
+
+    /// @param target sprite to draw into.
+    /// @param threads number of threads including the caller. 0 = number of CPU cores.
+    bool init(LGFX_Sprite* target, uint32_t threads = 0);
+    void release(void);
+
+    /// Changes the number of threads. 1 = draw on the calling thread only.
+    void setThreadCount(uint32_t threads);
+    uint32_t getThreadCount(void) const { return _thread_count; }
+
+    /// Bands smaller than this are not split further, since a thread costs more than drawing a few lines.
+    void setMinBandLines(uint32_t lines) { _min_band_lines = lines ? lines : 1; }
+
+    LGFX_Sprite* getTarget(void) const { return _target; }
+
+    /// Calls the callback once per band and waits until all bands are drawn.
+    void run(band_cb_t callback, void* user_data = nullptr);
+
+    /// Calls func(LGFX_Sprite* band) once per band and waits until all bands are drawn.
+    template <typename TFunc>
+    void run(TFunc&& func)
+    {
+      typedef typename std::remove_reference<TFunc>::type func_t;
+      run([](LGFX_Sprite* band, void* user_data) { (*static_cast<func_t*>(user_data))(band); }, (void*)&func);
+    }
+
+    template <typename ... TArgs> void pushImageRotateZoom      (TArgs&& ... args) { run([&](LGFX_Sprite* band) { band->pushImageRotateZoom(args ...); }); }
+    template <typename ... TArgs> void pushImageRotateZoomWithAA(TArgs&& ... args) { run([&](LGFX_Sprite* band) { band->pushImageRotateZoomWithAA(args ...); }); }
+    template <typename ... TArgs> void pushImageAffine          (TArgs&& ... args) { run([&](LGFX_Sprite* band) { band->pushImageAffine(args ...); }); }
+    template <typename ... TArgs> void pushImageAffineWithAA    (TArgs&& ... args) { run([&](LGFX_Sprite* band) { band->pushImageAffineWithAA(args ...); }); }
+    template <typename ... TArgs> void fillGradientRect         (TArgs&& ... args) { run([&](LGFX_Sprite* band) { band->fillGradientRect(args ...); }); }
+    template <typename ... TArgs> void fillSmoothCircle         (TArgs&& ... args) { run([&](LGFX_Sprite* band) { band->fillSmoothCircle(args ...); }); }
+    template <typename ... TArgs> void fillSmoothRoundRect      (TArgs&& ... args) { run([&](LGFX_Sprite* band) { band->fillSmoothRoundRect(args ...); }); }
+
+    /// Draws a sprite rotated and zoomed, e.g. pushRotateZoom(&src, x, y, angle, zoom_x, zoom_y).
+    template <typename ... TArgs> void pushRotateZoom      (LGFX_Sprite* src, TArgs&& ... args) { run([&](LGFX_Sprite* band) { src->pushRotateZoom(band, args ...); }); }
+    template <typename ... TArgs> void pushRotateZoomWithAA(LGFX_Sprite* src, TArgs&& ... args) { run([&](LGFX_Sprite* band) { src->pushRotateZoomWithAA(band, args ...); }); }
+    template <typename ... TArgs> void pushAffine          (LGFX_Sprite* src, TArgs&& ... args) { run([&](LGFX_Sprite* band) { src->pushAffine(band, args ...); }); }
+    template <typename ... TArgs> void pushAffineWithAA    (LGFX_Sprite* src, TArgs&& ... args) { run([&](LGFX_Sprite* band) { src->pushAffineWithAA(band, args ...); }); }
+
+  protected:
+    /// a sprite drawing into a part of the target buffer.
+    class band_t : public LGFX_Sprite
+    {
+    public:
+      /// @return false if the band is outside the clip rect of the target.
+      bool attach(LGFX_Sprite* target, int32_t line, int32_t lines);
+      bool active = false;
+    };
+
+    LGFX_Sprite* _target = nullptr;
+    band_t* _bands = nullptr;
+    std::vector<std::thread> _threads;
+    uint32_t _thread_count = 0;
+    uint32_t _min_band_lines = 16;
+
+    std::mutex _mutex;
+    std::condition_variable _start_cv;
+    std::condition_variable _done_cv;
+    band_cb_t _callback = nullptr;
+    void* _user_data = nullptr;
+    uint32_t _generation = 0;
+    uint32_t _band_count = 0;
+    uint32_t _pending = 0;
+    bool _quit = false;
+
+    void stop_threads(void);
+    void worker(uint32_t index);
+  };
+
+//----------------------------------------------------------------------------
+ }
+}
+
+#endif
@@ -269,6 +269,34 @@ namespace lgfx
     }
   }
 
+  void Panel_Sprite::writeFillRectAlphaPreclipped(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t argb8888)
+  {
+    auto fp_blend = pixelcopy_t::get_fp_blend_fill(_write_depth);
+    if (fp_blend == nullptr)
+    {
+      IPanel::writeFillRectAlphaPreclipped(x, y, w, h, argb8888);
+      return;
+    }
+
+    uint_fast8_t r = _rotation;
+    if (r)
+    {
+      if ((1u << r) & 0b10010110) { y = _height - (y + h); }
+      if (r & 2)                  { x = _width  - (x + w); }
+      if (r & 1) { std::swap(x, y);  std::swap(w, h); }
+    }
+
+    // blend directly in the sprite memory, without the readRect / writeImage round trip.
+    uint_fast8_t bytes = _write_bits >> 3;
+    uint_fast32_t add_dst = _bitwidth * bytes;
+    uint8_t* dst = &_img[(x + y * _bitwidth) * bytes];
+    do
+    {
+      fp_blend(dst, w, argb8888);
+      dst += add_dst;
+    } while (--h);
+  }
+
   void Panel_Sprite::writeBlock(uint32_t rawcolor, uint32_t length)
   {
     do
@@ -692,6 +720,40 @@ namespace lgfx
     return res;
   }
 
+  bool LGFX_Sprite::create_from_png_file(DataWrapper* data, const char *path) {
+    data->need_transaction = false;
+    bool res = false;
+    if (data->open(path)) {
+      res = createFromPng(data);
+      data->close();
+    }
+    return res;
+  }
+
+  bool LGFX_Sprite::createFromPng(DataWrapper* data)
+  {
+    static constexpr uint8_t png_signature[] = { 0x89, 'P', 'N', 'G', 0x0d, 0x0a, 0x1a, 0x0a, 0, 0, 0, 13, 'I', 'H', 'D', 'R' };
+    uint8_t ihdr[26]; // signature + IHDR (width, height, depth, color type)
+    auto pos = data->tell();
+    if (data->read(ihdr, sizeof(ihdr)) != sizeof(ihdr)
+     || memcmp(ihdr, png_signature, sizeof(png_signature))) {
+      return false;
+    }
+    data->seek(pos);
+
+    uint32_t w = (ihdr[16] << 24) + (ihdr[17] << 16) + (ihdr[18] << 8) + ihdr[19];
+    uint32_t h = (ihdr[20] << 24) + (ihdr[21] << 16) + (ihdr[22] << 8) + ihdr[23];
+    uint_fast8_t depth = ihdr[24];
+    bool indexed = (ihdr[25] == 3) && depth <= 8;
+
+    deleteSprite();
+    setColorDepth(indexed ? (color_depth_t)(depth | color_depth_t::has_palette) : rgb888_3Byte);
+    if (!createSprite(w, h)) return false;
+
+    // the indices are written as they are, and the palette of the PNG is copied. (see LGFXBase::draw_png_impl)
+    return draw_png_impl(data, 0, 0, 0, 0, 0, 0, 1.0f, 1.0f, datum_t::top_left, true);
+  }
+
   bool LGFX_Sprite::createFromBmp(DataWrapper* data)
   {
     bitmap_header_t bmpdata;
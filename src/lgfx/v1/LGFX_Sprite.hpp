@@ -79,6 +79,7 @@ namespace lgfx
     void setWindow(uint_fast16_t xs, uint_fast16_t ys, uint_fast16_t xe, uint_fast16_t ye) override;
     void drawPixelPreclipped(uint_fast16_t x, uint_fast16_t y, uint32_t rawcolor) override;
     void writeFillRectPreclipped(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t raw_color) override;
+    void writeFillRectAlphaPreclipped(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t argb8888) override;
     void writeBlock(uint32_t rawcolor, uint32_t len) override;
     void writePixels(pixelcopy_t* param, uint32_t len, bool use_dma) override;
     void writeImage(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param, bool) override;
@@ -89,6 +90,11 @@ namespace lgfx
 
     uint32_t readPixelValue(uint_fast16_t x, uint_fast16_t y);
 
+    void* getFrameBufferLine(uint_fast16_t y) override
+    {
+      return (_rotation == 0 && _write_bits >= 8 && y < _panel_height) ? &_img.img8()[y * (_bitwidth * _write_bits >> 3)] : nullptr;
+    }
+
   protected:
     void _rotate_pixelcopy(uint_fast16_t& x, uint_fast16_t& y, uint_fast16_t& w, uint_fast16_t& h, pixelcopy_t* param, uint32_t& nextx, uint32_t& nexty);
 
@@ -217,6 +223,34 @@ namespace lgfx
     template <typename T>
     bool createFromBmp(T &fs, const char *path) { return createFromBmpFile(fs, path); }
 
+    /// IHDR に合わせてスプライトを作成しPNGを読込む。パレットを持つPNGはパレットスプライト(1/2/4/8bit)になる。;
+    /// Creates the sprite from the IHDR and loads the PNG. an indexed PNG becomes a palette sprite (1/2/4/8bit) with its palette,
+    /// and the others become 24bit sprites. (the transparent pixels are left as index 0 / black)
+    bool createFromPng(DataWrapper* data);
+
+    bool createFromPng(const uint8_t *png_data, uint32_t png_len = ~0u) {
+      PointerWrapper data (png_data, png_len);
+      return createFromPng(&data);
+    }
+
+    bool createFromPngFile(const char *path)
+    {
+      auto data = _create_data_wrapper();
+      bool res = create_from_png_file(data, path);
+      delete data;
+      return res;
+    }
+
+    template <typename T>
+    bool createFromPngFile(T &fs, const char *path)
+    {
+      DataWrapperT<T> data { &fs };
+      return create_from_png_file(&data, path);
+    }
+
+    template <typename T>
+    bool createFromPng(T &fs, const char *path) { return createFromPngFile(fs, path); }
+
     bool createPalette(void)
     {
       if (!create_palette()) return false;
@@ -417,6 +451,7 @@ namespace lgfx
     }
 
     bool create_from_bmp_file(DataWrapper* data, const char *path);
+    bool create_from_png_file(DataWrapper* data, const char *path);
 
     void push_sprite(LovyanGFX* dst, int32_t x, int32_t y, uint32_t transp = pixelcopy_t::NON_TRANSP)
     {
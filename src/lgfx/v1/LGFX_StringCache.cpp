@@ -0,0 +1,543 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [FreeBSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+#include "LGFX_StringCache.hpp"
+#include "LGFX_Sprite.hpp"
+#include "platforms/common.hpp"
+
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  namespace
+  {
+    // blends the foreground color with an 8bit alpha mask. (same formula as pixelcopy_t::blend_rgb_fast)
+    template <typename TDst>
+    uint32_t blend_mask(void* __restrict dst, uint32_t index, uint32_t last, pixelcopy_t* __restrict param)
+    {
+      auto d = static_cast<TDst*>(dst);
+      auto s = static_cast<const uint8_t*>(param->src_data);
+      uint_fast16_t r = (param->fore_rgb888 >> 16) & 0xFF;
+      uint_fast16_t g = (param->fore_rgb888 >>  8) & 0xFF;
+      uint_fast16_t b = (param->fore_rgb888      ) & 0xFF;
+      if (param->src_y32_add == 0 && param->src_x32_add == (1u << pixelcopy_t::FP_SCALE))
+      { // unrotated : the mask is one contiguous run, and the transparent pixels are skipped quickly.
+        auto sp = &s[param->src_x + param->src_y * param->src_bitwidth];
+        param->src_x32 += (last - index) << pixelcopy_t::FP_SCALE;
+        for (; index != last; ++index, ++sp)
+        {
+          uint_fast16_t a = *sp;
+          if (a == 0) { continue; }
+          if (a == 255)
+          {
+            d[index].set(r, g, b);
+            continue;
+          }
+          uint_fast16_t inv = 256 - a;
+          ++a;
+          d[index].set( (d[index].R8() * inv + r * a) >> 8
+                      , (d[index].G8() * inv + g * a) >> 8
+                      , (d[index].B8() * inv + b * a) >> 8
+                      );
+        }
+        return last;
+      }
+      for (;;)
+      {
+        uint_fast16_t a = s[param->src_x + param->src_y * param->src_bitwidth];
+        if (a)
+        {
+          if (a == 255)
+          {
+            d[index].set(r, g, b);
+          }
+          else
+          {
+            uint_fast16_t inv = 256 - a;
+            ++a;
+            d[index].set( (d[index].R8() * inv + r * a) >> 8
+                        , (d[index].G8() * inv + g * a) >> 8
+                        , (d[index].B8() * inv + b * a) >> 8
+                        );
+          }
+        }
+        param->src_x32 += param->src_x32_add;
+        param->src_y32 += param->src_y32_add;
+        if (++index == last) return last;
+      }
+    }
+
+    // draws the foreground color on the set bits of a 1bit mask.
+    template <typename TDst>
+    uint32_t blend_mask1(void* __restrict dst, uint32_t index, uint32_t last, pixelcopy_t* __restrict param)
+    {
+      auto d = static_cast<TDst*>(dst);
+      auto s = static_cast<const uint8_t*>(param->src_data);
+      TDst fore;
+      fore.set((param->fore_rgb888 >> 16) & 0xFF, (param->fore_rgb888 >> 8) & 0xFF, param->fore_rgb888 & 0xFF);
+      if (param->src_y32_add == 0 && param->src_x32_add == (1u << pixelcopy_t::FP_SCALE))
+      {
+        uint32_t i = param->src_x + param->src_y * param->src_bitwidth;
+        param->src_x32 += (last - index) << pixelcopy_t::FP_SCALE;
+        for (; index != last; ++index, ++i)
+        {
+          uint_fast8_t bits = s[i >> 3];
+          if (bits == 0)
+          { // skip the rest of the byte.
+            uint32_t skip = 7 - (i & 7);
+            if (skip > last - index - 1) { skip = last - index - 1; }
+            index += skip;
+            i += skip;
+            continue;
+          }
+          if (bits & (0x80 >> (i & 7))) { d[index] = fore; }
+        }
+        return last;
+      }
+      for (;;)
+      {
+        uint32_t i = param->src_x + param->src_y * param->src_bitwidth;
+        if (s[i >> 3] & (0x80 >> (i & 7))) { d[index] = fore; }
+        param->src_x32 += param->src_x32_add;
+        param->src_y32 += param->src_y32_add;
+        if (++index == last) return last;
+      }
+    }
+
+    uint32_t (*get_fp_blend_mask(color_depth_t depth, bool mask1))(void*, uint32_t, uint32_t, pixelcopy_t*)
+    {
+      return (depth == rgb565_2Byte  ) ? (mask1 ? blend_mask1<swap565_t  > : blend_mask<swap565_t  >)
+           : (depth == rgb332_1Byte  ) ? (mask1 ? blend_mask1<rgb332_t   > : blend_mask<rgb332_t   >)
+           : (depth == rgb888_3Byte  ) ? (mask1 ? blend_mask1<bgr888_t   > : blend_mask<bgr888_t   >)
+           : (depth == rgb666_3Byte  ) ? (mask1 ? blend_mask1<bgr666_t   > : blend_mask<bgr666_t   >)
+           : (depth == grayscale_8bit) ? (mask1 ? blend_mask1<grayscale_t> : blend_mask<grayscale_t>)
+           : nullptr;
+    }
+
+    uint32_t read_raw(const uint8_t* p, size_t bytes)
+    {
+      uint32_t raw = p[0];
+      if (bytes > 1) { raw |= p[1] << 8; }
+      if (bytes > 2) { raw |= p[2] << 16; }
+      return raw;
+    }
+
+    void write_raw(uint8_t* p, size_t bytes, uint32_t raw)
+    {
+      p[0] = raw;
+      if (bytes > 1) { p[1] = raw >> 8; }
+      if (bytes > 2) { p[2] = raw >> 16; }
+    }
+  }
+
+//----------------------------------------------------------------------------
+
+  void LGFX_StringCache::setMaxBytes(size_t bytes)
+  {
+    _max_bytes = bytes;
+    if (bytes == 0) { return; }
+    while (_tail && _bytes > bytes)
+    {
+      remove(_tail);
+    }
+  }
+
+  void LGFX_StringCache::clear(void)
+  {
+    while (_tail)
+    {
+      remove(_tail);
+    }
+  }
+
+  void LGFX_StringCache::unlink(entry_t* entry)
+  {
+    if (entry->prev) { entry->prev->next = entry->next; } else { _head = entry->next; }
+    if (entry->next) { entry->next->prev = entry->prev; } else { _tail = entry->prev; }
+  }
+
+  void LGFX_StringCache::insert(entry_t* entry)
+  {
+    if (_max_bytes)
+    {
+      while (_tail && _bytes + entry->bytes > _max_bytes)
+      {
+        remove(_tail);
+      }
+    }
+    entry->prev = nullptr;
+    entry->next = _head;
+    if (_head) { _head->prev = entry; } else { _tail = entry; }
+    _head = entry;
+
+    auto& slot = _hash[entry->hash % hash_size];
+    entry->hash_next = slot;
+    slot = entry;
+
+    _bytes += entry->bytes;
+    ++_count;
+  }
+
+  void LGFX_StringCache::remove(entry_t* entry)
+  {
+    unlink(entry);
+
+    auto slot = &_hash[entry->hash % hash_size];
+    while (*slot != entry) { slot = &(*slot)->hash_next; }
+    *slot = entry->hash_next;
+
+    _bytes -= entry->bytes;
+    --_count;
+    heap_free(entry);
+  }
+
+  LGFX_StringCache::entry_t* LGFX_StringCache::find(const char* string, size_t len, uint32_t hash, textdatum_t datum, const IFont* font, const TextStyle* style, color_depth_t depth)
+  {
+    for (auto entry = _hash[hash % hash_size]; entry; entry = entry->hash_next)
+    {
+      if (entry->hash        == hash
+       && entry->text_len    == len
+       && entry->font        == font
+       && entry->datum       == datum
+       && entry->depth       == depth
+       && entry->style.fore_rgb888 == style->fore_rgb888
+       && entry->style.back_rgb888 == style->back_rgb888
+       && entry->style.size_x      == style->size_x
+       && entry->style.size_y      == style->size_y
+       && entry->style.padding_x   == style->padding_x
+       && entry->style.utf8        == style->utf8
+       && entry->style.cp437       == style->cp437
+       && memcmp(entry->text(), string, len) == 0)
+      {
+        return entry;
+      }
+    }
+    return nullptr;
+  }
+
+  bool LGFX_StringCache::draw(LGFXBase* gfx, IPanel* panel, const char* string, int32_t x, int32_t y, textdatum_t datum, const IFont* font, const TextStyle* style, size_t* result)
+  {
+    auto depth = gfx->getColorDepth();
+    uint_fast8_t bits = depth & color_depth_t::bit_mask;
+    if (gfx->hasPalette() || bits < 8 || bits > 24) { return false; }
+
+    size_t len = strlen(string);
+    if (len == 0 || len > UINT16_MAX) { return false; }
+
+    uint32_t hash = 2166136261u; // FNV-1a
+    for (size_t i = 0; i < len; ++i)
+    {
+      hash = (hash ^ (uint8_t)string[i]) * 16777619u;
+    }
+
+    auto entry = find(string, len, hash, datum, font, style, depth);
+    if (entry)
+    {
+      ++_hit_count;
+      if (entry != _head)
+      {
+        unlink(entry);
+        entry->prev = nullptr;
+        entry->next = _head;
+        _head->prev = entry;
+        _head = entry;
+      }
+    }
+    else
+    {
+      ++_miss_count;
+      entry = render(gfx, string, len, hash, datum, font, style);
+      if (entry == nullptr) { return false; }
+      if (_max_bytes && entry->bytes > _max_bytes)
+      { // too large to keep. draw it once.
+        bool drawn = (entry->kind != kind_uncacheable);
+        if (drawn)
+        {
+          push(gfx, panel, entry, x, y);
+          *result = entry->sum_x;
+        }
+        heap_free(entry);
+        return drawn;
+      }
+      insert(entry);
+    }
+
+    if (entry->kind == kind_uncacheable) { return false; }
+    push(gfx, panel, entry, x, y);
+    *result = entry->sum_x;
+    return true;
+  }
+
+  void LGFX_StringCache::push(LGFXBase* gfx, IPanel* panel, entry_t* entry, int32_t x, int32_t y)
+  {
+    x += entry->x;
+    y += entry->y;
+    switch (entry->kind)
+    {
+    case kind_native:
+      {
+        pixelcopy_t pc(entry->image(), gfx->getColorDepth(), entry->depth, false, nullptr, entry->transp);
+        gfx->pushImage(x, y, entry->w, entry->h, &pc);
+      }
+      break;
+
+    case kind_mask1:
+      if (panel->getFrameBufferLine(0))
+      { // on the memory, one blend call per line is faster than splitting the lines at the transparent pixels.
+        pixelcopy_t pc(entry->image(), gfx->getColorDepth(), color_depth_t::palette_1bit);
+        pc.fore_rgb888 = entry->style.fore_rgb888;
+        pc.fp_copy = get_fp_blend_mask(gfx->getColorDepth(), true);
+        if (pc.fp_copy) { gfx->pushAlphaImage(x, y, entry->w, entry->h, &pc); }
+      }
+      else
+      {
+        auto fore = entry->style.fore_rgb888;
+        bgr888_t palette[2] = { bgr888_t(), bgr888_t(fore >> 16, fore >> 8, fore) };
+        pixelcopy_t pc(entry->image(), gfx->getColorDepth(), color_depth_t::palette_1bit, false, palette, 0);
+        gfx->pushImage(x, y, entry->w, entry->h, &pc);
+      }
+      break;
+
+    case kind_mask8:
+      {
+        pixelcopy_t pc(entry->image(), gfx->getColorDepth(), color_depth_t::grayscale_8bit);
+        pc.fore_rgb888 = entry->style.fore_rgb888;
+        pc.fp_copy = get_fp_blend_mask(gfx->getColorDepth(), false);
+        if (pc.fp_copy) { gfx->pushAlphaImage(x, y, entry->w, entry->h, &pc); }
+      }
+      break;
+
+    default:
+      break;
+    }
+  }
+
+  LGFX_StringCache::entry_t* LGFX_StringCache::render(LGFXBase* gfx, const char* string, size_t len, uint32_t hash, textdatum_t datum, const IFont* font, const TextStyle* style)
+  {
+    entry_kind_t kind = kind_uncacheable;
+    int32_t sum_x = 0;
+    int32_t bx = 0, by = 0, bw = 0, bh = 0;
+    uint32_t transp = pixelcopy_t::NON_TRANSP;
+    size_t image_bytes = 0;
+    size_t pixel_bytes = 0;
+
+    LGFX_Sprite canvas[2];
+    int32_t cw = 0, ch = 0;
+    int32_t ox = 0, oy = 0;
+    bool fillbg = (style->fore_rgb888 != style->back_rgb888);
+
+    do
+    {
+      FontMetrics metrics;
+      font->getDefaultMetric(&metrics);
+      int32_t fh = ceilf(metrics.height * style->size_y);
+      if (fh < 1) { fh = 1; }
+
+      TextStyle text_style = *style;
+      text_style.datum = datum;
+      if (!fillbg)
+      { // a white text on the black canvas becomes the alpha mask.
+        text_style.fore_rgb888 = text_style.back_rgb888 = 0xFFFFFFu;
+      }
+
+      // the canvas has a margin of one line height around the text, so that glyphs overhanging the text width are kept.
+      int32_t tw = std::max<int32_t>(gfx->textWidth(string, font), style->padding_x);
+      cw = tw + fh * 2;
+      ch = fh * 3;
+      ox = fh + ((datum & top_center) ? (tw >> 1) : (datum & top_right) ? tw : 0);
+      oy = fh + ((datum & middle_left) ? (fh >> 1) : (datum & bottom_left) ? fh : (datum & baseline_left) ? (int32_t)(metrics.baseline * style->size_y) : 0);
+
+      size_t canvas_count = fillbg ? 2 : 1;
+      for (size_t i = 0; i < canvas_count; ++i)
+      {
+        auto c = &canvas[i];
+        c->setColorDepth(fillbg ? gfx->getColorDepth() : color_depth_t::grayscale_8bit);
+        if (fillbg && c->getColorDepth() != gfx->getColorDepth()) { break; }
+        if (!c->createSprite(cw, ch)) { return nullptr; }
+        // the background of the second canvas differs from the first in every bit, so the untouched pixels can be found.
+        memset(c->getBuffer(), i ? 0xFF : 0x00, c->bufferLength());
+        c->setFont(font);
+        c->setTextStyle(text_style);
+        sum_x = c->drawString(string, ox, oy);
+      }
+      if (canvas[canvas_count - 1].getBuffer() == nullptr) { break; }
+
+      pixel_bytes = fillbg ? ((gfx->getColorDepth() & color_depth_t::bit_mask) >> 3) : 1;
+      auto img0 = static_cast<const uint8_t*>(canvas[0].getBuffer());
+      auto img1 = static_cast<const uint8_t*>(canvas[1].getBuffer());
+
+      // bounding box of the drawn pixels.
+      int32_t left = cw, right = -1, top = ch, bottom = -1;
+      bool binary = true;
+      bool untouched = false;
+      for (int32_t py = 0; py < ch; ++py)
+      {
+        for (int32_t px = 0; px < cw; ++px)
+        {
+          size_t idx = (px + py * cw) * pixel_bytes;
+          bool drawn;
+          if (fillbg)
+          {
+            drawn = (memcmp(&img0[idx], &img1[idx], pixel_bytes) == 0);
+          }
+          else
+          {
+            drawn = (img0[idx] != 0);
+            if (drawn && img0[idx] != 0xFF) { binary = false; }
+          }
+          if (!drawn) { continue; }
+          if (left   > px) { left   = px; }
+          if (right  < px) { right  = px; }
+          if (top    > py) { top    = py; }
+          if (bottom < py) { bottom = py; }
+        }
+      }
+
+      if (right < 0)
+      {
+        kind = kind_empty;
+        break;
+      }
+      // touching the edge of the canvas means that the text may be cut off.
+      if (left == 0 || top == 0 || right == cw - 1 || bottom == ch - 1) { break; }
+
+      bx = left;
+      by = top;
+      bw = right + 1 - left;
+      bh = bottom + 1 - top;
+
+      if (fillbg)
+      {
+        kind = kind_native;
+        for (int32_t py = top; py <= bottom && !untouched; ++py)
+        {
+          for (int32_t px = left; px <= right; ++px)
+          {
+            size_t idx = (px + py * cw) * pixel_bytes;
+            if (memcmp(&img0[idx], &img1[idx], pixel_bytes)) { untouched = true; break; }
+          }
+        }
+        if (untouched)
+        { // choose a transparent value that is not used by the drawn pixels.
+          uint32_t mask = (1u << (pixel_bytes << 3)) - 1;
+          uint32_t candidate = 0;
+          bool found = false;
+          for (uint32_t k = 0; k < 256 && !found; ++k)
+          {
+            candidate = (k * 0x9E3779B1u) & mask;
+            found = true;
+            for (int32_t py = top; py <= bottom && found; ++py)
+            {
+              for (int32_t px = left; px <= right; ++px)
+              {
+                size_t idx = (px + py * cw) * pixel_bytes;
+                if (memcmp(&img0[idx], &img1[idx], pixel_bytes) == 0 && read_raw(&img0[idx], pixel_bytes) == candidate) { found = false; break; }
+              }
+            }
+          }
+          if (!found) { kind = kind_uncacheable; break; }
+          transp = candidate;
+        }
+        image_bytes = bw * bh * pixel_bytes;
+      }
+      else
+      if (binary)
+      {
+        kind = kind_mask1;
+        image_bytes = ((bw + 7) >> 3) * bh;
+      }
+      else
+      {
+        // an anti-aliased text over an unreadable panel is blended with the base color, not with the screen.
+        if (!gfx->isReadable()) { break; }
+        kind = kind_mask8;
+        image_bytes = bw * bh;
+      }
+    } while (0);
+
+    if (kind == kind_uncacheable || kind == kind_empty) { image_bytes = 0; }
+
+    size_t text_bytes = (len + 4) & ~3u;
+    size_t bytes = sizeof(entry_t) + text_bytes + image_bytes;
+    auto entry = (entry_t*)heap_alloc(bytes);
+    if (entry == nullptr) { return nullptr; }
+
+    entry->font = font;
+    entry->style = *style;
+    entry->hash = hash;
+    entry->transp = transp;
+    entry->bytes = bytes;
+    entry->text_len = len;
+    entry->datum = datum;
+    entry->depth = gfx->getColorDepth();
+    entry->kind = kind;
+    entry->x = bx - ox;
+    entry->y = by - oy;
+    entry->w = bw;
+    entry->h = bh;
+    entry->sum_x = sum_x;
+    memcpy(entry->text(), string, len);
+    entry->text()[len] = 0;
+
+    if (image_bytes)
+    {
+      auto dst = entry->image();
+      auto img0 = static_cast<const uint8_t*>(canvas[0].getBuffer());
+      auto img1 = static_cast<const uint8_t*>(canvas[1].getBuffer());
+      if (kind == kind_mask1)
+      {
+        memset(dst, 0, image_bytes);
+        size_t stride = (bw + 7) >> 3;
+        for (int32_t py = 0; py < bh; ++py)
+        {
+          auto src = &img0[bx + (by + py) * cw];
+          for (int32_t px = 0; px < bw; ++px)
+          {
+            if (src[px]) { dst[py * stride + (px >> 3)] |= 0x80 >> (px & 7); }
+          }
+        }
+      }
+      else
+      {
+        size_t row = bw * pixel_bytes;
+        for (int32_t py = 0; py < bh; ++py)
+        {
+          size_t idx = (bx + (by + py) * cw) * pixel_bytes;
+          memcpy(&dst[py * row], &img0[idx], row);
+          if (transp == pixelcopy_t::NON_TRANSP) { continue; }
+          for (size_t i = 0; i < row; i += pixel_bytes)
+          {
+            if (memcmp(&img0[idx + i], &img1[idx + i], pixel_bytes))
+            {
+              write_raw(&dst[py * row + i], pixel_bytes, transp);
+            }
+          }
+        }
+      }
+    }
+    return entry;
+  }
+
+//----------------------------------------------------------------------------
+ }
+}
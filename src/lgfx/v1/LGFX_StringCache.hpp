@@ -0,0 +1,114 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [FreeBSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "misc/enum.hpp"
+#include "lgfx_fonts.hpp"
+#include "Panel.hpp"
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  class LGFXBase;
+
+  /// @brief drawString の描画結果を保持するキャッシュ (LRU)。LGFXBase::setStringCacheSize で有効になる。;
+  /// Keeps the rendered result of drawString (LRU). Enabled by LGFXBase::setStringCacheSize.
+  /// 背景色ありの文字列は出力先の形式の画像、透過の文字列は 1bit または 8bit のマスクとして保持する。;
+  /// Text with a background is kept as an image in the target format, transparent text as a 1bit or 8bit mask.
+  class LGFX_StringCache
+  {
+  public:
+    LGFX_StringCache(void) = default;
+    ~LGFX_StringCache(void) { clear(); }
+
+    /// @param bytes total size of the cached entries. 0 = unlimited.
+    void setMaxBytes(size_t bytes);
+    size_t getMaxBytes(void) const { return _max_bytes; }
+    size_t getBytes(void) const { return _bytes; }
+    uint32_t getCount(void) const { return _count; }
+    uint32_t getHitCount(void) const { return _hit_count; }
+    uint32_t getMissCount(void) const { return _miss_count; }
+
+    void clear(void);
+
+    /// Draws the string from the cache, rendering and storing it first on a miss.
+    /// @return false if the string can not be cached. the caller draws it as usual.
+    bool draw(LGFXBase* gfx, IPanel* panel, const char* string, int32_t x, int32_t y, textdatum_t datum, const IFont* font, const TextStyle* style, size_t* result);
+
+  protected:
+    enum entry_kind_t : uint8_t
+    {
+      kind_uncacheable, // drawn as usual every time (e.g. anti-aliased text on an unreadable panel)
+      kind_empty,       // nothing is drawn
+      kind_native,      // pixels in the target format, with a transparent value for the untouched pixels
+      kind_mask1,       // 1bit mask of the foreground
+      kind_mask8,       // 8bit alpha mask of the foreground
+    };
+
+    struct entry_t
+    {
+      entry_t* prev;
+      entry_t* next;
+      entry_t* hash_next;
+      const IFont* font;
+      TextStyle style;
+      uint32_t hash;
+      uint32_t transp;
+      uint32_t bytes;
+      uint16_t text_len;
+      textdatum_t datum;
+      color_depth_t depth;
+      entry_kind_t kind;
+      int16_t x;        // offset of the image from the drawing position
+      int16_t y;
+      uint16_t w;
+      uint16_t h;
+      int32_t sum_x;    // return value of drawString
+      // followed by the text (text_len + 1 bytes) and the image.
+      char* text(void) { return reinterpret_cast<char*>(this + 1); }
+      uint8_t* image(void) { return reinterpret_cast<uint8_t*>(this + 1) + ((text_len + 4) & ~3u); }
+    };
+
+    static constexpr size_t hash_size = 64;
+
+    entry_t* _hash[hash_size] = {};
+    entry_t* _head = nullptr;  // most recently used
+    entry_t* _tail = nullptr;  // least recently used
+    size_t _bytes = 0;
+    size_t _max_bytes = 0;
+    uint32_t _count = 0;
+    uint32_t _hit_count = 0;
+    uint32_t _miss_count = 0;
+
+    entry_t* find(const char* string, size_t len, uint32_t hash, textdatum_t datum, const IFont* font, const TextStyle* style, color_depth_t depth);
+    entry_t* render(LGFXBase* gfx, const char* string, size_t len, uint32_t hash, textdatum_t datum, const IFont* font, const TextStyle* style);
+    void push(LGFXBase* gfx, IPanel* panel, entry_t* entry, int32_t x, int32_t y);
+    void insert(entry_t* entry);
+    void remove(entry_t* entry);
+    void unlink(entry_t* entry);
+  };
+
+//----------------------------------------------------------------------------
+ }
+}
@@ -23,6 +23,7 @@ Contributors:
 #include "misc/enum.hpp"
 #include "misc/colortype.hpp"
 #include "misc/pixelcopy.hpp"
+#include "misc/perf_counter.hpp"
 
 namespace lgfx
 {
@@ -77,15 +78,19 @@ namespace lgfx
     };
     uint8_t _rotation = 0;
     epd_mode_t _epd_mode = (epd_mode_t)0;  // EPDでない場合は0。それ以外の場合はEPD描画モード;
+    bool _grayscale = false;  // 輝度のみを表示するパネル (EPD,モノクロOLED等);
     bool _invert = false;
     bool _auto_display = false;
+#if defined ( LGFX_USE_PERF_COUNTER )
+    panel_perf_counter_t _perf = {};
+#endif
 
   public:
     IPanel(void) = default;
     virtual ~IPanel(void) = default;
 
-    void startWrite(bool transaction = true) { if (1 == ++_start_count && transaction) { beginTransaction(); } }
-    void endWrite(void) { if (_start_count) {  if (0 == --_start_count) { if (_auto_display) { display(0,0,0,0); } endTransaction(); } } }
+    void startWrite(bool transaction = true) { if (1 == ++_start_count && transaction) { LGFX_PERF_COUNT(++_perf.begin_transaction); beginTransaction(); } }
+    void endWrite(void) { if (_start_count) {  if (0 == --_start_count) { if (_auto_display) { display(0,0,0,0); } LGFX_PERF_COUNT(++_perf.end_transaction); endTransaction(); } } }
     uint32_t getStartCount(void) const { return _start_count; }
     color_depth_t getWriteDepth(void) const { return _write_depth; }
     color_depth_t getReadDepth(void) const { return _read_depth; }
@@ -97,9 +102,20 @@ namespace lgfx
     epd_mode_t getEpdMode(void) const { return _epd_mode; }
     void setEpdMode(epd_mode_t epd_mode) { if (_epd_mode && epd_mode) _epd_mode = epd_mode; }
     bool isEpd(void) const { return _epd_mode; }
+    /// 色を輝度に変換して表示するパネルか否か (画像のデコードで色差を省略できる);
+    /// whether the panel shows only the luminance of the colors. (the image decoders may skip the chroma)
+    bool isGrayscale(void) const { return _grayscale; }
     bool getAutoDisplay(void) const { return _auto_display; }
     void setAutoDisplay(bool auto_display) { _auto_display = auto_display; }
 
+#if defined ( LGFX_USE_PERF_COUNTER )
+    panel_perf_counter_t* getPerfCounter(void) { return &_perf; }
+
+    /// バスの性能計測カウンタを取得する。バスを持たないパネルは nullptr を返す。;
+    /// Obtains the performance counter of the bus. nullptr if the panel has no bus.
+    virtual bus_perf_counter_t* getBusPerfCounter(void) { return nullptr; }
+#endif
+
     virtual void beginTransaction(void) = 0;
     virtual void endTransaction(void) = 0;
 
@@ -141,6 +157,15 @@ namespace lgfx
     /// @return -1=unsupported. / 0~height= current scanline position.
     virtual int32_t getScanLine(void) { return -1; }
 
+    /// Obtains the memory of a line when the panel holds its pixels in directly addressable memory.
+    /// @return nullptr=unsupported. / pointer to the first pixel of line y, indexed by x without conversion.
+    /// @attention Only available when the pixels are byte aligned and not rotated.
+    virtual void* getFrameBufferLine(uint_fast16_t y) { (void)y; return nullptr; }
+
+    /// getFrameBufferLine で得たメモリに直接書込んだ範囲をパネルへ通知する。;
+    /// Tells the panel that the area was written directly through getFrameBufferLine. (cache write back, modified area)
+    virtual void commitFrameBuffer(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h) { (void)x; (void)y; (void)w; (void)h; }
+
     virtual void writeFillRectAlphaPreclipped(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t argb8888)
     {
       effect(x, y, w, h, effect_fill_alpha ( argb8888_t { argb8888 } ) );
@@ -166,14 +191,20 @@ namespace lgfx
       startWrite();
       do
       {
+        // a rotated panel changes the step of the pixelcopy, so reset it for each line.
+        pc_read.src_x32_add = 1 << pixelcopy_t::FP_SCALE;
+        pc_read.src_y32_add = 0;
         readRect(x, y, w, 1, buf, &pc_read);
         size_t i = 0;
         do
         {
           effector(x + i, y, buf[i]);
         } while (++i < w);
-        writeImage(x, y, w, 1, &pc_write, true);
         pc_write.src_x32 = 0;
+        pc_write.src_y32 = 0;
+        pc_write.src_x32_add = 1 << pixelcopy_t::FP_SCALE;
+        pc_write.src_y32_add = 0;
+        writeImage(x, y, w, 1, &pc_write, true);
       } while (++y < ye);
       endWrite();
     }
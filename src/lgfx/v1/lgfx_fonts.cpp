@@ -737,6 +737,7 @@ label_nextbyte: /// 次のデータを取得する;
   bool VLWfont::unloadFont(void)
   {
     _fontLoaded = false;
+    release_glyph_cache();
     if (gUnicode)  { heap_free(gUnicode);  gUnicode  = nullptr; }
     if (gWidth)    { heap_free(gWidth);    gWidth    = nullptr; }
     if (gxAdvance) { heap_free(gxAdvance); gxAdvance = nullptr; }
@@ -766,6 +767,10 @@ label_nextbyte: /// 次のデータを取得する;
         metrics->width     = gWidth[gNum];
         metrics->x_advance = gxAdvance[gNum];
         metrics->x_offset  = gdX[gNum];
+      } else if (auto glyph = get_glyph_cache(gNum)) {
+        metrics->width     = glyph->width;
+        metrics->x_advance = glyph->x_advance;
+        metrics->x_offset  = glyph->dx;
       } else {
         auto file = _fontData;
 
@@ -874,14 +879,204 @@ label_nextbyte: /// 次のデータを取得する;
     return true;
   }
 
+  bool VLWfont::setGlyphCache(uint16_t max_glyphs, size_t max_bytes)
+  {
+    release_glyph_cache();
+    _cache_max_bytes = max_bytes;
+    if (!_fontLoaded || max_glyphs == 0) return true;
+    if (max_glyphs > gCount) max_glyphs = gCount;
+    if (max_glyphs == 0xFFFF) max_glyphs = 0xFFFE;
+
+    _cache      = (glyph_cache_t*)heap_alloc_psram(max_glyphs * sizeof(glyph_cache_t));
+    _cache_slot =      (uint16_t*)heap_alloc_psram(gCount * sizeof(uint16_t));
+    if (nullptr == _cache     ) _cache      = (glyph_cache_t*)heap_alloc(max_glyphs * sizeof(glyph_cache_t));
+    if (nullptr == _cache_slot) _cache_slot =      (uint16_t*)heap_alloc(gCount * sizeof(uint16_t));
+    if (!_cache || !_cache_slot)
+    {
+      release_glyph_cache();
+      return false;
+    }
+    memset(_cache_slot, 0xFF, gCount * sizeof(uint16_t));
+    _cache_capacity = max_glyphs;
+    return true;
+  }
+
+  void VLWfont::clearGlyphCache(void)
+  {
+    for (size_t i = 0; i < _cache_count; ++i)
+    {
+      heap_free(_cache[i].bitmap);
+      _cache_slot[_cache[i].index] = 0xFFFF;
+    }
+    _cache_count = 0;
+    _cache_bytes = 0;
+    _cache_head = 0xFFFF;
+    _cache_tail = 0xFFFF;
+  }
+
+  void VLWfont::release_glyph_cache(void)
+  {
+    clearGlyphCache();
+    if (_cache)      { heap_free(_cache);      _cache      = nullptr; }
+    if (_cache_slot) { heap_free(_cache_slot); _cache_slot = nullptr; }
+    _cache_capacity = 0;
+  }
+
+  size_t VLWfont::preloadGlyphs(uint16_t first, uint16_t last)
+  {
+    if (!_cache_capacity || !gCount) return 0;
+    // `first` need not be in the font, the range starts at the next glyph. nothing when all the glyphs are below `first`.
+    uint16_t gNum = gCount;
+    getUnicodeIndex(first, &gNum);
+    if (gNum >= gCount) return 0;
+    size_t result = 0;
+    _fontData->preRead();
+    for (; gNum < gCount && gUnicode[gNum] <= last; ++gNum)
+    {
+      if (_cache_count == _cache_capacity) break; // do not evict the glyphs preloaded so far.
+      if (_cache_slot[gNum] == 0xFFFF && load_glyph_cache(gNum) == nullptr) break;
+      ++result;
+    }
+    _fontData->postRead();
+    return result;
+  }
+
+  const VLWfont::glyph_cache_t* VLWfont::get_glyph_cache(uint16_t gNum) const
+  {
+    if (!_cache_capacity) return nullptr;
+    uint16_t idx = _cache_slot[gNum];
+    if (idx == 0xFFFF)
+    {
+      _fontData->preRead();
+      auto res = load_glyph_cache(gNum);
+      _fontData->postRead();
+      return res;
+    }
+
+    auto glyph = &_cache[idx];
+    if (idx != _cache_head)
+    { // move to the head of the list.
+      _cache[glyph->prev].next = glyph->next;
+      if (glyph->next != 0xFFFF) { _cache[glyph->next].prev = glyph->prev; }
+      else                       { _cache_tail = glyph->prev; }
+      glyph->prev = 0xFFFF;
+      glyph->next = _cache_head;
+      _cache[_cache_head].prev = idx;
+      _cache_head = idx;
+    }
+    return glyph;
+  }
+
+  const VLWfont::glyph_cache_t* VLWfont::load_glyph_cache(uint16_t gNum) const
+  {
+    auto file = _fontData;
+    uint32_t buffer[6];
+    file->seek(28 + gNum * 28);
+    file->read((uint8_t*)buffer, 24);
+
+    int32_t h = getSwap32(buffer[0]);
+    int32_t w = getSwap32(buffer[1]);
+    size_t len = w * h;
+    if (_cache_max_bytes && len > _cache_max_bytes) return nullptr;
+
+    uint16_t idx;
+    uint8_t* bitmap = nullptr;
+    for (;;)
+    {
+      if (_cache_count < _cache_capacity && (!_cache_max_bytes || _cache_bytes + len <= _cache_max_bytes))
+      {
+        bitmap = (uint8_t*)heap_alloc_psram(len ? len : 1);
+        if (nullptr == bitmap) bitmap = (uint8_t*)heap_alloc(len ? len : 1);
+        if (bitmap)
+        {
+          idx = _cache_count++;
+          break;
+        }
+      }
+      if (_cache_tail == 0xFFFF) return nullptr;
+
+      // evict the least recently used glyph.
+      idx = _cache_tail;
+      auto glyph = &_cache[idx];
+      _cache_tail = glyph->prev;
+      if (_cache_tail != 0xFFFF) { _cache[_cache_tail].next = 0xFFFF; }
+      else                       { _cache_head = 0xFFFF; }
+      _cache_slot[glyph->index] = 0xFFFF;
+      _cache_bytes -= glyph->width * glyph->height;
+      heap_free(glyph->bitmap);
+
+      // keep the entries packed, so that the first _cache_count entries are in use.
+      uint16_t last = --_cache_count;
+      if (idx != last)
+      {
+        _cache[idx] = _cache[last];
+        auto moved = &_cache[idx];
+        _cache_slot[moved->index] = idx;
+        if (moved->prev != 0xFFFF) { _cache[moved->prev].next = idx; } else { _cache_head = idx; }
+        if (moved->next != 0xFFFF) { _cache[moved->next].prev = idx; } else { _cache_tail = idx; }
+      }
+    }
+
+    file->seek(gBitmap[gNum]);
+    file->read(bitmap, len);
+
+    auto glyph = &_cache[idx];
+    glyph->bitmap    = bitmap;
+    glyph->index     = gNum;
+    glyph->height    = h;
+    glyph->width     = w;
+    glyph->x_advance = getSwap32(buffer[2]);
+    glyph->dy        = (int16_t)getSwap32(buffer[3]);
+    glyph->dx        = (int8_t)getSwap32(buffer[4]);
+    glyph->prev      = 0xFFFF;
+    glyph->next      = _cache_head;
+    if (_cache_head != 0xFFFF) { _cache[_cache_head].prev = idx; }
+    else                       { _cache_tail = idx; }
+    _cache_head = idx;
+    _cache_slot[gNum] = idx;
+    _cache_bytes += len;
+    return glyph;
+  }
+
 //----------------------------------------------------------------------------
 
+  // stores a run of anti-aliased glyph pixels in the destination color format.
+  template <typename T>
+  static void compose_alpha_run(T* dst, const uint8_t* cover, int32_t len, const uint32_t* colortbl, const color_conv_t* conv, uint32_t fore, uint32_t back)
+  {
+    int32_t fore_r = (fore >> 16) & 0xFF;
+    int32_t fore_g = (fore >>  8) & 0xFF;
+    int32_t fore_b =  fore        & 0xFF;
+    int32_t back_r = (back >> 16) & 0xFF;
+    int32_t back_g = (back >>  8) & 0xFF;
+    int32_t back_b =  back        & 0xFF;
+    uint_fast8_t last_a = 0;
+    uint32_t last_raw = colortbl[0];
+    do {
+      uint_fast8_t a = *cover++;
+      if (a == 0) { dst->set(colortbl[0]); }
+      else if (a == 0xFF) { dst->set(colortbl[1]); }
+      else {
+        if (last_a != a) {
+          last_a = a;
+          int32_t p = 1 + a;
+          last_raw = conv->convert_rgb888(color888( ( fore_r * p + back_r * (257 - p)) >> 8
+                                           , ( fore_g * p + back_g * (257 - p)) >> 8
+                                           , ( fore_b * p + back_b * (257 - p)) >> 8 ));
+        }
+        dst->set(last_raw);
+      }
+      ++dst;
+    } while (--len);
+  }
+
   size_t VLWfont::drawChar(LGFXBase* gfx, int32_t x, int32_t y, uint16_t code, const TextStyle* style, FontMetrics* metrics, int32_t& filled_x) const
   {
     auto file = this->_fontData;
 
     uint32_t buffer[6] = {0};
     uint16_t gNum = 0;
+    const glyph_cache_t* glyph = nullptr;
 
     int32_t sy = 65536 * style->size_y;
     y += (metrics->y_offset * sy) >> 16;
@@ -891,27 +1086,41 @@ label_nextbyte: /// 次のデータを取得する;
       buffer[2] = getSwap32(this->spaceWidth);
     } else if (!this->getUnicodeIndex(code, &gNum)) {
       return drawCharDummy(gfx, x, y, this->spaceWidth, metrics->height, style, filled_x);
-    } else {
+    } else if (nullptr == (glyph = get_glyph_cache(gNum))) {
       file->preRead();
       file->seek(28 + gNum * 28);
       file->read((uint8_t*)buffer, 24);
       file->seek(this->gBitmap[gNum]);
     }
 
-
-    int32_t h        = getSwap32(buffer[0]); // Height of glyph
-    int32_t w        = getSwap32(buffer[1]); // Width of glyph
     int32_t sx       = 65536 * style->size_x;
-    int32_t xAdvance = (getSwap32(buffer[2]) * sx) >> 16; // xAdvance - to move x cursor
-    int32_t xoffset  = ((int32_t)((int8_t)getSwap32(buffer[4])) * sx) >> 16; // x delta from cursor
-    int32_t dY       = (int16_t)getSwap32(buffer[3]); // y delta from baseline
+    int32_t h, w, xAdvance, xoffset, dY;
+    if (glyph) {
+      h        = glyph->height;
+      w        = glyph->width;
+      xAdvance = (glyph->x_advance * sx) >> 16;
+      xoffset  = (glyph->dx * sx) >> 16;
+      dY       = glyph->dy;
+    } else {
+      h        = getSwap32(buffer[0]); // Height of glyph
+      w        = getSwap32(buffer[1]); // Width of glyph
+      xAdvance = (getSwap32(buffer[2]) * sx) >> 16; // xAdvance - to move x cursor
+      xoffset  = ((int32_t)((int8_t)getSwap32(buffer[4])) * sx) >> 16; // x delta from cursor
+      dY       = (int16_t)getSwap32(buffer[3]); // y delta from baseline
+    }
     int32_t yoffset  = (this->maxAscent - dY);
 //      int32_t yoffset = (gfx->_font_metrics.y_offset) - dY;
 
-    auto pixel = (uint8_t*)alloca(w * h);
-    if (gNum != 0xFFFF) {
-      file->read(pixel, w * h);
-      file->postRead();
+    const uint8_t* pixel;
+    if (glyph) {
+      pixel = glyph->bitmap;
+    } else {
+      auto tmp = (uint8_t*)alloca(w * h);
+      if (gNum != 0xFFFF) {
+        file->read(tmp, w * h);
+        file->postRead();
+      }
+      pixel = tmp;
     }
 
     gfx->startWrite();
@@ -967,97 +1176,181 @@ label_nextbyte: /// 次のデータを取得する;
           int32_t back_r = ((back>>16)&0xFF);
           int32_t back_g = ((back>> 8)&0xFF);
           int32_t back_b = ( back     &0xFF);
-          int32_t i = 0;
-          int32_t y0, y1 = (yoffset * sy) >> 16;
-          do {
-            y0 = y1;
-            if (y0 > (clip_bottom - y)) break;
-            y1 = ((yoffset + i + 1) * sy) >> 16;
+          auto conv = gfx->getColorConverter();
+          if (!gfx->hasPalette() && (conv->bits & 7) == 0 && conv->bytes <= 3)
+          { // compose each line in the destination color format, and send each run of drawn pixels at once.
+            size_t bytes = conv->bytes;
+            int32_t lx = x;
+            int32_t rx = x + ((w * sx) >> 16);
             if (left < right) {
-              gfx->setRawColor(colortbl[0]);
-              gfx->writeFillRect(left, y + y0, right - left, y1 - y0);
+              lx = std::min(lx, left);
+              rx = std::max(rx, right);
             }
-            int32_t j = 0;
-            do {
-              int32_t x0 = (j * sx) >> 16;
-              while (pixel[j] != 0xFF) {
-                int32_t x1 = ((j + 1) * sx) >> 16;
-                if (pixel[j] != 0 && x0 < x1) {
-                  int32_t p = 1 + (uint32_t)pixel[j];
-                  gfx->setColor(color888( ( fore_r * p + back_r * (257 - p)) >> 8
-                                        , ( fore_g * p + back_g * (257 - p)) >> 8
-                                        , ( fore_b * p + back_b * (257 - p)) >> 8 ));
-                  gfx->writeFillRect(x + x0, y + y0, x1 - x0, y1 - y0);
+            if (lx < clip_left) lx = clip_left;
+            if (rx > clip_right + 1) rx = clip_right + 1;
+            int32_t lw = rx - lx;
+            if (0 < lw) {
+              auto cover = (uint8_t*)alloca(lw);
+              auto buf = (uint8_t*)alloca(lw * ((sy + 65535) >> 16) * bytes);
+              pixelcopy_t p_(buf, conv->depth, conv->depth);
+              int32_t i = 0;
+              int32_t y0, y1 = (yoffset * sy) >> 16;
+              do {
+                y0 = y1;
+                if (y0 > (clip_bottom - y)) break;
+                y1 = ((yoffset + i + 1) * sy) >> 16;
+                int32_t bh = y1 - y0;
+                if (0 < bh) {
+                  memset(cover, 0, lw);
+                  if (sx == 65536) {
+                    int32_t x0 = x - lx;
+                    int32_t j0 = x0 < 0 ? -x0 : 0;
+                    int32_t j1 = std::min(w, lw - x0);
+                    if (j0 < j1) { memcpy(&cover[x0 + j0], &pixel[j0], j1 - j0); }
+                  } else {
+                    for (int32_t j = 0; j < w; ++j) {
+                      if (!pixel[j]) continue;
+                      int32_t x0 = x + ((j * sx) >> 16) - lx;
+                      int32_t x1 = x + (((j + 1) * sx) >> 16) - lx;
+                      if (x0 < 0) x0 = 0;
+                      if (x1 > lw) x1 = lw;
+                      while (x0 < x1) { cover[x0++] = pixel[j]; }
+                    }
+                  }
+                  // pixels not covered by the glyph are drawn only inside the background area.
+                  int32_t bl = left - lx;
+                  int32_t br = right - lx;
+                  int32_t k = 0;
+                  for (;;) {
+                    while (k < lw && !cover[k] && (k < bl || br <= k)) { ++k; }
+                    if (k == lw) break;
+                    int32_t k0 = k;
+                    do { ++k; } while (k < lw && (cover[k] || (bl <= k && k < br)));
+                    switch (bytes) {
+                    case 1:  compose_alpha_run((rgb332_t* )buf, &cover[k0], k - k0, colortbl, conv, style->fore_rgb888, back); break;
+                    case 2:  compose_alpha_run((swap565_t*)buf, &cover[k0], k - k0, colortbl, conv, style->fore_rgb888, back); break;
+                    default: compose_alpha_run((bgr888_t* )buf, &cover[k0], k - k0, colortbl, conv, style->fore_rgb888, back); break;
+                    }
+                    size_t len = (k - k0) * bytes;
+                    for (int32_t yy = 1; yy < bh; ++yy) {
+                      memcpy(&buf[yy * len], buf, len);
+                    }
+                    p_.src_x32_add = 1 << pixelcopy_t::FP_SCALE;  // may be changed by a rotated panel.
+                    p_.src_y32_add = 0;
+                    gfx->pushImage(lx + k0, y + y0, k - k0, bh, &p_);
+                  }
                 }
-                x0 = x1;
-                if (++j == w || (clip_right - x) < x0) break;
+                pixel += w;
+              } while (++i < h);
+            }
+          }
+          else
+          {
+            int32_t i = 0;
+            int32_t y0, y1 = (yoffset * sy) >> 16;
+            do {
+              y0 = y1;
+              if (y0 > (clip_bottom - y)) break;
+              y1 = ((yoffset + i + 1) * sy) >> 16;
+              if (left < right) {
+                gfx->setRawColor(colortbl[0]);
+                gfx->writeFillRect(left, y + y0, right - left, y1 - y0);
               }
-              if (j == w || (clip_right - x) < x0) break;
-              gfx->setRawColor(colortbl[1]);
-              do { ++j; } while (j != w && pixel[j] == 0xFF);
-              gfx->writeFillRect(x + x0, y + y0, ((j * sx) >> 16) - x0, y1 - y0);
-            } while (j != w);
-            pixel += w;
-          } while (++i < h);
+              int32_t j = 0;
+              do {
+                int32_t x0 = (j * sx) >> 16;
+                while (pixel[j] != 0xFF) {
+                  int32_t x1 = ((j + 1) * sx) >> 16;
+                  if (pixel[j] != 0 && x0 < x1) {
+                    int32_t p = 1 + (uint32_t)pixel[j];
+                    gfx->setColor(color888( ( fore_r * p + back_r * (257 - p)) >> 8
+                                          , ( fore_g * p + back_g * (257 - p)) >> 8
+                                          , ( fore_b * p + back_b * (257 - p)) >> 8 ));
+                    gfx->writeFillRect(x + x0, y + y0, x1 - x0, y1 - y0);
+                  }
+                  x0 = x1;
+                  if (++j == w || (clip_right - x) < x0) break;
+                }
+                if (j == w || (clip_right - x) < x0) break;
+                gfx->setRawColor(colortbl[1]);
+                do { ++j; } while (j != w && pixel[j] == 0xFF);
+                gfx->writeFillRect(x + x0, y + y0, ((j * sx) >> 16) - x0, y1 - y0);
+              } while (j != w);
+              pixel += w;
+            } while (++i < h);
+          }
         }
       }
       else // alpha blend mode
-      {
-        auto buf = (bgr888_t*)alloca((bw * ((sy + 65535) >> 16)) * sizeof(bgr888_t));
-
-        pixelcopy_t p_(buf, gfx->getColorConverter()->depth, rgb888_3Byte, gfx->hasPalette());
-        int32_t y0, y1 = (yoffset * sy) >> 16;
-        int32_t i = 0;
-        do {
-          y0 = y1;
-          if (y0 > (clip_bottom - y)) break;
-          y1 = ((yoffset + i + 1) * sy) >> 16;
-          int32_t by = y + y0;
-          int32_t bh = y1 - y0;
-
-          if (by < clip_top) { bh += by - clip_top; by = clip_top; }
-          if (bh > 0) {
-            int32_t j0 = 0;
-
-            // search first and last pixel
-            while (j0 != w && !pixel[j0    ]) { ++j0; }
-            if (j0 != w) {
-              int32_t j1 = w;
-              while (j0 != j1 && !pixel[j1 - 1]) { --j1; }
-              int32_t rx = (j0 * sx) >> 16;
-              int32_t rw = (j1 * sx) >> 16;
-              if (rx < bx    -x) rx = bx    -x;
-              if (rw > bx+bw -x) rw = bx+bw -x;
-              rw -= rx;
-
-              if (0 < rw) {
-                gfx->readRectRGB(x + rx, by, rw, bh, (uint8_t*)buf);
-
-                int32_t x0, x1 = ((j0 * sx) >> 16) - rx;
-                do {
-                  x0 = x1;
+      { // read, blend and write back the drawn area of the glyph at once.
+        int32_t i0 = h, i1 = 0, j0 = w, j1 = 0;
+        for (int32_t i = 0; i < h; ++i) {
+          auto src = &pixel[i * w];
+          for (int32_t j = 0; j < w; ++j) {
+            if (!src[j]) continue;
+            if (i0 > i) i0 = i;
+            i1 = i + 1;
+            if (j0 > j) j0 = j;
+            if (j1 <= j) j1 = j + 1;
+          }
+        }
+        int32_t rx = (j0 * sx) >> 16;
+        int32_t rw = (j1 * sx) >> 16;
+        if (rx < bx    -x) rx = bx    -x;
+        if (rw > bx+bw -x) rw = bx+bw -x;
+        rw -= rx;
+
+        if (0 < rw && i0 < i1) {
+          // the area is split into blocks only when it is too large for the stack.
+          static constexpr int32_t block_bytes = 4096;
+          int32_t max_h = std::max<int32_t>((sy + 65535) >> 16, block_bytes / (rw * (int32_t)sizeof(bgr888_t)));
+          auto buf = (bgr888_t*)alloca(rw * max_h * sizeof(bgr888_t));
+          pixelcopy_t p_(buf, gfx->getColorConverter()->depth, rgb888_3Byte, gfx->hasPalette());
+
+          int32_t i = i0;
+          do {
+            int32_t top = ((yoffset + i) * sy) >> 16;
+            int32_t ie = i + 1;
+            while (ie < i1 && (((yoffset + ie + 1) * sy) >> 16) - top <= max_h) { ++ie; }
+            int32_t by = y + top;
+            if (by > clip_bottom) break;
+            int32_t bh = (((yoffset + ie) * sy) >> 16) - top;
+            if (bh > clip_bottom + 1 - by) bh = clip_bottom + 1 - by;
+            int32_t skip = 0;
+            if (by < clip_top) { skip = clip_top - by; by = clip_top; bh -= skip; }
+            if (0 < bh) {
+              gfx->readRectRGB(x + rx, by, rw, bh, (uint8_t*)buf);
+              for (int32_t ii = i; ii < ie; ++ii) {
+                int32_t r0 = (((yoffset + ii    ) * sy) >> 16) - top - skip;
+                int32_t r1 = (((yoffset + ii + 1) * sy) >> 16) - top - skip;
+                if (r0 < 0) r0 = 0;
+                if (r1 > bh) r1 = bh;
+                if (r0 >= r1) continue;
+                auto src = &pixel[ii * w];
+                for (int32_t j = j0; j < j1; ++j) {
+                  if (!src[j]) continue;
+                  int32_t x0 = ((j * sx) >> 16) - rx;
+                  int32_t x1 = (((j + 1) * sx) >> 16) - rx;
                   if (x0 < 0) x0 = 0;
-                  x1 = (int)(((j0 + 1) * sx) >> 16) - rx;
                   if (x1 > rw) x1 = rw;
-                  if (pixel[j0] && x0 < x1) {
-                    int32_t p = 1 + pixel[j0];
-                    do {
-                      int32_t yy = 0;
-                      do {
-                        auto bgr = &buf[x0 + yy * rw];
-                        bgr->r = ( fore_r * p + bgr->r * (257 - p)) >> 8;
-                        bgr->g = ( fore_g * p + bgr->g * (257 - p)) >> 8;
-                        bgr->b = ( fore_b * p + bgr->b * (257 - p)) >> 8;
-                      } while (++yy != bh);
-                    } while (++x0 != x1);
+                  int32_t p = 1 + src[j];
+                  for (int32_t yy = r0; yy < r1; ++yy) {
+                    for (int32_t xx = x0; xx < x1; ++xx) {
+                      auto bgr = &buf[xx + yy * rw];
+                      bgr->r = ( fore_r * p + bgr->r * (257 - p)) >> 8;
+                      bgr->g = ( fore_g * p + bgr->g * (257 - p)) >> 8;
+                      bgr->b = ( fore_b * p + bgr->b * (257 - p)) >> 8;
+                    }
                   }
-                } while (++j0 < j1);
-                gfx->pushImage(x + rx, by, rw, bh, &p_);
+                }
               }
+              p_.src_x32_add = 1 << pixelcopy_t::FP_SCALE;
+              p_.src_y32_add = 0;
+              gfx->pushImage(x + rx, by, rw, bh, &p_);
             }
-          }
-          pixel += w;
-        } while (++i < h);
+            i = ie;
+          } while (i < i1);
+        }
       }
     }
     gfx->endWrite();
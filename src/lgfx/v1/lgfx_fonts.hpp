@@ -256,6 +256,44 @@ namespace lgfx
     bool updateFontMetric(FontMetrics *metrics, uint16_t uniCode) const override;
 
     bool getUnicodeIndex(uint16_t unicode, uint16_t *index) const;
+
+    /// Enables an LRU cache of glyph headers and bitmaps, so that repeated glyphs are drawn without reading the font file.
+    /// @param max_glyphs number of glyphs kept in memory. 0 = disable the cache.
+    /// @param max_bytes total size of the cached bitmaps. 0 = unlimited.
+    bool setGlyphCache(uint16_t max_glyphs, size_t max_bytes = 0);
+
+    /// Reads the glyphs of the code range [first, last] into the cache. (e.g. 0x20~0x7E for ASCII)
+    /// @return number of glyphs cached.
+    size_t preloadGlyphs(uint16_t first = 0x20, uint16_t last = 0x7E);
+
+    void clearGlyphCache(void);
+
+  protected:
+    struct glyph_cache_t
+    {
+      uint8_t* bitmap;
+      uint16_t index;   // glyph number
+      uint16_t prev;    // toward the most recently used
+      uint16_t next;    // toward the least recently used
+      int16_t  height;
+      uint8_t  width;
+      uint8_t  x_advance;
+      int16_t  dy;
+      int8_t   dx;
+    };
+
+    const glyph_cache_t* get_glyph_cache(uint16_t gNum) const;
+    const glyph_cache_t* load_glyph_cache(uint16_t gNum) const;
+    void release_glyph_cache(void);
+
+    mutable glyph_cache_t* _cache = nullptr;
+    mutable uint16_t* _cache_slot = nullptr;  // glyph number -> cache entry
+    mutable size_t _cache_bytes = 0;
+    size_t _cache_max_bytes = 0;
+    uint16_t _cache_capacity = 0;
+    mutable uint16_t _cache_count = 0;
+    mutable uint16_t _cache_head = 0xFFFF;
+    mutable uint16_t _cache_tail = 0xFFFF;
   };
 
 //----------------------------------------------------------------------------
@@ -0,0 +1,278 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [FreeBSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+#if defined ( __linux__ )
+
+#include "Bus_Trace.hpp"
+#include "pixelcopy.hpp"
+
+#include <string.h>
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  Bus_Trace::~Bus_Trace(void)
+  {
+    release();
+  }
+
+  void Bus_Trace::config(const config_t& config)
+  {
+    _cfg = config;
+    if (_cfg.bus_width == 0) { _cfg.bus_width = 1; }
+  }
+
+  bool Bus_Trace::init(void)
+  {
+    release();
+    if (_cfg.file_path)
+    {
+      _fp = fopen(_cfg.file_path, "w");
+      if (_fp == nullptr) { return false; }
+    }
+    return true;
+  }
+
+  void Bus_Trace::release(void)
+  {
+    if (_fp)
+    {
+      flush_file();
+      fclose(_fp);
+      _fp = nullptr;
+    }
+  }
+
+  void Bus_Trace::clearTrace(void)
+  {
+    flush_file();
+    _entries.clear();
+    _data.clear();
+    _write_bytes = 0;
+    _read_bytes = 0;
+    _estimated_ns = 0;
+    _command_count = 0;
+    _transaction_count = 0;
+  }
+
+  uint64_t Bus_Trace::getEstimatedTime(void) const
+  {
+    return (uint64_t)_estimated_ns;
+  }
+
+  void Bus_Trace::add_time(uint64_t bytes, bool read)
+  {
+    uint32_t freq = read ? _cfg.freq_read : _cfg.freq_write;
+    if (freq == 0) { return; }
+    uint_fast8_t width = _cfg.bus_width;
+    uint64_t cycles = (bytes * 8 + width - 1) / width;
+    _estimated_ns += cycles * 1000000000.0 / freq;
+  }
+
+  void Bus_Trace::add_entry(trace_kind_t kind, const uint8_t* data, uint32_t length, uint32_t count)
+  {
+    if (!_cfg.record && _fp == nullptr) { return; }
+
+    if ((kind == trace_data || kind == trace_read) && !_entries.empty() && _entries.back().kind == kind)
+    { // consecutive data / reads are merged into one entry.
+      _entries.back().length += length;
+    }
+    else
+    {
+      _entries.push_back({ kind, (uint32_t)_data.size(), length, count });
+    }
+    if (data && length)
+    {
+      _data.insert(_data.end(), data, data + length);
+    }
+  }
+
+  void Bus_Trace::write_entries(FILE* fp, size_t begin, size_t end) const
+  {
+    static constexpr char kind_char[] = { 'B', 'E', 'C', 'D', 'R', 'r' };
+    static constexpr uint32_t line_bytes = 32;
+
+    for (size_t i = begin; i < end; ++i)
+    {
+      auto& e = _entries[i];
+      fputc(kind_char[e.kind], fp);
+      if (e.kind == trace_repeat)
+      {
+        fprintf(fp, " %u x", e.count);
+      }
+      else if (e.kind == trace_read)
+      {
+        fprintf(fp, " %u\n", e.length);
+        continue;
+      }
+      auto data = &_data[e.offset];
+      for (uint32_t j = 0; j < e.length; ++j)
+      {
+        if (j && (j % line_bytes) == 0) { fputs("\n ", fp); }
+        fprintf(fp, " %02X", data[j]);
+      }
+      fputc('\n', fp);
+    }
+  }
+
+  void Bus_Trace::flush_file(void)
+  {
+    if (_fp == nullptr) { return; }
+    write_entries(_fp, 0, _entries.size());
+    fflush(_fp);
+    _entries.clear();
+    _data.clear();
+  }
+
+  bool Bus_Trace::saveTrace(const char* path) const
+  {
+    auto fp = fopen(path, "w");
+    if (fp == nullptr) { return false; }
+    write_entries(fp, 0, _entries.size());
+    fclose(fp);
+    return true;
+  }
+
+  void Bus_Trace::beginTransaction(void)
+  {
+    ++_transaction_count;
+    _estimated_ns += _cfg.transaction_ns;
+    add_entry(trace_begin, nullptr, 0);
+  }
+
+  void Bus_Trace::endTransaction(void)
+  {
+    add_entry(trace_end, nullptr, 0);
+    if (_fp && _data.size() >= 65536)
+    {
+      flush_file();
+    }
+  }
+
+  uint8_t* Bus_Trace::getDMABuffer(uint32_t length)
+  {
+    _dma_index = !_dma_index;
+    auto& buf = _dma_buffer[_dma_index];
+    if (buf.size() < length) { buf.resize(length); }
+    return buf.data();
+  }
+
+  bool Bus_Trace::writeCommand(uint32_t data, uint_fast8_t bit_length)
+  {
+    uint32_t bytes = bit_length >> 3;
+    uint8_t buf[4];
+    for (uint32_t i = 0; i < bytes; ++i) { buf[i] = data >> (i << 3); }
+    ++_command_count;
+    _estimated_ns += _cfg.command_ns;
+    _write_bytes += bytes;
+    add_time(bytes, false);
+    add_entry(trace_command, buf, bytes);
+    return true;
+  }
+
+  void Bus_Trace::writeData(uint32_t data, uint_fast8_t bit_length)
+  {
+    uint32_t bytes = bit_length >> 3;
+    uint8_t buf[4];
+    for (uint32_t i = 0; i < bytes; ++i) { buf[i] = data >> (i << 3); }
+    _write_bytes += bytes;
+    add_time(bytes, false);
+    add_entry(trace_data, buf, bytes);
+  }
+
+  void Bus_Trace::writeDataRepeat(uint32_t data, uint_fast8_t bit_length, uint32_t count)
+  {
+    if (count == 0) { return; }
+    uint32_t bytes = bit_length >> 3;
+    uint8_t buf[4];
+    for (uint32_t i = 0; i < bytes; ++i) { buf[i] = data >> (i << 3); }
+    _write_bytes += (uint64_t)bytes * count;
+    add_time((uint64_t)bytes * count, false);
+    add_entry(trace_repeat, buf, bytes, count);
+  }
+
+  void Bus_Trace::writePixels(pixelcopy_t* pc, uint32_t length)
+  {
+    const uint32_t dst_bytes = pc->dst_bits >> 3;
+    static constexpr uint32_t limit = 1024;
+    if (_pixel_buffer.size() < limit * dst_bytes) { _pixel_buffer.resize(limit * dst_bytes); }
+    while (length)
+    {
+      uint32_t len = length < limit ? length : limit;
+      pc->fp_copy(_pixel_buffer.data(), 0, len, pc);
+      writeBytes(_pixel_buffer.data(), len * dst_bytes, true, false);
+      length -= len;
+    }
+  }
+
+  void Bus_Trace::writeBytes(const uint8_t* data, uint32_t length, bool dc, bool use_dma)
+  {
+    (void)use_dma;
+    if (!dc)
+    {
+      ++_command_count;
+      _estimated_ns += _cfg.command_ns;
+    }
+    _write_bytes += length;
+    add_time(length, false);
+    add_entry(dc ? trace_data : trace_command, data, length);
+  }
+
+  uint32_t Bus_Trace::readData(uint_fast8_t bit_length)
+  {
+    uint32_t bytes = bit_length >> 3;
+    _read_bytes += bytes;
+    add_time(bytes, true);
+    add_entry(trace_read, nullptr, bytes);
+    return 0;
+  }
+
+  bool Bus_Trace::readBytes(uint8_t* dst, uint32_t length, bool use_dma)
+  {
+    (void)use_dma;
+    memset(dst, 0, length);
+    _read_bytes += length;
+    add_time(length, true);
+    add_entry(trace_read, nullptr, length);
+    return true;
+  }
+
+  void Bus_Trace::readPixels(void* dst, pixelcopy_t* pc, uint32_t length)
+  {
+    const uint32_t bytes = pc->src_bits >> 3;
+    uint8_t buf[24];
+    uint32_t dstindex = 0;
+    uint32_t len = 4;
+    pc->src_data = buf;
+    do
+    {
+      if (len > length) len = length;
+      readBytes(buf, len * bytes, false);
+      pc->src_x = 0;
+      dstindex = pc->fp_copy(dst, dstindex, dstindex + len, pc);
+      length -= len;
+    } while (length);
+  }
+
+//----------------------------------------------------------------------------
+ }
+}
+
+#endif
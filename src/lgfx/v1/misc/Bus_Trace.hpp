@@ -0,0 +1,177 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [FreeBSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+#pragma once
+
+#if defined ( __linux__ )
+
+#include <stdio.h>
+#include <vector>
+
+#include "../Bus.hpp"
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  /// @brief 送信されるコマンド・データのバイト列を記録し、転送時間を見積もるバス。;
+  /// 実機なしでパネルドライバの出力を検証・比較するために使用する。;
+  /// Records the command / data byte stream sent by a panel driver and estimates the transfer time.
+  class Bus_Trace : public IBus
+  {
+  public:
+    struct config_t
+    {
+      /// 送信時のクロック周波数;
+      /// Write clock frequency.
+      uint32_t freq_write = 40000000;
+
+      /// 受信時のクロック周波数;
+      /// Read clock frequency.
+      uint32_t freq_read = 16000000;
+
+      /// 1クロックで転送されるビット数 (SPI=1, 8bitパラレル=8, 16bitパラレル=16);
+      /// Number of bits transferred per clock. (SPI=1, 8bit parallel=8, 16bit parallel=16)
+      uint8_t bus_width = 1;
+
+      /// パネルに通知するバスの種類;
+      /// Bus type reported to the panel.
+      bus_type_t bus_type = bus_type_t::bus_spi;
+
+      /// トランザクション毎の所要時間 (CS制御やペリフェラル設定など) [ns];
+      /// Time spent per transaction (CS control, peripheral setup, etc.) [ns]
+      uint32_t transaction_ns = 2000;
+
+      /// コマンド毎の所要時間 (D/C切替えなど) [ns];
+      /// Time spent per command (D/C switching, etc.) [ns]
+      uint32_t command_ns = 200;
+
+      /// バイト列をメモリに記録するか否か (falseの場合は統計のみ);
+      /// Whether to record the byte stream. (statistics only if false)
+      bool record = true;
+
+      /// 記録を書き出すファイル名 (nullptrの場合はメモリのみ);
+      /// File to stream the trace to. (memory only if nullptr)
+      const char* file_path = nullptr;
+    };
+
+    enum trace_kind_t : uint8_t
+    {
+      trace_begin,    // beginTransaction
+      trace_end,      // endTransaction
+      trace_command,  // D/C low
+      trace_data,     // D/C high
+      trace_repeat,   // D/C high, the pattern is repeated `count` times
+      trace_read,     // `length` bytes read
+    };
+
+    struct trace_entry_t
+    {
+      trace_kind_t kind;
+      uint32_t offset;  // position of the bytes in getTraceData() (no bytes for trace_read)
+      uint32_t length;  // number of bytes (pattern bytes for trace_repeat)
+      uint32_t count;   // repeat count for trace_repeat
+    };
+
+    Bus_Trace(void) = default;
+    virtual ~Bus_Trace(void);
+
+    const config_t& config(void) const { return _cfg; }
+    void config(const config_t& config);
+
+    bus_type_t busType(void) const override { return _cfg.bus_type; }
+
+    bool init(void) override;
+    void release(void) override;
+
+    uint32_t getClock(void) const override { return _cfg.freq_write; }
+    uint32_t getReadClock(void) const override { return _cfg.freq_read; }
+    void setClock(uint32_t freq) override { _cfg.freq_write = freq; }
+    void setReadClock(uint32_t freq) override { _cfg.freq_read = freq; }
+
+    void beginTransaction(void) override;
+    void endTransaction(void) override;
+    void wait(void) override {}
+    bool busy(void) const override { return false; }
+
+    void initDMA(void) override {}
+    void addDMAQueue(const uint8_t* data, uint32_t length) override { writeBytes(data, length, true, true); }
+    void execDMAQueue(void) override {}
+    uint8_t* getDMABuffer(uint32_t length) override;
+
+    void flush(void) override {}
+    bool writeCommand(uint32_t data, uint_fast8_t bit_length) override;
+    void writeData(uint32_t data, uint_fast8_t bit_length) override;
+    void writeDataRepeat(uint32_t data, uint_fast8_t bit_length, uint32_t count) override;
+    void writePixels(pixelcopy_t* pc, uint32_t length) override;
+    void writeBytes(const uint8_t* data, uint32_t length, bool dc, bool use_dma) override;
+
+    void beginRead(void) override {}
+    void endRead(void) override {}
+    uint32_t readData(uint_fast8_t bit_length) override;
+    bool readBytes(uint8_t* dst, uint32_t length, bool use_dma) override;
+    void readPixels(void* dst, pixelcopy_t* pc, uint32_t length) override;
+
+    /// 記録と統計を消去する (ファイル出力時は未出力の記録を書き出してから消去する);
+    /// Clears the recorded trace and the statistics. (pending entries are written first when streaming to a file)
+    void clearTrace(void);
+
+    /// 記録をテキスト形式でファイルに保存する;
+    /// Saves the recorded trace as text.
+    bool saveTrace(const char* path) const;
+
+    const std::vector<trace_entry_t>& getTraceEntries(void) const { return _entries; }
+    const std::vector<uint8_t>& getTraceData(void) const { return _data; }
+
+    uint64_t getWriteBytes(void) const { return _write_bytes; }
+    uint64_t getReadBytes(void) const { return _read_bytes; }
+    uint32_t getCommandCount(void) const { return _command_count; }
+    uint32_t getTransactionCount(void) const { return _transaction_count; }
+
+    /// 設定されたクロックとオーバーヘッドから見積もった転送時間 [ns];
+    /// Transfer time estimated from the configured clocks and overheads [ns].
+    uint64_t getEstimatedTime(void) const;
+
+  protected:
+    config_t _cfg;
+
+    std::vector<trace_entry_t> _entries;
+    std::vector<uint8_t> _data;
+    std::vector<uint8_t> _dma_buffer[2];
+    std::vector<uint8_t> _pixel_buffer;
+    uint8_t _dma_index = 0;
+    FILE* _fp = nullptr;
+
+    uint64_t _write_bytes = 0;
+    uint64_t _read_bytes = 0;
+    double _estimated_ns = 0;
+    uint32_t _command_count = 0;
+    uint32_t _transaction_count = 0;
+
+    void add_time(uint64_t bytes, bool read);
+    void add_entry(trace_kind_t kind, const uint8_t* data, uint32_t length, uint32_t count = 1);
+    void write_entries(FILE* fp, size_t begin, size_t end) const;
+    void flush_file(void);
+  };
+
+//----------------------------------------------------------------------------
+ }
+}
+
+#endif
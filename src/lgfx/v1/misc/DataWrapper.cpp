@@ -0,0 +1,220 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [BSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+
+#include "DataWrapper.hpp"
+
+#include "../platforms/common.hpp"
+
+#if defined (__linux__) || defined (__APPLE__)
+ #include <fcntl.h>
+ #include <unistd.h>
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+#endif
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  BufferedDataWrapper::~BufferedDataWrapper(void)
+  {
+    if (_buffer) { heap_free(_buffer); }
+  }
+
+  void BufferedDataWrapper::setSource(DataWrapper* source)
+  {
+    _source = source;
+    if (source) { need_transaction = source->need_transaction; }
+    drop();
+  }
+
+  void BufferedDataWrapper::setBlockSize(uint32_t block_size)
+  {
+    if (_buffer && _source && _length != _index)
+    { // give the unread data back to the source.
+      auto pos = tell();
+      drop();
+      _source->seek(pos);
+    }
+    drop();
+    if (_buffer) { heap_free(_buffer); _buffer = nullptr; }
+    _block_size = block_size;
+  }
+
+  bool BufferedDataWrapper::open(const char* path)
+  {
+    drop();
+    return _source && _source->open(path);
+  }
+
+  void BufferedDataWrapper::close(void)
+  {
+    drop();
+    if (_source) { _source->close(); }
+  }
+
+  int32_t BufferedDataWrapper::tell(void)
+  {
+    if (_pos < 0) { _pos = _source->tell(); }
+    return _pos - (_length - _index);
+  }
+
+  bool BufferedDataWrapper::fill(uint32_t keep)
+  { // moves the `keep` unread bytes to the front, and reads the source after them.
+    if (_buffer == nullptr)
+    {
+      if (_block_size < 16) { _block_size = 16; }
+      // 4 spare bytes for the readers of rgb888 that read 4 bytes at a time. (see readSpan)
+      _buffer = (uint8_t*)heap_alloc(_block_size + 4);
+      if (_buffer == nullptr) { return false; }
+    }
+    if (_pos < 0) { _pos = _source->tell(); }
+    if (keep) { memmove(_buffer, &_buffer[_index], keep); }
+    _index = 0;
+    _length = keep;
+    int res = _source->read(&_buffer[keep], _block_size - keep);
+    if (res <= 0) { return false; }
+    _length += res;
+    _pos += res;
+    return true;
+  }
+
+  int BufferedDataWrapper::read(uint8_t *buf, uint32_t len)
+  {
+    if (_source == nullptr) { return 0; }
+    uint32_t total = 0;
+    while (len)
+    {
+      uint32_t avail = _length - _index;
+      if (avail == 0)
+      {
+        if (len >= _block_size)
+        { // large reads go straight to the caller's buffer.
+          if (_pos < 0) { _pos = _source->tell(); }
+          _index = _length = 0;
+          int res = _source->read(buf, len);
+          if (res > 0) { total += res; _pos += res; }
+          break;
+        }
+        if (!fill(0)) { break; }
+        avail = _length;
+      }
+      if (avail > len) { avail = len; }
+      memcpy(buf, &_buffer[_index], avail);
+      _index += avail;
+      buf += avail;
+      len -= avail;
+      total += avail;
+    }
+    return total;
+  }
+
+  void BufferedDataWrapper::skip(int32_t offset)
+  {
+    if (_source == nullptr) { return; }
+    int32_t avail = _length - _index;
+    if (offset <= avail && offset >= -(int32_t)_index)
+    {
+      _index += offset;
+      return;
+    }
+    // the source is at the end of the buffered data.
+    _source->skip(offset - avail);
+    if (_pos >= 0) { _pos += offset - avail; }
+    _index = _length = 0;
+  }
+
+  bool BufferedDataWrapper::seek(uint32_t offset)
+  {
+    if (_source == nullptr) { return false; }
+    if (_pos >= 0 && offset <= (uint32_t)_pos && offset + _length >= (uint32_t)_pos)
+    { // inside the buffered data.
+      _index = _length - (_pos - offset);
+      return true;
+    }
+    drop();
+    return _source->seek(offset);
+  }
+
+  const uint8_t* BufferedDataWrapper::readSpan(uint32_t len)
+  {
+    if (_source == nullptr || len > _block_size) { return nullptr; }
+    if (_length - _index < len)
+    {
+      fill(_length - _index);
+      if (_length - _index < len) { return nullptr; }
+    }
+    auto res = &_buffer[_index];
+    _index += len;
+    return res;
+  }
+
+//----------------------------------------------------------------------------
+
+#if defined (__linux__) || defined (__APPLE__)
+
+  bool MmapDataWrapper::open(const char* path)
+  {
+    close();
+    int fd;
+    while (0 > (fd = ::open(path, O_RDONLY)) && path[0] == '/')
+    { ++path; }
+    if (fd < 0) { return false; }
+
+    struct stat st;
+    bool res = (0 == fstat(fd, &st)) && st.st_size <= (off_t)UINT32_MAX;
+    if (res && st.st_size)
+    {
+      void* map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      res = (map != MAP_FAILED);
+      if (res)
+      {
+        _map = map;
+        _map_size = st.st_size;
+        madvise(map, _map_size, MADV_SEQUENTIAL);
+      }
+    }
+    ::close(fd);  // the mapping stays valid after the descriptor is closed.
+    set((const uint8_t*)_map, _map_size);
+    return res;
+  }
+
+  void MmapDataWrapper::close(void)
+  {
+    if (_map) { munmap(_map, _map_size); }
+    _map = nullptr;
+    _map_size = 0;
+    set(nullptr, 0);
+  }
+
+  const uint8_t* MmapDataWrapper::readSpan(uint32_t len)
+  {
+    // the mapping ends at the end of the file, so spans keep 4 bytes away from it. (see DataWrapper::readSpan)
+    if (_index > _length || _length - _index < len + 4) { return nullptr; }
+    auto res = &_ptr[_index];
+    _index += len;
+    return res;
+  }
+
+#endif
+
+//----------------------------------------------------------------------------
+ }
+}
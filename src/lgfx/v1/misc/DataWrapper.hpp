@@ -76,6 +76,12 @@ namespace lgfx
     virtual void close(void) = 0;
     virtual int32_t tell(void) = 0;
 
+    /// 読み出し位置から len バイトを複写せずに参照し、読み出し位置を進める。対応しない場合や len バイト無い場合は nullptr;
+    /// Returns the next `len` bytes without copying them and advances the read position, or nullptr (the position is unchanged)
+    /// if the wrapper can not provide them in one piece. The data is valid until the next call, and at least 4 more bytes
+    /// after it are readable, so that pixel copies reading 4 bytes at a time stay in bounds.
+    virtual const uint8_t* readSpan(uint32_t len) { (void)len; return nullptr; }
+
     LGFX_INLINE void preRead(void) { if (fp_pre_read) fp_pre_read(parent); }
     LGFX_INLINE void postRead(void) { if (fp_post_read) fp_post_read(parent); }
     LGFX_INLINE bool hasParent(void) const { return parent; }
@@ -122,7 +128,7 @@ namespace lgfx
     }
 #endif
     int read(uint8_t *buf, uint32_t len) override { return fread((char*)buf, 1, len, _fp); }
-    void skip(int32_t offset) override { seek(offset, SEEK_CUR); }
+    void skip(int32_t offset) override { fseek(_fp, offset, SEEK_CUR); }  // signed, so that it can go back
     bool seek(uint32_t offset) override { return seek(offset, SEEK_SET); }
     bool seek(uint32_t offset, int origin) { return fseek(_fp, offset, origin); }
     void close(void) override { if (_fp) { fclose(_fp); _fp = nullptr; } }
@@ -174,6 +180,67 @@ namespace lgfx
     uint32_t _length;
   };
 
+//----------------------------------------------------------------------------
+
+  /// @brief 他の DataWrapper を block_size 単位で先読みし、小さな読み出しをメモリから返す。;
+  /// Reads another DataWrapper (FILE, SdFat, fs::File ...) ahead in blocks of `block_size` bytes,
+  /// so that the many small reads of the decoders and VLW fonts are served from memory.
+  /// The source is not owned. Open it through this wrapper, or wrap it after it is opened.
+  struct BufferedDataWrapper : public DataWrapper
+  {
+    BufferedDataWrapper(DataWrapper* source = nullptr, uint32_t block_size = 512) : DataWrapper{}, _block_size { block_size } { setSource(source); }
+    virtual ~BufferedDataWrapper(void);
+
+    void setSource(DataWrapper* source);
+    DataWrapper* getSource(void) const { return _source; }
+
+    /// drops the buffered data. the new block is allocated on the next read.
+    void setBlockSize(uint32_t block_size);
+    uint32_t getBlockSize(void) const { return _block_size; }
+
+    bool open(const char* path) override;
+    int read(uint8_t *buf, uint32_t len) override;
+    void skip(int32_t offset) override;
+    bool seek(uint32_t offset) override;
+    void close(void) override;
+    int32_t tell(void) override;
+    const uint8_t* readSpan(uint32_t len) override;
+
+  protected:
+    DataWrapper* _source = nullptr;
+    uint8_t* _buffer = nullptr;
+    uint32_t _block_size;
+    uint32_t _index = 0;   // read position in _buffer
+    uint32_t _length = 0;  // valid bytes in _buffer
+    int32_t _pos = -1;     // position of the source (= end of the buffered data). -1 = not known yet
+
+    void drop(void) { _index = _length = 0; _pos = -1; }
+    bool fill(uint32_t keep);
+  };
+
+//----------------------------------------------------------------------------
+
+#if defined (__linux__) || defined (__APPLE__)
+
+  /// @brief ファイルをメモリに割り当て、PointerWrapper と同様にポインタ演算で読み出す (Linux / macOS);
+  /// Maps a file into memory and reads it with pointer arithmetic like PointerWrapper. (Linux / macOS)
+  /// readSpan returns the mapped memory itself.
+  struct MmapDataWrapper : public PointerWrapper
+  {
+    MmapDataWrapper(void) : PointerWrapper{} {}
+    virtual ~MmapDataWrapper(void) { close(); }
+
+    bool open(const char* path) override;
+    void close(void) override;
+    const uint8_t* readSpan(uint32_t len) override;
+
+  protected:
+    void* _map = nullptr;
+    size_t _map_size = 0;
+  };
+
+#endif
+
 //----------------------------------------------------------------------------
 
 #if defined (SdFat_h)
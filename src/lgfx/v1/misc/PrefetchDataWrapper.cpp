@@ -0,0 +1,274 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [BSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+#include "PrefetchDataWrapper.hpp"
+
+#if defined ( __linux__ ) || defined ( __APPLE__ ) || defined ( _WIN32 )
+
+#include "../platforms/common.hpp"
+
+#include <chrono>
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  static uint64_t elapsed_us(std::chrono::steady_clock::time_point since)
+  {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - since).count();
+  }
+
+  PrefetchDataWrapper::~PrefetchDataWrapper(void)
+  {
+    stop(false);
+    if (_memory) { heap_free(_memory); }
+    if (_blocks) { heap_free(_blocks); }
+  }
+
+  void PrefetchDataWrapper::setSource(DataWrapper* source)
+  {
+    stop(true);
+    _source = source;
+    _eof = false;
+  }
+
+  void PrefetchDataWrapper::setBlocks(uint32_t block_size, uint32_t block_count)
+  {
+    stop(true);
+    if (_memory) { heap_free(_memory); _memory = nullptr; }
+    if (_blocks) { heap_free(_blocks); _blocks = nullptr; }
+    _block_size = block_size < 64 ? 64 : block_size;
+    _block_count = block_count < 2 ? 2 : block_count;
+  }
+
+  PrefetchDataWrapper::stats_t PrefetchDataWrapper::getStats(void)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+  }
+
+  void PrefetchDataWrapper::resetStats(void)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats = {};
+  }
+
+  bool PrefetchDataWrapper::start(void)
+  {
+    if (_running) { return true; }
+    if (_source == nullptr) { return false; }
+    if (_memory == nullptr)
+    {
+      if (_block_size < 64) { _block_size = 64; }
+      if (_block_count < 2) { _block_count = 2; }
+      // 4 spare bytes per block for the readers of rgb888 that read 4 bytes at a time. (see DataWrapper::readSpan)
+      _memory = (uint8_t*)heap_alloc((_block_size + 4) * _block_count);
+      _blocks = (block_t*)heap_alloc(sizeof(block_t) * _block_count);
+      if (_memory == nullptr || _blocks == nullptr) { return false; }
+      for (uint32_t i = 0; i < _block_count; ++i)
+      {
+        _blocks[i].data = &_memory[i * (_block_size + 4)];
+      }
+    }
+    _start_pos = _source->tell();
+    _current = nullptr;
+    _index = 0;
+    _eof = false;
+    _head = _tail = _filled = 0;
+    _stop = false;
+    _running = true;
+    _thread = std::thread(&PrefetchDataWrapper::fill_proc, this);
+    return true;
+  }
+
+  void PrefetchDataWrapper::stop(bool rewind)
+  {
+    if (!_running) { return; }
+    int32_t pos = tell();
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stop = true;
+    }
+    _cond_free.notify_all();
+    _thread.join();
+    _running = false;
+    _current = nullptr;
+    _index = 0;
+    // give the data read ahead back to the source.
+    if (rewind) { _source->seek(pos); }
+  }
+
+  void PrefetchDataWrapper::fill_proc(void)
+  {
+    int32_t pos = _start_pos;
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (!_stop)
+    {
+      if (_filled == _block_count)
+      {
+        ++_stats.fill_stalls;
+        auto t0 = std::chrono::steady_clock::now();
+        _cond_free.wait(lock, [this] { return _stop || _filled < _block_count; });
+        _stats.fill_stall_us += elapsed_us(t0);
+        continue;
+      }
+      auto block = &_blocks[_head];
+      lock.unlock();
+      int res = _source->read(block->data, _block_size);
+      lock.lock();
+      block->pos = pos;
+      block->length = (res > 0) ? res : 0;
+      pos += block->length;
+      _stats.bytes += block->length;
+      _head = (_head + 1) % _block_count;
+      ++_filled;
+      _cond_filled.notify_one();
+      if (block->length == 0) { break; } // end of the source.
+    }
+  }
+
+  bool PrefetchDataWrapper::next_block(void)
+  {
+    if (_eof) { return false; }
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_current)
+    { // release the block to the I/O thread.
+      _current = nullptr;
+      _tail = (_tail + 1) % _block_count;
+      --_filled;
+      _cond_free.notify_one();
+    }
+    if (_filled == 0)
+    {
+      ++_stats.read_stalls;
+      auto t0 = std::chrono::steady_clock::now();
+      _cond_filled.wait(lock, [this] { return _filled > 0; });
+      _stats.read_stall_us += elapsed_us(t0);
+    }
+    _current = &_blocks[_tail];
+    _index = 0;
+    // the empty block at the end is kept as the current block, so that tell() stays at the end.
+    _eof = (_current->length == 0);
+    return !_eof;
+  }
+
+  bool PrefetchDataWrapper::open(const char* path)
+  {
+    stop(false);
+    _eof = false;
+    return _source && _source->open(path);
+  }
+
+  void PrefetchDataWrapper::close(void)
+  {
+    stop(false);
+    if (_source) { _source->close(); }
+  }
+
+  int32_t PrefetchDataWrapper::tell(void)
+  {
+    if (!_running) { return _source ? _source->tell() : 0; }
+    return _current ? _current->pos + _index : _start_pos;
+  }
+
+  int PrefetchDataWrapper::read(uint8_t *buf, uint32_t len)
+  {
+    if (!start()) { return 0; }
+    uint32_t total = 0;
+    while (len)
+    {
+      if (_current == nullptr || _index == _current->length)
+      {
+        if (!next_block()) { break; }
+      }
+      uint32_t avail = _current->length - _index;
+      if (avail > len) { avail = len; }
+      memcpy(buf, &_current->data[_index], avail);
+      _index += avail;
+      buf += avail;
+      len -= avail;
+      total += avail;
+    }
+    return total;
+  }
+
+  void PrefetchDataWrapper::skip(int32_t offset)
+  {
+    if (!_running)
+    {
+      if (_source) { _source->skip(offset); }
+      return;
+    }
+    if (offset < 0)
+    {
+      seek(tell() + offset);
+      return;
+    }
+    // forward : consume the ring instead of restarting the read-ahead.
+    while (offset)
+    {
+      if (_current == nullptr || _index == _current->length)
+      {
+        if (!next_block()) { return; }
+      }
+      uint32_t avail = _current->length - _index;
+      if (avail > (uint32_t)offset) { avail = offset; }
+      _index += avail;
+      offset -= avail;
+    }
+  }
+
+  bool PrefetchDataWrapper::seek(uint32_t offset)
+  {
+    if (_running && _current
+     && offset >= (uint32_t)_current->pos
+     && offset <= (uint32_t)_current->pos + _current->length)
+    { // inside the current block.
+      _index = offset - _current->pos;
+      return true;
+    }
+    if (_source == nullptr) { return false; }
+    if (_running)
+    {
+      stop(false);
+      std::lock_guard<std::mutex> lock(_mutex);
+      ++_stats.restarts;
+    }
+    _eof = false;
+    return _source->seek(offset);
+  }
+
+  const uint8_t* PrefetchDataWrapper::readSpan(uint32_t len)
+  {
+    if (!start()) { return nullptr; }
+    if (_current == nullptr || _index == _current->length)
+    {
+      if (!next_block()) { return nullptr; }
+    }
+    if (_current->length - _index < len) { return nullptr; }
+    auto res = &_current->data[_index];
+    _index += len;
+    return res;
+  }
+
+//----------------------------------------------------------------------------
+ }
+}
+
+#endif
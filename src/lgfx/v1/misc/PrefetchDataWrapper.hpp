@@ -0,0 +1,113 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [BSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+#pragma once
+
+#if defined ( __linux__ ) || defined ( __APPLE__ ) || defined ( _WIN32 )
+
+#include "DataWrapper.hpp"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  /// @brief 別スレッドで source を先読みし、ブロックのリング経由で読み出す (PC向け)。;
+  /// Reads the source ahead on a background thread into a ring of blocks, so that the file I/O
+  /// overlaps the decoding. A read only waits when the ring is empty. (host platforms)
+  /// The source is not owned, and must not be used by anyone else while this wrapper is reading it.
+  struct PrefetchDataWrapper : public DataWrapper
+  {
+    struct stats_t
+    {
+      uint32_t read_stalls;   // reads that waited for a block (the ring was empty : I/O bound)
+      uint32_t fill_stalls;   // times the I/O thread waited for a free block (the ring was full : decode bound)
+      uint64_t read_stall_us; // time spent waiting in read
+      uint64_t fill_stall_us; // time the I/O thread spent waiting
+      uint64_t bytes;         // bytes read from the source
+      uint32_t restarts;      // seeks outside the current block, which restart the read-ahead
+    };
+
+    PrefetchDataWrapper(DataWrapper* source = nullptr, uint32_t block_size = 16384, uint32_t block_count = 4)
+    : DataWrapper{}, _block_size { block_size }, _block_count { block_count } { _source = source; }
+    virtual ~PrefetchDataWrapper(void);
+
+    void setSource(DataWrapper* source);
+    DataWrapper* getSource(void) const { return _source; }
+
+    /// stops the read-ahead and changes the ring. block_count is at least 2.
+    void setBlocks(uint32_t block_size, uint32_t block_count);
+
+    stats_t getStats(void);
+    void resetStats(void);
+
+    bool open(const char* path) override;
+    int read(uint8_t *buf, uint32_t len) override;
+    void skip(int32_t offset) override;
+    bool seek(uint32_t offset) override;
+    void close(void) override;
+    int32_t tell(void) override;
+    const uint8_t* readSpan(uint32_t len) override;
+
+  protected:
+    struct block_t
+    {
+      uint8_t* data;
+      uint32_t length;  // 0 = end of the source
+      int32_t pos;      // position of data[0] in the source
+    };
+
+    DataWrapper* _source = nullptr;
+    uint8_t* _memory = nullptr;
+    block_t* _blocks = nullptr;
+    uint32_t _block_size;
+    uint32_t _block_count;
+
+    // consumer side
+    block_t* _current = nullptr;  // block being read. it stays in the ring until it is released
+    uint32_t _index = 0;          // read position in _current
+    int32_t _start_pos = 0;       // position where the read-ahead starts (or started)
+    bool _eof = false;
+
+    // shared with the I/O thread (guarded by _mutex)
+    std::thread _thread;
+    std::mutex _mutex;
+    std::condition_variable _cond_filled;
+    std::condition_variable _cond_free;
+    uint32_t _head = 0;     // next block to fill
+    uint32_t _tail = 0;     // oldest block in use
+    uint32_t _filled = 0;   // blocks filled and not released yet, including _current
+    bool _running = false;
+    bool _stop = false;
+    stats_t _stats = {};
+
+    bool start(void);
+    void stop(bool rewind); // rewind : seek the source back to the read position
+    bool next_block(void);
+    void fill_proc(void);
+  };
+
+//----------------------------------------------------------------------------
+ }
+}
+
+#endif
@@ -128,6 +128,20 @@ namespace lgfx
   }
   using namespace gradient_fill_styles;
 
+//----------------------------------------------------------------------------
+
+  namespace fill_rule
+  {
+    /// 多角形の内側の判定方法;
+    /// How the inside of a polygon is determined.
+    enum fill_rule_t : uint8_t
+    {
+      fill_nonzero = 0,  // winding number != 0
+      fill_evenodd = 1,  // odd number of crossings
+    };
+  }
+  using namespace fill_rule;
+
 //----------------------------------------------------------------------------
 
   namespace textdatum
@@ -0,0 +1,97 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [FreeBSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/// LGFX_USE_PERF_COUNTER を定義するとパネルとバスの性能計測カウンタが有効になる。;
+/// 未定義の場合は LGFX_PERF_COUNT の中身はコンパイルされない。;
+/// Define LGFX_USE_PERF_COUNTER to enable the panel / bus performance counters.
+#if defined ( LGFX_USE_PERF_COUNTER )
+ #define LGFX_PERF_COUNT(expr) do { expr; } while (0)
+#else
+ #define LGFX_PERF_COUNT(expr)
+#endif
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  /// 転送サイズの分布。count[n] は 2^n 以上 2^(n+1) 未満の件数 (最後の要素はそれ以上すべて);
+  /// Size histogram. count[n] holds the sizes in [2^n, 2^(n+1)), the last bin holds everything above.
+  struct perf_histogram_t
+  {
+    static constexpr size_t bins = 16;
+    uint32_t count[bins];
+
+    void add(uint32_t size)
+    {
+      size_t bin = 0;
+      while ((size >>= 1) && bin < bins - 1) { ++bin; }
+      ++count[bin];
+    }
+  };
+
+  struct panel_perf_counter_t
+  {
+    uint64_t pixels_written;
+    uint64_t pixels_read;
+    uint32_t set_window;
+    uint32_t begin_transaction;
+    uint32_t end_transaction;
+    uint32_t draw_pixel;
+    uint32_t fill_rect;
+    uint32_t write_image;
+    uint32_t write_block;
+    uint32_t write_pixels;
+    uint32_t read_rect;
+    uint32_t wait_dma;
+    perf_histogram_t write_image_size;
+    perf_histogram_t write_block_size;
+    perf_histogram_t write_pixels_size;
+
+    void addDrawPixel(void) { ++draw_pixel; ++pixels_written; }
+    void addFillRect(uint32_t pixels) { ++fill_rect; pixels_written += pixels; }
+    void addWriteImage(uint32_t pixels) { ++write_image; write_image_size.add(pixels); pixels_written += pixels; }
+    void addWriteBlock(uint32_t pixels) { ++write_block; write_block_size.add(pixels); pixels_written += pixels; }
+    void addWritePixels(uint32_t pixels) { ++write_pixels; write_pixels_size.add(pixels); pixels_written += pixels; }
+    void addReadRect(uint32_t pixels) { ++read_rect; pixels_read += pixels; }
+  };
+
+  struct bus_perf_counter_t
+  {
+    uint64_t bytes_written;
+    uint64_t bytes_read;
+    uint32_t write_command;
+    uint32_t begin_transaction;
+    uint32_t dma_queue;
+    uint32_t dma_flush;
+  };
+
+  struct perf_counter_t
+  {
+    panel_perf_counter_t panel;
+    bus_perf_counter_t bus;
+  };
+
+//----------------------------------------------------------------------------
+ }
+}
@@ -21,6 +21,16 @@ Contributors:
 
 #include "colortype.hpp"
 
+/// Vectorized pixel format conversion for host builds (SSE2/SSSE3/AVX2, NEON).
+/// Define LGFX_PIXELCOPY_SIMD=0 to force the scalar templates.
+#if !defined ( LGFX_PIXELCOPY_SIMD )
+ #if defined ( __SSE2__ ) || defined ( _M_X64 ) || defined ( __ARM_NEON ) || defined ( __ARM_NEON__ )
+  #define LGFX_PIXELCOPY_SIMD 1
+ #else
+  #define LGFX_PIXELCOPY_SIMD 0
+ #endif
+#endif
+
 namespace lgfx
 {
  inline namespace v1
@@ -102,6 +112,51 @@ namespace lgfx
     static uint32_t compare_bit_affine(void* __restrict dst, uint32_t index, uint32_t last, pixelcopy_t* __restrict param);
     static uint32_t skip_bit_affine(uint32_t index, uint32_t last, pixelcopy_t* param);
 
+    /// Converts a contiguous run of pixels with the SIMD kernel selected at runtime.
+    /// @return number of pixels converted. the remainder is left to the scalar loop.
+    template <typename TDst, typename TSrc>
+    static uint32_t copy_rgb_simd(void*, const void*, uint32_t) { return 0; }
+
+    /// Blends a color in place over a contiguous run of pixels in the native format.
+    typedef void (*fp_blend_fill_t)(void* dst, uint32_t len, uint32_t argb8888);
+
+    /// @return nullptr if the depth can not be blended in place. (palette, less than 8bit, 32bit)
+    static fp_blend_fill_t get_fp_blend_fill(color_depth_t dst_depth)
+    {
+      return (dst_depth == rgb565_2Byte  ) ? blend_fill<swap565_t>
+           : (dst_depth == rgb332_1Byte  ) ? blend_fill<rgb332_t>
+           : (dst_depth == rgb888_3Byte  ) ? blend_fill<bgr888_t>
+           : (dst_depth == rgb666_3Byte  ) ? blend_fill<bgr666_t>
+           : (dst_depth == grayscale_8bit) ? blend_fill_grayscale
+           : nullptr;
+    }
+
+    template <typename TDst>
+    static void blend_fill(void* dst, uint32_t len, uint32_t argb8888)
+    {
+      auto d = static_cast<TDst*>(dst);
+      uint32_t i = blend_fill_simd<TDst>(d, len, argb8888);
+      effect_fill_alpha effector(argb8888_t { argb8888 });
+      for (; i < len; ++i) { effector(0, 0, d[i]); }
+    }
+
+    /// grayscale is blended per channel and converted with the same weights as the readRect / writeImage path.
+    static void blend_fill_grayscale(void* dst, uint32_t len, uint32_t argb8888)
+    {
+      auto d = static_cast<uint8_t*>(dst);
+      effect_fill_alpha effector(argb8888_t { argb8888 });
+      for (uint32_t i = 0; i < len; ++i)
+      {
+        bgr888_t c { d[i], d[i], d[i] };
+        effector(0, 0, c);
+        d[i] = (c.r * 77 + c.g * 151 + c.b * 29) >> 8;
+      }
+    }
+
+    /// Same as copy_rgb_simd, for blend_fill.
+    template <typename TDst>
+    static uint32_t blend_fill_simd(void*, uint32_t, uint32_t) { return 0; }
+
     template<typename TSrc>
     static auto get_fp_copy_rgb_affine(color_depth_t dst_depth) -> uint32_t(*)(void*, uint32_t, uint32_t, pixelcopy_t*)
     {
@@ -167,9 +222,11 @@ namespace lgfx
       }
       else
       {
-        do {
+        index += copy_rgb_simd<TDst, TSrc>(&d[index], &s[index], last - index);
+        for (; index != last; ++index)
+        {
           d[index].set(color_convert<TDst, TSrc>(s[index].get()));
-        } while (++index != last);
+        }
       }
       return last;
     }
@@ -202,6 +259,23 @@ namespace lgfx
       auto src_y32_add = param->src_y32_add;
       auto src_x32 = param->src_x32;
       auto src_y32 = param->src_y32;
+      if (sizeof(TSrc) < 4 && src_y32_add == 0 && src_x32_add == (1u << FP_SCALE) && param->transp == NON_TRANSP)
+      { // unscaled and opaque : the source is one contiguous run.
+        auto sp = &s[(src_x32 >> FP_SCALE) + (src_y32 >> FP_SCALE) * src_bitwidth];
+        auto dp = &d[index];
+        uint32_t len = last - index;
+        param->src_x32 = src_x32 + (len << FP_SCALE);
+        if (std::is_same<TDst, TSrc>::value)
+        {
+          memcpy(reinterpret_cast<void*>(dp), reinterpret_cast<const void*>(sp), len * sizeof(TSrc));
+          return last;
+        }
+        for (uint32_t i = copy_rgb_simd<TDst, TSrc>(dp, sp, len); i != len; ++i)
+        {
+          dp[i].set(color_convert<TDst, TSrc>(sp[i].get()));
+        }
+        return last;
+      }
       do {
         uint32_t i = (src_x32 >> FP_SCALE) + (src_y32 >> FP_SCALE) * src_bitwidth;
         uint32_t raw = s[i].get();
@@ -527,6 +601,18 @@ namespace lgfx
     }
   };
 
+#if LGFX_PIXELCOPY_SIMD
+  template<> uint32_t pixelcopy_t::copy_rgb_simd<swap565_t, bgr888_t   >(void* dst, const void* src, uint32_t len);
+  template<> uint32_t pixelcopy_t::copy_rgb_simd<swap565_t, rgb332_t   >(void* dst, const void* src, uint32_t len);
+  template<> uint32_t pixelcopy_t::copy_rgb_simd<swap565_t, bgra8888_t >(void* dst, const void* src, uint32_t len);
+  template<> uint32_t pixelcopy_t::copy_rgb_simd<swap565_t, grayscale_t>(void* dst, const void* src, uint32_t len);
+  template<> uint32_t pixelcopy_t::copy_rgb_simd<bgr888_t , swap565_t  >(void* dst, const void* src, uint32_t len);
+  template<> uint32_t pixelcopy_t::copy_rgb_simd<bgr888_t , bgra8888_t >(void* dst, const void* src, uint32_t len);
+  template<> uint32_t pixelcopy_t::copy_rgb_simd<bgr888_t , grayscale_t>(void* dst, const void* src, uint32_t len);
+  template<> uint32_t pixelcopy_t::blend_fill_simd<swap565_t>(void* dst, uint32_t len, uint32_t argb8888);
+  template<> uint32_t pixelcopy_t::blend_fill_simd<bgr888_t >(void* dst, uint32_t len, uint32_t argb8888);
+#endif
+
 //----------------------------------------------------------------------------
  }
 }
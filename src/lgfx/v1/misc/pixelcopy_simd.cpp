@@ -0,0 +1,671 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [BSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+
+#include "pixelcopy.hpp"
+
+#if LGFX_PIXELCOPY_SIMD
+
+#if defined ( __ARM_NEON ) || defined ( __ARM_NEON__ )
+ #include <arm_neon.h>
+ #define LGFX_SIMD_NEON
+#else
+ #include <emmintrin.h>
+ #define LGFX_SIMD_SSE2
+ #if defined ( __GNUC__ )
+  #include <tmmintrin.h>
+  #include <immintrin.h>
+  #define LGFX_SIMD_X86_DISPATCH
+  #define LGFX_TARGET_SSSE3 __attribute__ ((target ("ssse3")))
+  #define LGFX_TARGET_AVX2  __attribute__ ((target ("avx2")))
+ #endif
+#endif
+
+namespace lgfx
+{
+  inline namespace v1
+  {
+//----------------------------------------------------------------------------
+
+    // All kernels reproduce color_convert<TDst, TSrc> bit for bit.
+    // Each kernel processes whole blocks only and returns the number of pixels written.
+    typedef uint32_t (*simd_copy_fn_t)(void* dst, const void* src, uint32_t len);
+
+    // Blend kernels reproduce effect_fill_alpha bit for bit: (color * (1 + a) + dst * (256 - a)) >> 8
+    // The sum never exceeds 255 * 257, so every channel fits in a 16bit lane.
+    typedef uint32_t (*simd_blend_fn_t)(void* dst, uint32_t len, uint32_t argb8888);
+
+    struct simd_copy_table_t
+    {
+      simd_copy_fn_t swap565_from_bgr888    = nullptr;
+      simd_copy_fn_t swap565_from_rgb332    = nullptr;
+      simd_copy_fn_t swap565_from_bgra8888  = nullptr;
+      simd_copy_fn_t swap565_from_grayscale = nullptr;
+      simd_copy_fn_t bgr888_from_swap565    = nullptr;
+      simd_copy_fn_t bgr888_from_bgra8888   = nullptr;
+      simd_copy_fn_t bgr888_from_grayscale  = nullptr;
+      simd_blend_fn_t swap565_blend_fill    = nullptr;
+      simd_blend_fn_t bgr888_blend_fill     = nullptr;
+    };
+
+#if defined ( LGFX_SIMD_NEON )
+
+    static uint32_t neon_swap565_from_bgr888(void* dst, const void* src, uint32_t len)
+    {
+      auto d = static_cast<uint8_t*>(dst);
+      auto s = static_cast<const uint8_t*>(src);
+      uint32_t i = 0;
+      for (; i + 16 <= len; i += 16)
+      {
+        uint8x16x3_t rgb = vld3q_u8(&s[i * 3]);
+        uint8x16x2_t res;
+        res.val[0] = vsriq_n_u8(rgb.val[0], rgb.val[1], 5);
+        res.val[1] = vsriq_n_u8(vshlq_n_u8(rgb.val[1], 3), rgb.val[2], 3);
+        vst2q_u8(&d[i * 2], res);
+      }
+      return i;
+    }
+
+    static uint32_t neon_swap565_from_bgra8888(void* dst, const void* src, uint32_t len)
+    {
+      auto d = static_cast<uint8_t*>(dst);
+      auto s = static_cast<const uint8_t*>(src);
+      uint32_t i = 0;
+      for (; i + 16 <= len; i += 16)
+      {
+        uint8x16x4_t argb = vld4q_u8(&s[i * 4]);
+        uint8x16x2_t res;
+        res.val[0] = vsriq_n_u8(argb.val[1], argb.val[2], 5);
+        res.val[1] = vsriq_n_u8(vshlq_n_u8(argb.val[2], 3), argb.val[3], 3);
+        vst2q_u8(&d[i * 2], res);
+      }
+      return i;
+    }
+
+    static uint32_t neon_swap565_from_rgb332(void* dst, const void* src, uint32_t len)
+    {
+      auto d = static_cast<uint8_t*>(dst);
+      auto s = static_cast<const uint8_t*>(src);
+      uint32_t i = 0;
+      for (; i + 16 <= len; i += 16)
+      {
+        uint8x16_t c = vld1q_u8(&s[i]);
+        uint8x16_t r3 = vshrq_n_u8(c, 5);
+        uint8x16_t g3 = vandq_u8(vshrq_n_u8(c, 2), vdupq_n_u8(7));
+        uint8x16_t b2 = vandq_u8(c, vdupq_n_u8(3));
+        uint8x16_t r5 = vaddq_u8(vshlq_n_u8(r3, 2), vshrq_n_u8(r3, 1));
+        uint8x16_t b5 = vaddq_u8(vmulq_u8(b2, vdupq_n_u8(10)), vshrq_n_u8(b2, 1));
+        uint8x16x2_t res;
+        res.val[0] = vorrq_u8(vshlq_n_u8(r5, 3), g3);
+        res.val[1] = vorrq_u8(vshlq_n_u8(g3, 5), b5);
+        vst2q_u8(&d[i * 2], res);
+      }
+      return i;
+    }
+
+    static uint32_t neon_swap565_from_grayscale(void* dst, const void* src, uint32_t len)
+    {
+      auto d = static_cast<uint8_t*>(dst);
+      auto s = static_cast<const uint8_t*>(src);
+      uint32_t i = 0;
+      for (; i + 16 <= len; i += 16)
+      {
+        uint8x16_t c = vld1q_u8(&s[i]);
+        uint8x16x2_t res;
+        res.val[0] = vsriq_n_u8(c, c, 5);
+        res.val[1] = vsriq_n_u8(vshlq_n_u8(c, 3), c, 3);
+        vst2q_u8(&d[i * 2], res);
+      }
+      return i;
+    }
+
+    static uint32_t neon_bgr888_from_swap565(void* dst, const void* src, uint32_t len)
+    {
+      auto d = static_cast<uint8_t*>(dst);
+      auto s = static_cast<const uint8_t*>(src);
+      uint32_t i = 0;
+      for (; i + 16 <= len; i += 16)
+      {
+        uint8x16x2_t c = vld2q_u8(&s[i * 2]);
+        uint8x16_t lo = c.val[0];
+        uint8x16_t hi = c.val[1];
+        uint8x16_t g = vorrq_u8(vshlq_n_u8(lo, 5), vshlq_n_u8(vshrq_n_u8(hi, 5), 2));
+        uint8x16_t b = vshlq_n_u8(hi, 3);
+        uint8x16x3_t rgb;
+        rgb.val[0] = vsriq_n_u8(lo, lo, 5);
+        rgb.val[1] = vsriq_n_u8(g, g, 6);
+        rgb.val[2] = vsriq_n_u8(b, b, 5);
+        vst3q_u8(&d[i * 3], rgb);
+      }
+      return i;
+    }
+
+    static uint32_t neon_bgr888_from_bgra8888(void* dst, const void* src, uint32_t len)
+    {
+      auto d = static_cast<uint8_t*>(dst);
+      auto s = static_cast<const uint8_t*>(src);
+      uint32_t i = 0;
+      for (; i + 16 <= len; i += 16)
+      {
+        uint8x16x4_t argb = vld4q_u8(&s[i * 4]);
+        uint8x16x3_t rgb;
+        rgb.val[0] = argb.val[1];
+        rgb.val[1] = argb.val[2];
+        rgb.val[2] = argb.val[3];
+        vst3q_u8(&d[i * 3], rgb);
+      }
+      return i;
+    }
+
+    static uint32_t neon_bgr888_from_grayscale(void* dst, const void* src, uint32_t len)
+    {
+      auto d = static_cast<uint8_t*>(dst);
+      auto s = static_cast<const uint8_t*>(src);
+      uint32_t i = 0;
+      for (; i + 16 <= len; i += 16)
+      {
+        uint8x16x3_t rgb;
+        rgb.val[0] = rgb.val[1] = rgb.val[2] = vld1q_u8(&s[i]);
+        vst3q_u8(&d[i * 3], rgb);
+      }
+      return i;
+    }
+
+    static uint32_t neon_swap565_blend_fill(void* dst, uint32_t len, uint32_t argb8888)
+    {
+      if (len < 8) { return 0; }
+      auto d = static_cast<uint16_t*>(dst);
+      argb8888_t c { argb8888 };
+      uint_fast16_t a = 1 + c.A8();
+      uint16x8_t inv = vdupq_n_u16(257 - a);
+      uint16x8_t r8a = vdupq_n_u16(c.R8() * a);
+      uint16x8_t g8a = vdupq_n_u16(c.G8() * a);
+      uint16x8_t b8a = vdupq_n_u16(c.B8() * a);
+      uint32_t i = 0;
+      for (; i + 8 <= len; i += 8)
+      {
+        uint16x8_t v = vld1q_u16(&d[i]);
+        uint16x8_t r5 = vandq_u16(vshrq_n_u16(v, 3), vdupq_n_u16(0x1F));
+        uint16x8_t b5 = vandq_u16(vshrq_n_u16(v, 8), vdupq_n_u16(0x1F));
+        uint16x8_t g6 = vorrq_u16(vshlq_n_u16(vandq_u16(v, vdupq_n_u16(7)), 3), vshrq_n_u16(v, 13));
+        uint16x8_t r = vshrq_n_u16(vmlaq_u16(r8a, vorrq_u16(vshlq_n_u16(r5, 3), vshrq_n_u16(r5, 2)), inv), 8);
+        uint16x8_t g = vshrq_n_u16(vmlaq_u16(g8a, vorrq_u16(vshlq_n_u16(g6, 2), vshrq_n_u16(g6, 4)), inv), 8);
+        uint16x8_t b = vshrq_n_u16(vmlaq_u16(b8a, vorrq_u16(vshlq_n_u16(b5, 3), vshrq_n_u16(b5, 2)), inv), 8);
+        uint16x8_t res = vorrq_u16(vandq_u16(r, vdupq_n_u16(0xF8)), vshrq_n_u16(g, 5));
+        res = vorrq_u16(res, vshlq_n_u16(vandq_u16(g, vdupq_n_u16(0x1C)), 11));
+        res = vorrq_u16(res, vshlq_n_u16(vandq_u16(b, vdupq_n_u16(0xF8)), 5));
+        vst1q_u16(&d[i], res);
+      }
+      return i;
+    }
+
+    static uint32_t neon_bgr888_blend_fill(void* dst, uint32_t len, uint32_t argb8888)
+    {
+      if (len < 16) { return 0; }
+      auto d = static_cast<uint8_t*>(dst);
+      argb8888_t c { argb8888 };
+      uint_fast16_t a = 1 + c.A8();
+      bgr888_t px;
+      px.set(c.R8(), c.G8(), c.B8());
+      auto p = reinterpret_cast<const uint8_t*>(&px);
+      uint16x8_t inv = vdupq_n_u16(257 - a);
+      uint16x8_t c8a[3] = { vdupq_n_u16(p[0] * a), vdupq_n_u16(p[1] * a), vdupq_n_u16(p[2] * a) };
+      uint32_t i = 0;
+      for (; i + 16 <= len; i += 16)
+      {
+        uint8x16x3_t v = vld3q_u8(&d[i * 3]);
+        for (int k = 0; k < 3; ++k)
+        {
+          uint16x8_t lo = vmlaq_u16(c8a[k], vmovl_u8(vget_low_u8 (v.val[k])), inv);
+          uint16x8_t hi = vmlaq_u16(c8a[k], vmovl_u8(vget_high_u8(v.val[k])), inv);
+          v.val[k] = vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8));
+        }
+        vst3q_u8(&d[i * 3], v);
+      }
+      return i;
+    }
+
+    static simd_copy_table_t make_simd_copy_table(void)
+    {
+      simd_copy_table_t t;
+      t.swap565_from_bgr888    = neon_swap565_from_bgr888;
+      t.swap565_from_rgb332    = neon_swap565_from_rgb332;
+      t.swap565_from_bgra8888  = neon_swap565_from_bgra8888;
+      t.swap565_from_grayscale = neon_swap565_from_grayscale;
+      t.bgr888_from_swap565    = neon_bgr888_from_swap565;
+      t.bgr888_from_bgra8888   = neon_bgr888_from_bgra8888;
+      t.bgr888_from_grayscale  = neon_bgr888_from_grayscale;
+      t.swap565_blend_fill     = neon_swap565_blend_fill;
+      t.bgr888_blend_fill      = neon_bgr888_blend_fill;
+      return t;
+    }
+
+#elif defined ( LGFX_SIMD_SSE2 )
+
+//----------------------------------------------------------------------------
+// SSE2
+
+    // r, g, b : 8bit value in each 16bit lane.
+    static inline __m128i sse2_swap565(__m128i r, __m128i g, __m128i b)
+    {
+      __m128i res = _mm_and_si128(r, _mm_set1_epi16(0xF8));
+      res = _mm_or_si128(res, _mm_srli_epi16(g, 5));
+      res = _mm_or_si128(res, _mm_slli_epi16(_mm_and_si128(g, _mm_set1_epi16(0x1C)), 11));
+      return _mm_or_si128(res, _mm_slli_epi16(_mm_and_si128(b, _mm_set1_epi16(0xF8)), 5));
+    }
+
+    static inline __m128i sse2_swap565_from_rgb332(__m128i c)
+    {
+      __m128i r3 = _mm_srli_epi16(c, 5);
+      __m128i g3 = _mm_and_si128(_mm_srli_epi16(c, 2), _mm_set1_epi16(7));
+      __m128i b2 = _mm_and_si128(c, _mm_set1_epi16(3));
+      __m128i r5 = _mm_add_epi16(_mm_slli_epi16(r3, 2), _mm_srli_epi16(r3, 1));
+      __m128i b5 = _mm_add_epi16(_mm_add_epi16(_mm_slli_epi16(b2, 3), _mm_slli_epi16(b2, 1)), _mm_srli_epi16(b2, 1));
+      __m128i res = _mm_or_si128(_mm_slli_epi16(r5, 3), g3);
+      res = _mm_or_si128(res, _mm_slli_epi16(g3, 13));
+      return _mm_or_si128(res, _mm_slli_epi16(b5, 8));
+    }
+
+    // bgra8888 in each 32bit lane, result is zero extended swap565.
+    static inline __m128i sse2_swap565_from_bgra8888(__m128i v)
+    {
+      __m128i res = _mm_and_si128(_mm_srli_epi32(v,  8), _mm_set1_epi32(0x00F8));
+      res = _mm_or_si128(res, _mm_and_si128(_mm_srli_epi32(v, 21), _mm_set1_epi32(0x0007)));
+      res = _mm_or_si128(res, _mm_and_si128(_mm_srli_epi32(v,  5), _mm_set1_epi32(0xE000)));
+      return _mm_or_si128(res, _mm_and_si128(_mm_srli_epi32(v, 19), _mm_set1_epi32(0x1F00)));
+    }
+
+    // packs two vectors of zero extended 16bit values without saturation.
+    static inline __m128i sse2_pack_u32_to_u16(__m128i a, __m128i b)
+    {
+      a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+      b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+      return _mm_packs_epi32(a, b);
+    }
+
+    static uint32_t sse2_swap565_from_rgb332(void* dst, const void* src, uint32_t len)
+    {
+      auto d = static_cast<uint8_t*>(dst);
+      auto s = static_cast<const uint8_t*>(src);
+      auto zero = _mm_setzero_si128();
+      uint32_t i = 0;
+      for (; i + 16 <= len; i += 16)
+      {
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&s[i]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&d[i * 2     ]), sse2_swap565_from_rgb332(_mm_unpacklo_epi8(c, zero)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&d[i * 2 + 16]), sse2_swap565_from_rgb332(_mm_unpackhi_epi8(c, zero)));
+      }
+      return i;
+    }
+
+    static uint32_t sse2_swap565_from_grayscale(void* dst, const void* src, uint32_t len)
+    {
+      auto d = static_cast<uint8_t*>(dst);
+      auto s = static_cast<const uint8_t*>(src);
+      auto zero = _mm_setzero_si128();
+      uint32_t i = 0;
+      for (; i + 16 <= len; i += 16)
+      {
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&s[i]));
+        __m128i lo = _mm_unpacklo_epi8(c, zero);
+        __m128i hi = _mm_unpackhi_epi8(c, zero);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&d[i * 2     ]), sse2_swap565(lo, lo, lo));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&d[i * 2 + 16]), sse2_swap565(hi, hi, hi));
+      }
+      return i;
+    }
+
+    static uint32_t sse2_swap565_from_bgra8888(void* dst, const void* src, uint32_t len)
+    {
+      auto d = static_cast<uint8_t*>(dst);
+      auto s = static_cast<const uint8_t*>(src);
+      uint32_t i = 0;
+      for (; i + 8 <= len; i += 8)
+      {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&s[i * 4     ]));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&s[i * 4 + 16]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&d[i * 2]), sse2_pack_u32_to_u16(sse2_swap565_from_bgra8888(a), sse2_swap565_from_bgra8888(b)));
+      }
+      return i;
+    }
+
+    // 8bit value in each 16bit lane.
+    static inline __m128i sse2_blend(__m128i c8a, __m128i dst, __m128i inv)
+    {
+      return _mm_srli_epi16(_mm_add_epi16(c8a, _mm_mullo_epi16(dst, inv)), 8);
+    }
+
+    static uint32_t sse2_swap565_blend_fill(void* dst, uint32_t len, uint32_t argb8888)
+    {
+      if (len < 8) { return 0; }
+      auto d = static_cast<uint8_t*>(dst);
+      argb8888_t c { argb8888 };
+      uint_fast16_t a = 1 + c.A8();
+      __m128i inv = _mm_set1_epi16(257 - a);
+      __m128i r8a = _mm_set1_epi16(c.R8() * a);
+      __m128i g8a = _mm_set1_epi16(c.G8() * a);
+      __m128i b8a = _mm_set1_epi16(c.B8() * a);
+      uint32_t i = 0;
+      for (; i + 8 <= len; i += 8)
+      {
+        auto p = reinterpret_cast<__m128i*>(&d[i * 2]);
+        __m128i v = _mm_loadu_si128(p);
+        __m128i r5 = _mm_and_si128(_mm_srli_epi16(v, 3), _mm_set1_epi16(0x1F));
+        __m128i b5 = _mm_and_si128(_mm_srli_epi16(v, 8), _mm_set1_epi16(0x1F));
+        __m128i g6 = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(v, _mm_set1_epi16(7)), 3), _mm_srli_epi16(v, 13));
+        __m128i r = sse2_blend(r8a, _mm_or_si128(_mm_slli_epi16(r5, 3), _mm_srli_epi16(r5, 2)), inv);
+        __m128i g = sse2_blend(g8a, _mm_or_si128(_mm_slli_epi16(g6, 2), _mm_srli_epi16(g6, 4)), inv);
+        __m128i b = sse2_blend(b8a, _mm_or_si128(_mm_slli_epi16(b5, 3), _mm_srli_epi16(b5, 2)), inv);
+        _mm_storeu_si128(p, sse2_swap565(r, g, b));
+      }
+      return i;
+    }
+
+    // every byte is blended independently, the color repeats every 3 bytes (48 bytes = 16 pixels = 3 vectors).
+    static uint32_t sse2_bgr888_blend_fill(void* dst, uint32_t len, uint32_t argb8888)
+    {
+      if (len < 16) { return 0; }
+      auto d = static_cast<uint8_t*>(dst);
+      argb8888_t c { argb8888 };
+      uint_fast16_t a = 1 + c.A8();
+      bgr888_t px;
+      px.set(c.R8(), c.G8(), c.B8());
+      auto p = reinterpret_cast<const uint8_t*>(&px);
+      alignas(16) uint16_t c8a[48];
+      for (uint32_t j = 0; j < 48; ++j) { c8a[j] = p[j % 3] * a; }
+      auto c8av = reinterpret_cast<const __m128i*>(c8a);
+      __m128i inv = _mm_set1_epi16(257 - a);
+      __m128i zero = _mm_setzero_si128();
+      uint32_t i = 0;
+      for (; i + 16 <= len; i += 16)
+      {
+        auto v = reinterpret_cast<__m128i*>(&d[i * 3]);
+        for (int k = 0; k < 3; ++k)
+        {
+          __m128i s = _mm_loadu_si128(&v[k]);
+          __m128i lo = sse2_blend(_mm_load_si128(&c8av[k * 2    ]), _mm_unpacklo_epi8(s, zero), inv);
+          __m128i hi = sse2_blend(_mm_load_si128(&c8av[k * 2 + 1]), _mm_unpackhi_epi8(s, zero), inv);
+          _mm_storeu_si128(&v[k], _mm_packus_epi16(lo, hi));
+        }
+      }
+      return i;
+    }
+
+#if defined ( LGFX_SIMD_X86_DISPATCH )
+
+//----------------------------------------------------------------------------
+// SSSE3 (24bit packed formats)
+
+    alignas(16) static constexpr int8_t deinterleave_mask[3][3][16] =
+    { { {  0,  3,  6,  9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 }
+      , { -1, -1, -1, -1, -1, -1,  2,  5,  8, 11, 14, -1, -1, -1, -1, -1 }
+      , { -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  1,  4,  7, 10, 13 } }
+    , { {  1,  4,  7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 }
+      , { -1, -1, -1, -1, -1,  0,  3,  6,  9, 12, 15, -1, -1, -1, -1, -1 }
+      , { -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  2,  5,  8, 11, 14 } }
+    , { {  2,  5,  8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 }
+      , { -1, -1, -1, -1, -1,  1,  4,  7, 10, 13, -1, -1, -1, -1, -1, -1 }
+      , { -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  0,  3,  6,  9, 12, 15 } }
+    };
+
+    alignas(16) static constexpr int8_t interleave_mask[3][3][16] =
+    { { {  0, -1, -1,  1, -1, -1,  2, -1, -1,  3, -1, -1,  4, -1, -1,  5 }
+      , { -1,  0, -1, -1,  1, -1, -1,  2, -1, -1,  3, -1, -1,  4, -1, -1 }
+      , { -1, -1,  0, -1, -1,  1, -1, -1,  2, -1, -1,  3, -1, -1,  4, -1 } }
+    , { { -1, -1,  6, -1, -1,  7, -1, -1,  8, -1, -1,  9, -1, -1, 10, -1 }
+      , {  5, -1, -1,  6, -1, -1,  7, -1, -1,  8, -1, -1,  9, -1, -1, 10 }
+      , { -1,  5, -1, -1,  6, -1, -1,  7, -1, -1,  8, -1, -1,  9, -1, -1 } }
+    , { { -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1, -1 }
+      , { -1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1 }
+      , { 10, -1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15 } }
+    };
+
+    alignas(16) static constexpr int8_t gray_to_rgb_mask[3][16] =
+    { {  0,  0,  0,  1,  1,  1,  2,  2,  2,  3,  3,  3,  4,  4,  4,  5 }
+    , {  5,  5,  6,  6,  6,  7,  7,  7,  8,  8,  8,  9,  9,  9, 10, 10 }
+    , { 10, 11, 11, 11, 12, 12, 12, 13, 13, 13, 14, 14, 14, 15, 15, 15 }
+    };
+
+    alignas(16) static constexpr int8_t drop_alpha_mask[16] = { 1, 2, 3, 5, 6, 7, 9, 10, 11, 13, 14, 15, -1, -1, -1, -1 };
+
+    LGFX_TARGET_SSSE3 static inline __m128i ssse3_mask(const int8_t* m)
+    {
+      return _mm_load_si128(reinterpret_cast<const __m128i*>(m));
+    }
+
+    LGFX_TARGET_SSSE3 static inline __m128i ssse3_gather(const __m128i* v, const int8_t (*m)[16])
+    {
+      return _mm_or_si128(_mm_or_si128( _mm_shuffle_epi8(v[0], ssse3_mask(m[0]))
+                                      , _mm_shuffle_epi8(v[1], ssse3_mask(m[1])))
+                                      , _mm_shuffle_epi8(v[2], ssse3_mask(m[2])));
+    }
+
+    LGFX_TARGET_SSSE3 static uint32_t ssse3_swap565_from_bgr888(void* dst, const void* src, uint32_t len)
+    {
+      auto d = static_cast<uint8_t*>(dst);
+      auto s = static_cast<const uint8_t*>(src);
+      auto zero = _mm_setzero_si128();
+      uint32_t i = 0;
+      for (; i + 16 <= len; i += 16)
+      {
+        __m128i v[3];
+        v[0] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&s[i * 3     ]));
+        v[1] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&s[i * 3 + 16]));
+        v[2] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&s[i * 3 + 32]));
+        __m128i r = ssse3_gather(v, deinterleave_mask[0]);
+        __m128i g = ssse3_gather(v, deinterleave_mask[1]);
+        __m128i b = ssse3_gather(v, deinterleave_mask[2]);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&d[i * 2     ]), sse2_swap565(_mm_unpacklo_epi8(r, zero), _mm_unpacklo_epi8(g, zero), _mm_unpacklo_epi8(b, zero)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&d[i * 2 + 16]), sse2_swap565(_mm_unpackhi_epi8(r, zero), _mm_unpackhi_epi8(g, zero), _mm_unpackhi_epi8(b, zero)));
+      }
+      return i;
+    }
+
+    LGFX_TARGET_SSSE3 static uint32_t ssse3_bgr888_from_swap565(void* dst, const void* src, uint32_t len)
+    {
+      auto d = static_cast<uint8_t*>(dst);
+      auto s = static_cast<const uint8_t*>(src);
+      uint32_t i = 0;
+      for (; i + 16 <= len; i += 16)
+      {
+        __m128i ch[3][2];
+        for (int j = 0; j < 2; ++j)
+        {
+          __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&s[i * 2 + j * 16]));
+          __m128i r = _mm_and_si128(c, _mm_set1_epi16(0xF8));
+          ch[0][j] = _mm_or_si128(r, _mm_srli_epi16(r, 5));
+          __m128i g = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(c, _mm_set1_epi16(7)), 3), _mm_srli_epi16(c, 13));
+          ch[1][j] = _mm_or_si128(_mm_slli_epi16(g, 2), _mm_srli_epi16(g, 4));
+          __m128i b = _mm_and_si128(_mm_srli_epi16(c, 8), _mm_set1_epi16(0x1F));
+          ch[2][j] = _mm_or_si128(_mm_slli_epi16(b, 3), _mm_srli_epi16(b, 2));
+        }
+        __m128i v[3];
+        v[0] = _mm_packus_epi16(ch[0][0], ch[0][1]);
+        v[1] = _mm_packus_epi16(ch[1][0], ch[1][1]);
+        v[2] = _mm_packus_epi16(ch[2][0], ch[2][1]);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&d[i * 3     ]), ssse3_gather(v, interleave_mask[0]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&d[i * 3 + 16]), ssse3_gather(v, interleave_mask[1]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&d[i * 3 + 32]), ssse3_gather(v, interleave_mask[2]));
+      }
+      return i;
+    }
+
+    LGFX_TARGET_SSSE3 static uint32_t ssse3_bgr888_from_bgra8888(void* dst, const void* src, uint32_t len)
+    {
+      auto d = static_cast<uint8_t*>(dst);
+      auto s = static_cast<const uint8_t*>(src);
+      auto m = ssse3_mask(drop_alpha_mask);
+      uint32_t i = 0;
+      for (; i + 16 <= len; i += 16)
+      {
+        __m128i t0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&s[i * 4     ])), m);
+        __m128i t1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&s[i * 4 + 16])), m);
+        __m128i t2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&s[i * 4 + 32])), m);
+        __m128i t3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&s[i * 4 + 48])), m);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&d[i * 3     ]), _mm_or_si128(t0, _mm_slli_si128(t1, 12)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&d[i * 3 + 16]), _mm_or_si128(_mm_srli_si128(t1, 4), _mm_slli_si128(t2, 8)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&d[i * 3 + 32]), _mm_or_si128(_mm_srli_si128(t2, 8), _mm_slli_si128(t3, 4)));
+      }
+      return i;
+    }
+
+    LGFX_TARGET_SSSE3 static uint32_t ssse3_bgr888_from_grayscale(void* dst, const void* src, uint32_t len)
+    {
+      auto d = static_cast<uint8_t*>(dst);
+      auto s = static_cast<const uint8_t*>(src);
+      uint32_t i = 0;
+      for (; i + 16 <= len; i += 16)
+      {
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&s[i]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&d[i * 3     ]), _mm_shuffle_epi8(c, ssse3_mask(gray_to_rgb_mask[0])));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&d[i * 3 + 16]), _mm_shuffle_epi8(c, ssse3_mask(gray_to_rgb_mask[1])));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&d[i * 3 + 32]), _mm_shuffle_epi8(c, ssse3_mask(gray_to_rgb_mask[2])));
+      }
+      return i;
+    }
+
+//----------------------------------------------------------------------------
+// AVX2
+
+    LGFX_TARGET_AVX2 static uint32_t avx2_swap565_from_rgb332(void* dst, const void* src, uint32_t len)
+    {
+      auto d = static_cast<uint8_t*>(dst);
+      auto s = static_cast<const uint8_t*>(src);
+      uint32_t i = 0;
+      for (; i + 16 <= len; i += 16)
+      {
+        __m256i c = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&s[i])));
+        __m256i r3 = _mm256_srli_epi16(c, 5);
+        __m256i g3 = _mm256_and_si256(_mm256_srli_epi16(c, 2), _mm256_set1_epi16(7));
+        __m256i b2 = _mm256_and_si256(c, _mm256_set1_epi16(3));
+        __m256i r5 = _mm256_add_epi16(_mm256_slli_epi16(r3, 2), _mm256_srli_epi16(r3, 1));
+        __m256i b5 = _mm256_add_epi16(_mm256_mullo_epi16(b2, _mm256_set1_epi16(10)), _mm256_srli_epi16(b2, 1));
+        __m256i res = _mm256_or_si256(_mm256_slli_epi16(r5, 3), g3);
+        res = _mm256_or_si256(res, _mm256_slli_epi16(g3, 13));
+        res = _mm256_or_si256(res, _mm256_slli_epi16(b5, 8));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&d[i * 2]), res);
+      }
+      return i;
+    }
+
+    LGFX_TARGET_AVX2 static uint32_t avx2_swap565_from_grayscale(void* dst, const void* src, uint32_t len)
+    {
+      auto d = static_cast<uint8_t*>(dst);
+      auto s = static_cast<const uint8_t*>(src);
+      uint32_t i = 0;
+      for (; i + 16 <= len; i += 16)
+      {
+        __m256i c = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&s[i])));
+        __m256i rb = _mm256_and_si256(c, _mm256_set1_epi16(0xF8));
+        __m256i res = _mm256_or_si256(rb, _mm256_srli_epi16(c, 5));
+        res = _mm256_or_si256(res, _mm256_slli_epi16(_mm256_and_si256(c, _mm256_set1_epi16(0x1C)), 11));
+        res = _mm256_or_si256(res, _mm256_slli_epi16(rb, 5));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&d[i * 2]), res);
+      }
+      return i;
+    }
+
+    LGFX_TARGET_AVX2 static inline __m256i avx2_swap565_from_bgra8888(__m256i v)
+    {
+      __m256i res = _mm256_and_si256(_mm256_srli_epi32(v,  8), _mm256_set1_epi32(0x00F8));
+      res = _mm256_or_si256(res, _mm256_and_si256(_mm256_srli_epi32(v, 21), _mm256_set1_epi32(0x0007)));
+      res = _mm256_or_si256(res, _mm256_and_si256(_mm256_srli_epi32(v,  5), _mm256_set1_epi32(0xE000)));
+      res = _mm256_or_si256(res, _mm256_and_si256(_mm256_srli_epi32(v, 19), _mm256_set1_epi32(0x1F00)));
+      return _mm256_srai_epi32(_mm256_slli_epi32(res, 16), 16);
+    }
+
+    LGFX_TARGET_AVX2 static uint32_t avx2_swap565_from_bgra8888(void* dst, const void* src, uint32_t len)
+    {
+      auto d = static_cast<uint8_t*>(dst);
+      auto s = static_cast<const uint8_t*>(src);
+      uint32_t i = 0;
+      for (; i + 16 <= len; i += 16)
+      {
+        __m256i a = avx2_swap565_from_bgra8888(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&s[i * 4     ])));
+        __m256i b = avx2_swap565_from_bgra8888(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&s[i * 4 + 32])));
+        __m256i res = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&d[i * 2]), res);
+      }
+      return i;
+    }
+
+#endif // LGFX_SIMD_X86_DISPATCH
+
+    static simd_copy_table_t make_simd_copy_table(void)
+    {
+      simd_copy_table_t t;
+      t.swap565_from_rgb332    = sse2_swap565_from_rgb332;
+      t.swap565_from_bgra8888  = sse2_swap565_from_bgra8888;
+      t.swap565_from_grayscale = sse2_swap565_from_grayscale;
+      t.swap565_blend_fill     = sse2_swap565_blend_fill;
+      t.bgr888_blend_fill      = sse2_bgr888_blend_fill;
+#if defined ( LGFX_SIMD_X86_DISPATCH )
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("ssse3"))
+      {
+        t.swap565_from_bgr888   = ssse3_swap565_from_bgr888;
+        t.bgr888_from_swap565   = ssse3_bgr888_from_swap565;
+        t.bgr888_from_bgra8888  = ssse3_bgr888_from_bgra8888;
+        t.bgr888_from_grayscale = ssse3_bgr888_from_grayscale;
+      }
+      if (__builtin_cpu_supports("avx2"))
+      {
+        t.swap565_from_rgb332    = avx2_swap565_from_rgb332;
+        t.swap565_from_bgra8888  = avx2_swap565_from_bgra8888;
+        t.swap565_from_grayscale = avx2_swap565_from_grayscale;
+      }
+#endif
+      return t;
+    }
+
+#endif
+
+    static const simd_copy_table_t& simd_copy_table(void)
+    {
+      static const simd_copy_table_t table = make_simd_copy_table();
+      return table;
+    }
+
+    static inline uint32_t call_simd(simd_copy_fn_t fn, void* dst, const void* src, uint32_t len)
+    {
+      return fn ? fn(dst, src, len) : 0;
+    }
+
+    template<> uint32_t pixelcopy_t::copy_rgb_simd<swap565_t, bgr888_t   >(void* dst, const void* src, uint32_t len) { return call_simd(simd_copy_table().swap565_from_bgr888   , dst, src, len); }
+    template<> uint32_t pixelcopy_t::copy_rgb_simd<swap565_t, rgb332_t   >(void* dst, const void* src, uint32_t len) { return call_simd(simd_copy_table().swap565_from_rgb332   , dst, src, len); }
+    template<> uint32_t pixelcopy_t::copy_rgb_simd<swap565_t, bgra8888_t >(void* dst, const void* src, uint32_t len) { return call_simd(simd_copy_table().swap565_from_bgra8888 , dst, src, len); }
+    template<> uint32_t pixelcopy_t::copy_rgb_simd<swap565_t, grayscale_t>(void* dst, const void* src, uint32_t len) { return call_simd(simd_copy_table().swap565_from_grayscale, dst, src, len); }
+    template<> uint32_t pixelcopy_t::copy_rgb_simd<bgr888_t , swap565_t  >(void* dst, const void* src, uint32_t len) { return call_simd(simd_copy_table().bgr888_from_swap565   , dst, src, len); }
+    template<> uint32_t pixelcopy_t::copy_rgb_simd<bgr888_t , bgra8888_t >(void* dst, const void* src, uint32_t len) { return call_simd(simd_copy_table().bgr888_from_bgra8888  , dst, src, len); }
+    template<> uint32_t pixelcopy_t::copy_rgb_simd<bgr888_t , grayscale_t>(void* dst, const void* src, uint32_t len) { return call_simd(simd_copy_table().bgr888_from_grayscale , dst, src, len); }
+
+    template<> uint32_t pixelcopy_t::blend_fill_simd<swap565_t>(void* dst, uint32_t len, uint32_t argb8888)
+    {
+      auto fn = simd_copy_table().swap565_blend_fill;
+      return fn ? fn(dst, len, argb8888) : 0;
+    }
+    template<> uint32_t pixelcopy_t::blend_fill_simd<bgr888_t >(void* dst, uint32_t len, uint32_t argb8888)
+    {
+      auto fn = simd_copy_table().bgr888_blend_fill;
+      return fn ? fn(dst, len, argb8888) : 0;
+    }
+
+//----------------------------------------------------------------------------
+  }
+}
+
+#endif
@@ -0,0 +1,74 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [FreeBSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+#pragma once
+
+#include <stdint.h>
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  /// 描画スレッドとは別のスレッドで表示を行うパネルの統計 (PC向け);
+  /// Statistics of a panel presenting its frames on another thread. (host platforms)
+  struct present_stats_t
+  {
+    uint32_t frames;          // frames handed over by display()
+    uint32_t presented;       // frames shown on the screen
+    uint32_t dropped;         // frames replaced by a newer one before they were shown
+    uint32_t latency_last_us; // from display() to the end of the presentation
+    uint32_t latency_avg_us;  // moving average of the last 16 frames or so
+    uint32_t latency_max_us;
+
+    void addLatency(uint32_t us)
+    {
+      ++presented;
+      latency_last_us = us;
+      latency_avg_us = (presented == 1) ? us : latency_avg_us + (int32_t)(us - latency_avg_us) / 16;
+      if (latency_max_us < us) { latency_max_us = us; }
+    }
+  };
+
+  /// display() の呼出し間隔を一定のフレームレートに制限する;
+  /// Holds the calls of display() to a fixed frame rate.
+  struct frame_pacer_t
+  {
+    uint32_t interval_us = 0; // 0 = not limited
+    uint32_t next_us = 0;
+
+    void setFrameRate(uint32_t fps) { interval_us = fps ? 1000000u / fps : 0; }
+
+    /// @return microseconds to wait before handing over the next frame.
+    uint32_t wait_time(uint32_t now_us)
+    {
+      if (interval_us == 0) { return 0; }
+      int32_t diff = next_us - now_us;
+      if (diff <= 0 || diff > (int32_t)interval_us)
+      { // late (or first frame): start a new schedule instead of catching up.
+        next_us = now_us + interval_us;
+        return 0;
+      }
+      next_us += interval_us;
+      return diff;
+    }
+  };
+
+//----------------------------------------------------------------------------
+ }
+}
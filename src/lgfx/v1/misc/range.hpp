@@ -79,6 +79,18 @@ namespace lgfx
   };
 #pragma pack(pop)
 
+  struct point_t
+  {
+    int32_t x;
+    int32_t y;
+  };
+
+  struct pointf_t
+  {
+    float x;
+    float y;
+  };
+
 //----------------------------------------------------------------------------
  }
 }
@@ -37,6 +37,10 @@ namespace lgfx
   {
     static Bus_NULL nullobj;
     _bus = bus ? bus : &nullobj;
+#if defined ( LGFX_USE_PERF_COUNTER )
+    _bus_perf.setTarget(_bus);
+    _bus = &_bus_perf;
+#endif
   }
 
   void Panel_Device::setBrightness(uint8_t brightness)
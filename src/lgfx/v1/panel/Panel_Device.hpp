@@ -19,6 +19,10 @@ Contributors:
 
 #include "../Panel.hpp"
 
+#if defined ( LGFX_USE_PERF_COUNTER )
+#include "../Bus.hpp"
+#endif
+
 namespace lgfx
 {
  inline namespace v1
@@ -118,8 +122,14 @@ namespace lgfx
     virtual void releaseBus(void);
     void setBus(IBus* bus);
     void bus(IBus* bus) { setBus(bus); };
+#if defined ( LGFX_USE_PERF_COUNTER )
+    IBus* getBus(void) const { return _bus_perf.getTarget(); }
+    IBus* bus(void) const { return _bus_perf.getTarget(); }
+    bus_perf_counter_t* getBusPerfCounter(void) override { return _bus_perf.getPerfCounter(); }
+#else
     IBus* getBus(void) const { return _bus; }
     IBus* bus(void) const { return _bus; }
+#endif
 
     void setLight(ILight* light) { _light = light; }
     void light(ILight* light) { _light = light; }
@@ -161,6 +171,10 @@ namespace lgfx
     config_t _cfg;
 
     IBus* _bus = nullptr;
+#if defined ( LGFX_USE_PERF_COUNTER )
+    /// _bus はこのオブジェクトを指し、setBusで指定されたバスへ中継される;
+    Bus_PerfCounter _bus_perf;
+#endif
     ILight* _light = nullptr;
     ITouch* _touch = nullptr;
     bool _has_align_data = false;
@@ -136,6 +136,43 @@ namespace lgfx
     }
   }
 
+  void Panel_FrameBufferBase::writeFillRectAlphaPreclipped(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t argb8888)
+  {
+    auto fp_blend = pixelcopy_t::get_fp_blend_fill(_write_depth);
+    if (fp_blend == nullptr)
+    {
+      Panel_Device::writeFillRectAlphaPreclipped(x, y, w, h, argb8888);
+      return;
+    }
+
+    uint_fast8_t r = _internal_rotation;
+    if (r)
+    {
+      if ((1u << r) & 0b10010110) { y = _height - (y + h); }
+      if (r & 2)                  { x = _width  - (x + w); }
+      if (r & 1) { std::swap(x, y);  std::swap(w, h); }
+    }
+    h += y;
+    size_t bytes = _write_bits >> 3;
+    do
+    {
+      auto ptr = &_lines_buffer[y][x * bytes];
+      fp_blend(ptr, w, argb8888);
+      cacheWriteBack(ptr, bytes * w);
+    } while (++y < h);
+  }
+
+  void Panel_FrameBufferBase::commitFrameBuffer(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h)
+  {
+    if (!w || !h) return;
+    size_t bytes = _write_bits >> 3;
+    h += y;
+    do
+    {
+      cacheWriteBack(&_lines_buffer[y][x * bytes], bytes * w);
+    } while (++y < h);
+  }
+
   void Panel_FrameBufferBase::writeBlock(uint32_t rawcolor, uint32_t length)
   {
     do
@@ -30,6 +30,7 @@ namespace lgfx
   {
     void setWindow(uint_fast16_t xs, uint_fast16_t ys, uint_fast16_t xe, uint_fast16_t ye) override
     {
+      LGFX_PERF_COUNT(++_perf.set_window);
       if (xs != _xs || xe != _xe || ys != _ys || ye != _ye)
       {
         if (_internal_rotation & 1)
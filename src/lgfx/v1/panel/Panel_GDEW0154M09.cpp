@@ -37,6 +37,7 @@ namespace lgfx
   {
     _cfg.dummy_read_bits = 0;
     _epd_mode = epd_mode_t::epd_quality;
+    _grayscale = true;
   }
 
   color_depth_t Panel_GDEW0154M09::setColorDepth(color_depth_t depth)
@@ -109,7 +109,7 @@ namespace lgfx
 
   void Panel_HUB75::setBrightness(uint8_t brightness)
   {
-    ((Bus_ImagePush*)_bus)->setBrightness(brightness);
+    ((Bus_ImagePush*)getBus())->setBrightness(brightness);
   }
 
   bool Panel_HUB75::_init_frame_buffer(uint_fast16_t total_width, uint_fast16_t single_height)
@@ -123,7 +123,7 @@ namespace lgfx
       return false;
     }
 
-    ((Bus_ImagePush*)_bus)->setImageBuffer((void*)&_frame_buffer, _write_depth);
+    ((Bus_ImagePush*)getBus())->setImageBuffer((void*)&_frame_buffer, _write_depth);
 
     return true;
   }
@@ -141,6 +141,7 @@ namespace lgfx
 
   void Panel_ILI9225::set_window(uint_fast16_t xs, uint_fast16_t ys, uint_fast16_t xe, uint_fast16_t ye, uint32_t cmd)
   {
+    LGFX_PERF_COUNT(++_perf.set_window);
     if (_internal_rotation & 1)
     {
       std::swap(xs, ys);
@@ -111,6 +111,7 @@ IT8951 Registers defines
     _cfg.panel_width  = _cfg.memory_width  = 2048;
     _cfg.panel_height = _cfg.memory_height = 2048;
     _epd_mode = epd_mode_t::epd_quality;
+    _grayscale = true;
     _auto_display = true;
   }
 
@@ -338,7 +339,7 @@ IT8951 Registers defines
       {
         uint32_t buf = getSwap16(args[i]);
         _bus->wait();
-        while (!lgfx::gpio_in(_cfg.pin_busy));
+        while (_cfg.pin_busy >= 0 && !lgfx::gpio_in(_cfg.pin_busy));
         _bus->writeData(buf, 16);
       } while ( ++i < length );
       return true;
@@ -225,6 +225,7 @@ namespace lgfx
 
   void Panel_LCD::setWindow(uint_fast16_t xs, uint_fast16_t ys, uint_fast16_t xe, uint_fast16_t ye)
   {
+    LGFX_PERF_COUNT(++_perf.set_window);
     if (!_cfg.dlen_16bit)
     {
       set_window_8(xs, ys, xe, ye, CMD_RAMWR);
@@ -485,7 +485,7 @@ namespace lgfx
 
     if ((_read_fpga_id() & 0xFFFF) != ('H' | 'D' << 8))
     {
-      auto bus_cfg = reinterpret_cast<lgfx::Bus_SPI*>(_bus)->config();
+      auto bus_cfg = reinterpret_cast<lgfx::Bus_SPI*>(getBus())->config();
       gpio::pin_backup_t backup_pins[] = { bus_cfg.pin_sclk, bus_cfg.pin_mosi, bus_cfg.pin_miso };
       LOAD_FPGA fpga(bus_cfg.pin_sclk, bus_cfg.pin_mosi, bus_cfg.pin_miso, _cfg.pin_cs);
       for (auto &bup : backup_pins) { bup.restore(); }
@@ -1069,6 +1069,7 @@ namespace lgfx
   }
   void Panel_M5HDMI::_set_window(uint_fast16_t xs, uint_fast16_t ys, uint_fast16_t xe, uint_fast16_t ye, uint_fast8_t cmd_write)
   {
+    LGFX_PERF_COUNT(++_perf.set_window);
     union cmd_t
     {
       uint8_t raw[11];
@@ -320,6 +320,7 @@ namespace lgfx
   }
   void Panel_M5UnitLCD::_set_window(uint_fast16_t xs, uint_fast16_t ys, uint_fast16_t xe, uint_fast16_t ye)
   {
+    LGFX_PERF_COUNT(++_perf.set_window);
     uint8_t buf[10];
     size_t idx = 0;
     bool flg_large = (_cfg.memory_width >= 256) || (_cfg.memory_height >= 256);
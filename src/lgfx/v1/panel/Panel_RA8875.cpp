@@ -332,6 +332,7 @@ namespace lgfx
 
   void Panel_RA8875::setWindow(uint_fast16_t xs, uint_fast16_t ys, uint_fast16_t xe, uint_fast16_t ye)
   {
+    LGFX_PERF_COUNT(++_perf.set_window);
     _xs = xs;
     _xe = xe;
     _ys = ys;
@@ -205,6 +205,7 @@ namespace lgfx
 
   void Panel_RM68120::setWindow(uint_fast16_t xs, uint_fast16_t ys, uint_fast16_t xe, uint_fast16_t ye)
   {
+    LGFX_PERF_COUNT(++_perf.set_window);
     bool dlen_16bit = _cfg.dlen_16bit;
     if (dlen_16bit && _has_align_data)
     {
@@ -28,6 +28,8 @@ namespace lgfx
 
   struct Panel_1bitOLED : public Panel_HasBuffer
   {
+    Panel_1bitOLED(void) : Panel_HasBuffer() { _grayscale = true; }
+
     bool init(bool use_reset) override;
 
     void waitDisplay(void) override;
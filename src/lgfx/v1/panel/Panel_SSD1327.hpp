@@ -33,6 +33,7 @@ namespace lgfx
     {
       _cfg.memory_width  = _cfg.panel_width  = 128;
       _cfg.memory_height = _cfg.panel_height = 128;
+      _grayscale = true;
     }
 
     bool init(bool use_reset) override;
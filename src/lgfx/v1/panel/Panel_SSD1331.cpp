@@ -126,6 +126,7 @@ namespace lgfx
 
   void Panel_SSD1331::setWindow(uint_fast16_t xs, uint_fast16_t ys, uint_fast16_t xe, uint_fast16_t ye)
   {
+    LGFX_PERF_COUNT(++_perf.set_window);
     if (_need_delay)
     {
       auto us = lgfx::micros() - _last_us;
@@ -99,6 +99,7 @@ namespace lgfx
 
   void Panel_SSD1351::set_window_8(uint_fast16_t xs, uint_fast16_t ys, uint_fast16_t xe, uint_fast16_t ye, uint32_t cmd)
   {
+    LGFX_PERF_COUNT(++_perf.set_window);
     if (xs != _xs || xe != _xe)
     {
       _xs = xs;
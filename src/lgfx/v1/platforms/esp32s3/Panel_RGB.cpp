@@ -211,7 +211,7 @@ namespace lgfx
       writeData(line2, 1);
 
       // 0xC3 : RGBCTRL
-      auto cfg = ((Bus_RGB*)_bus)->config();
+      auto cfg = ((Bus_RGB*)getBus())->config();
       writeCommand(0xC3, 1);
       uint32_t rgbctrl = 0;
       if ( cfg.de_idle_high  ) rgbctrl += 0x01;
@@ -36,62 +36,121 @@ namespace lgfx
  inline namespace v1
  {
 //----------------------------------------------------------------------------
-  void Panel_fb::fb_draw_rgb_pixel(int x, int y, uint32_t rawcolor)
+  template <size_t Bytes>
+  static inline void swap_copy(uint8_t* __restrict dst, const uint8_t* __restrict src, uint32_t len, int32_t dst_step, int32_t src_step)
   {
-    unsigned int pix_offset = 0;
-    uint8_t r = 0, g = 0, b = 0;
+    do
+    {
+      for (size_t i = 0; i < Bytes; ++i) { dst[i] = src[Bytes - 1 - i]; }
+      dst += dst_step;
+      src += src_step;
+    } while (--len);
+  }
 
-    // GGGBBBBB RRRRRGGG
-    if (_write_depth = color_depth_t::rgb565_2Byte)
+  void Panel_fb::fb_swap_copy(uint8_t* dst, const uint8_t* src, uint32_t len, int32_t dst_step, int32_t src_step) const
+  {
+    switch (_write_bits >> 3)
     {
-      b = (uint8_t)((rawcolor >> 8) & 0b11111);
-      g = (uint8_t)((((rawcolor >> 10) & 0b111000)) | (rawcolor & 0b111));
-      r = (uint8_t)((rawcolor >> 3) & 0b11111);
-
-      pix_offset = x * 2 + y * _fix_info.line_length;
-      unsigned short c = (r << 11) | (g << 5) | b;
-      // write 'two bytes at once'
-      *((unsigned short*)(_fbp + pix_offset)) = c;
+    case 2:
+      if (dst_step == 2 && src_step == 2) { swap_copy<2>(dst, src, len, 2, 2); }
+      else                                { swap_copy<2>(dst, src, len, dst_step, src_step); }
+      break;
+
+    case 3:
+      if (dst_step == 3 && src_step == 3) { swap_copy<3>(dst, src, len, 3, 3); }
+      else                                { swap_copy<3>(dst, src, len, dst_step, src_step); }
+      break;
+
+    case 4:
+      if (dst_step == 4 && src_step == 4) { swap_copy<4>(dst, src, len, 4, 4); }
+      else                                { swap_copy<4>(dst, src, len, dst_step, src_step); }
+      break;
+
+    default:
+      swap_copy<1>(dst, src, len, dst_step, src_step);
+      break;
     }
-    // BBBBBBBB GGGGGGGG RRRRRRRR
-    else if (_write_depth = color_depth_t::rgb888_3Byte)
+  }
+
+  void Panel_fb::fb_line_step(uint_fast16_t& x, uint_fast16_t& y, int32_t& step) const
+  {
+    step = _write_bits >> 3;
+    uint_fast8_t r = _internal_rotation;
+    if (r)
     {
-      b = (uint8_t)((rawcolor >> 16) & 0xff);
-      g = (uint8_t)((rawcolor >> 8) & 0xff);
-      r = (uint8_t)((rawcolor >> 0) & 0xff);
-
-      pix_offset = x * 3 + y * _fix_info.line_length;
-      *((char*)(_fbp + pix_offset)) = b;
-      *((char*)(_fbp + pix_offset + 1)) = g;
-      *((char*)(_fbp + pix_offset + 2)) = r;
+      if ((1u << r) & 0b10010110) { y = _height - (y + 1); }
+      if (r & 2)                  { x = _width  - (x + 1); step = -step; }
+      if (r & 1)
+      {
+        std::swap(x, y);
+        step = (step < 0) ? -(int32_t)_fix_info.line_length : (int32_t)_fix_info.line_length;
+      }
     }
   }
 
-  void Panel_fb::fb_draw_argb_pixel(int x, int y, uint32_t rawcolor)
+  void Panel_fb::fb_write_line(uint_fast16_t x, uint_fast16_t y, uint32_t len, const uint8_t* src)
   {
-    unsigned int pix_offset = x * 4 + y * _fix_info.line_length;
-
-    uint8_t r = 0, g = 0, b = 0, a = 0;
-
-    // BBBBBBBB GGGGGGGG RRRRRRRR AAAAAAAA
-    b = (uint8_t)((rawcolor >> 24) & 0xff);
-    g = (uint8_t)((rawcolor >> 16) & 0xff);
-    r = (uint8_t)((rawcolor >> 8) & 0xff);
-    a = (uint8_t)((rawcolor >> 0) & 0xff);
-    
-    *((char*)(_fbp + pix_offset)) = b;
-    *((char*)(_fbp + pix_offset + 1)) = g;
-    *((char*)(_fbp + pix_offset + 2)) = r;
-    *((char*)(_fbp + pix_offset + 3)) = a;
+    int32_t step;
+    fb_line_step(x, y, step);
+    fb_swap_copy(fb_ptr(x, y), src, len, step, _write_bits >> 3);
+
+    if (step == (int32_t)(_write_bits >> 3)) { fb_dirty(x, y, len, 1); }
+    else if (step > 0)                       { fb_dirty(x, y, 1, len); }
+    else if (step == -(int32_t)(_write_bits >> 3)) { fb_dirty(x - (len - 1), y, len, 1); }
+    else                                     { fb_dirty(x, y - (len - 1), 1, len); }
+  }
+
+  void Panel_fb::fb_copy_rect(uint8_t* dst, const uint8_t* src, uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h) const
+  {
+    size_t stride = _fix_info.line_length;
+    size_t offset = x * (_write_bits >> 3) + y * stride;
+    size_t len = w * (_write_bits >> 3);
+    dst += offset;
+    src += offset;
+    do
+    {
+      memcpy(dst, src, len);
+      dst += stride;
+      src += stride;
+    } while (--h);
+  }
+
+  void Panel_fb::fb_read_line(uint_fast16_t x, uint_fast16_t y, uint32_t len, uint8_t* dst) const
+  {
+    int32_t step;
+    fb_line_step(x, y, step);
+    fb_swap_copy(dst, fb_ptr(x, y), len, _write_bits >> 3, step);
   }
 
   Panel_fb::~Panel_fb(void)
   {
+    if (_present_thread.joinable())
+    {
+      {
+        std::lock_guard<std::mutex> lock(_present_mutex);
+        _present_quit = true;
+      }
+      _present_cv.notify_one();
+      _present_thread.join();
+    }
+    if (_present_buffer) { heap_free(_present_buffer); }
+    _present_buffer = nullptr;
+
+    if (_buffer_mode == buffer_page_flip)
+    { // return the console to the first page.
+      _var_info.yoffset = 0;
+      ioctl(_fbfd, FBIOPAN_DISPLAY, &_var_info);
+    }
     // unmap fb file from memory
     munmap(_fbp, _screensize);
     // close fb file    
     close(_fbfd);
 
+    if (_line_buffer) { heap_free(_line_buffer); }
+    _line_buffer = nullptr;
+    if (_shadow_buffer) { heap_free(_shadow_buffer); }
+    _shadow_buffer = nullptr;
+
     memset(&_fix_info, 0, sizeof(_fix_info));
     memset(&_var_info, 0, sizeof(_var_info));
   }
@@ -152,6 +211,12 @@ namespace lgfx
         return false;
     }
 
+    _buffer_mode = buffer_direct;
+    if (_config_detail.double_buffer && !fb_init_page_flip())
+    {
+      _buffer_mode = buffer_shadow;
+    }
+
     // Figure out the size of the screen in bytes
     _screensize = _fix_info.smem_len;  //finfo.line_length * vinfo.yres;    
 
@@ -163,12 +228,188 @@ namespace lgfx
     }
     memset(_fbp, 0, _screensize);
 
+    _draw_fbp = (uint8_t*)_fbp;
+    if (_buffer_mode == buffer_page_flip)
+    {
+      _draw_fbp += _back_page * _var_info.yres * _fix_info.line_length;
+    }
+    else if (_buffer_mode == buffer_shadow)
+    {
+      size_t len = _var_info.yres * _fix_info.line_length;
+      if (_shadow_buffer) { heap_free(_shadow_buffer); }
+      _shadow_buffer = (uint8_t*)heap_alloc_psram(len);
+      if (_shadow_buffer == nullptr) { _shadow_buffer = (uint8_t*)heap_alloc(len); }
+      if (_shadow_buffer == nullptr)
+      {
+        _buffer_mode = buffer_direct;
+      }
+      else
+      {
+        memset(_shadow_buffer, 0, len);
+        _draw_fbp = _shadow_buffer;
+      }
+    }
+
+    if (_buffer_mode == buffer_shadow && _config_detail.present_thread && !_present_thread.joinable())
+    {
+      size_t len = _var_info.yres * _fix_info.line_length;
+      _present_buffer = (uint8_t*)heap_alloc(len);
+      if (_present_buffer)
+      {
+        memset(_present_buffer, 0, len);
+        _present_quit = false;
+        _present_thread = std::thread(&Panel_fb::present_proc, this);
+      }
+    }
+    _frame_pacer.setFrameRate(_config_detail.frame_rate);
+
+    size_t line_len = std::max<size_t>(std::max(_cfg.panel_width, _cfg.panel_height), std::max(_var_info.xres, _var_info.yres));
+    if (_line_buffer) { heap_free(_line_buffer); }
+    _line_buffer = (uint8_t*)heap_alloc(line_len * sizeof(uint32_t));
+    if (_line_buffer == nullptr) {
+        printf("Error: failed to allocate line buffer.\n");
+        return false;
+    }
+
     return Panel_Device::init(use_reset);
   }
 
+  bool Panel_fb::fb_init_page_flip(void)
+  {
+    auto var = _var_info;
+    var.yres_virtual = var.yres * 2;
+    var.yoffset = 0;
+    if (ioctl(_fbfd, FBIOPUT_VSCREENINFO, &var)
+     || ioctl(_fbfd, FBIOGET_VSCREENINFO, &var)
+     || var.yres_virtual < var.yres * 2)
+    {
+      return false;
+    }
+
+    struct fb_fix_screeninfo fix;
+    if (ioctl(_fbfd, FBIOGET_FSCREENINFO, &fix)
+     || fix.ypanstep == 0 || (var.yres % fix.ypanstep)
+     || fix.smem_len < fix.line_length * var.yres * 2)
+    {
+      return false;
+    }
+
+    // some drivers accept the virtual size but cannot pan.
+    var.yoffset = var.yres;
+    if (ioctl(_fbfd, FBIOPAN_DISPLAY, &var)) { return false; }
+    var.yoffset = 0;
+    ioctl(_fbfd, FBIOPAN_DISPLAY, &var);
+
+    _var_info = var;
+    _fix_info = fix;
+    _back_page = 1;
+    _buffer_mode = buffer_page_flip;
+    return true;
+  }
+
   void Panel_fb::display(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h)
   {
-    // Nothings to do
+    if (_buffer_mode == buffer_direct || _dirty_x0 > _dirty_x1) { return; }
+
+    uint32_t wait = _frame_pacer.wait_time(micros());
+    if (wait) { delayMicroseconds(wait); }
+
+    x = _dirty_x0;
+    y = _dirty_y0;
+    w = _dirty_x1 + 1 - x;
+    h = _dirty_y1 + 1 - y;
+    _dirty_x0 = _dirty_y0 = UINT16_MAX;
+    _dirty_x1 = _dirty_y1 = 0;
+
+    if (_present_buffer)
+    { // hand the frame over to the presenter thread.
+      {
+        std::lock_guard<std::mutex> lock(_present_mutex);
+        fb_copy_rect(_present_buffer, _shadow_buffer, x, y, w, h);
+        // the previous frame has not been shown yet; it is replaced by this one.
+        if (_pending_x0 <= _pending_x1) { ++_present_stats.dropped; }
+        if (_pending_x0 > x) { _pending_x0 = x; }
+        if (_pending_y0 > y) { _pending_y0 = y; }
+        if (_pending_x1 < x + w - 1) { _pending_x1 = x + w - 1; }
+        if (_pending_y1 < y + h - 1) { _pending_y1 = y + h - 1; }
+        _pending_usec = micros();
+        ++_present_stats.frames;
+      }
+      _present_cv.notify_one();
+      return;
+    }
+
+    uint32_t usec = micros();
+    uint32_t crtc = 0;
+    if (_buffer_mode == buffer_shadow)
+    { // copy during the blanking.
+      if (_config_detail.wait_vsync) { ioctl(_fbfd, FBIO_WAITFORVSYNC, &crtc); }
+      fb_copy_rect((uint8_t*)_fbp, _shadow_buffer, x, y, w, h);
+    }
+    else
+    { // the pan takes effect at the next vsync, and the old page is scanned out until then.
+      _var_info.yoffset = _back_page * _var_info.yres;
+      ioctl(_fbfd, FBIOPAN_DISPLAY, &_var_info);
+      if (_config_detail.wait_vsync) { ioctl(_fbfd, FBIO_WAITFORVSYNC, &crtc); }
+
+      auto front = _draw_fbp;
+      _back_page ^= 1;
+      _draw_fbp = (uint8_t*)_fbp + _back_page * _var_info.yres * _fix_info.line_length;
+      // the new back page still holds the frame before; bring the area drawn in this frame up to date.
+      fb_copy_rect(_draw_fbp, front, x, y, w, h);
+    }
+
+    ++_present_stats.frames;
+    _present_stats.addLatency(micros() - usec);
+    update_present_rate();
+  }
+
+  void Panel_fb::present_proc(void)
+  {
+    std::unique_lock<std::mutex> lock(_present_mutex);
+    for (;;)
+    {
+      _present_cv.wait(lock, [this] { return _present_quit || _pending_x0 <= _pending_x1; });
+      if (_present_quit) { return; }
+
+      if (_config_detail.wait_vsync)
+      { // display() may hand over a newer frame while waiting.
+        lock.unlock();
+        uint32_t crtc = 0;
+        ioctl(_fbfd, FBIO_WAITFORVSYNC, &crtc);
+        lock.lock();
+      }
+
+      uint_fast16_t x = _pending_x0;
+      uint_fast16_t y = _pending_y0;
+      uint_fast16_t w = _pending_x1 + 1 - x;
+      uint_fast16_t h = _pending_y1 + 1 - y;
+      _pending_x0 = _pending_y0 = UINT16_MAX;
+      _pending_x1 = _pending_y1 = 0;
+
+      fb_copy_rect((uint8_t*)_fbp, _present_buffer, x, y, w, h);
+      _present_stats.addLatency(micros() - _pending_usec);
+      update_present_rate();
+    }
+  }
+
+  void Panel_fb::update_present_rate(void)
+  {
+    ++_present_count;
+    uint32_t msec = millis();
+    uint32_t elapsed = msec - _present_msec;
+    if (elapsed >= 1000)
+    {
+      _present_rate = (_present_count - _present_count_prev) * 1000.0f / elapsed;
+      _present_count_prev = _present_count;
+      _present_msec = msec;
+    }
+  }
+
+  present_stats_t Panel_fb::getPresentStats(void)
+  {
+    std::lock_guard<std::mutex> lock(_present_mutex);
+    return _present_stats;
   }
 
   color_depth_t Panel_fb::setColorDepth(color_depth_t depth)
@@ -212,64 +453,54 @@ namespace lgfx
 
   void Panel_fb::drawPixelPreclipped(uint_fast16_t x, uint_fast16_t y, uint32_t rawcolor)
   {
-    uint_fast8_t rotation = _internal_rotation;
-    if (rotation)
-    {
-      if ((1u << rotation) & 0b10010110) { y = _height - (y + 1); }
-      if (rotation & 2)                  { x = _width  - (x + 1); }
-      if (rotation & 1) { std::swap(x, y); }
-    }
-
-    switch (_write_depth)
-    {
-      case color_depth_t::rgb565_2Byte:
-      case color_depth_t::rgb888_3Byte:
-        fb_draw_rgb_pixel(x, y, rawcolor);
-        break;
-      case color_depth_t::argb8888_4Byte:
-        fb_draw_argb_pixel(x, y, rawcolor);
-        break;
-      default:
-        break;
-    }
-
-    if (!getStartCount())
-    {
-      display(x, y, 1, 1);
-    }
+    int32_t step;
+    fb_line_step(x, y, step);
+    fb_swap_copy(fb_ptr(x, y), (const uint8_t*)&rawcolor, 1, 0, 0);
+    fb_dirty(x, y, 1, 1);
   }
 
   void Panel_fb::writeFillRectPreclipped(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t rawcolor)
   {
-    uint_fast8_t rotation = _internal_rotation;
-    if (rotation)
+    uint_fast8_t r = _internal_rotation;
+    if (r)
     {
-      if ((1u << rotation) & 0b10010110) { y = _height - (y + 1); }
-      if (rotation & 2)                  { x = _width  - (x + 1); }
-      if (rotation & 1) { std::swap(x, y); }
+      if ((1u << r) & 0b10010110) { y = _height - (y + h); }
+      if (r & 2)                  { x = _width  - (x + w); }
+      if (r & 1) { std::swap(x, y);  std::swap(w, h); }
     }
+    fb_dirty(x, y, w, h);
 
-    for (size_t width = 0; width < w; width++)
-    {
-      for (size_t height = 0; height < h; height++)
+    size_t bytes = _write_bits >> 3;
+    size_t len = w * bytes;
+    size_t stride = _fix_info.line_length;
+    auto dst = fb_ptr(x, y);
+
+    uint8_t color[4];
+    fb_swap_copy(color, (const uint8_t*)&rawcolor, 1, 0, 0);
+    size_t i = 1;
+    while (i < bytes && color[i] == color[0]) { ++i; }
+    if (i == bytes)
+    { // black, white, etc.
+      do
       {
-        uint_fast16_t x_pos = x + width;
-        uint_fast16_t y_pos = y + height;
+        memset(dst, color[0], len);
+        dst += stride;
+      } while (--h);
+      return;
+    }
 
-        switch (_write_depth)
-        {
-          case color_depth_t::rgb565_2Byte:
-          case color_depth_t::rgb888_3Byte:
-            fb_draw_rgb_pixel(x_pos, y_pos, rawcolor);
-            break;
-          case color_depth_t::argb8888_4Byte:
-            fb_draw_argb_pixel(x_pos, y_pos, rawcolor);
-            break;
-          default:
-            break;
-        }
-      }
+    // build a single row in system memory and copy it to each line, because reading back from the framebuffer is slow.
+    auto buf = _line_buffer;
+    memcpy(buf, color, bytes);
+    for (i = bytes; i < len; i <<= 1)
+    {
+      memcpy(&buf[i], buf, std::min(i, len - i));
     }
+    do
+    {
+      memcpy(dst, buf, len);
+      dst += stride;
+    } while (--h);
   }
 
   void Panel_fb::writeBlock(uint32_t rawcolor, uint32_t length)
@@ -290,226 +521,113 @@ namespace lgfx
     } while (length);
   }
 
-  void Panel_fb::_rotate_pixelcopy(uint_fast16_t& x, uint_fast16_t& y, uint_fast16_t& w, uint_fast16_t& h, pixelcopy_t* param, uint32_t& nextx, uint32_t& nexty)
-  {
-    // NOT TEST
-    uint32_t addx = param->src_x32_add;
-    uint32_t addy = param->src_y32_add;
-    uint_fast8_t r = _internal_rotation;
-    uint_fast8_t bitr = 1u << r;
-    if (bitr & 0b10010110) // case 1:2:4:7:
-    {
-      param->src_y32 += nexty * (h - 1);
-      nexty = -(int32_t)nexty;
-      y = _height - (y + h);
-    }
-    if (r & 2)
-    {
-      param->src_x32 += addx * (w - 1);
-      param->src_y32 += addy * (w - 1);
-      addx = -(int32_t)addx;
-      addy = -(int32_t)addy;
-      x = _width  - (x + w);
-    }
-    if (r & 1)
-    {
-      std::swap(x, y);
-      std::swap(w, h);
-      std::swap(nextx, addx);
-      std::swap(nexty, addy);
-    }
-    param->src_x32_add = addx;
-    param->src_y32_add = addy;
-  }
-
-  void Panel_fb::writePixels(pixelcopy_t* param, uint32_t length, bool use_dma)
+  void Panel_fb::writePixels(pixelcopy_t* param, uint32_t length, bool)
   {
-    // NOT TEST
     uint_fast16_t xs = _xs;
     uint_fast16_t xe = _xe;
     uint_fast16_t ys = _ys;
     uint_fast16_t ye = _ye;
     uint_fast16_t x = _xpos;
     uint_fast16_t y = _ypos;
-    const size_t bits = _write_bits;
-    auto k = _cfg.panel_width * bits >> 3;
+    auto buf = _line_buffer;
 
-    uint_fast8_t r = _internal_rotation;
-    if (!r)
-    {
-      uint_fast16_t linelength;
-      do {
-        linelength = std::min<uint_fast16_t>(xe - x + 1, length);
-        param->fp_copy(&_fbp[y * k], x, x + linelength, param);
-        if ((x += linelength) > xe)
-        {
-          x = xs;
-          y = (y != ye) ? (y + 1) : ys;
-        }
-      } while (length -= linelength);
-      _xpos = x;
-      _ypos = y;
-      return;
-    }
-
-    int_fast16_t ax = 1;
-    int_fast16_t ay = 1;
-    if ((1u << r) & 0b10010110) { y = _height - (y + 1); ys = _height - (ys + 1); ye = _height - (ye + 1); ay = -1; }
-    if (r & 2)                  { x = _width  - (x + 1); xs = _width  - (xs + 1); xe = _width  - (xe + 1); ax = -1; }
-    if (param->no_convert)
-    {
-      size_t bytes = bits >> 3;
-      size_t xw = 1;
-      size_t yw = _cfg.panel_width;
-      if (r & 1) std::swap(xw, yw);
-      size_t idx = y * yw + x * xw;
-      auto data = (uint8_t*)param->src_data;
-      do
-      {
-        auto dst = &_fbp[idx * bytes];
-        size_t b = 0;
-        do
-        {
-          dst[b] = *data++;
-        } while (++b < bytes);
-        if (x != xe)
-        {
-          idx += xw * ax;
-          x += ax;
-        }
-        else
-        {
-          x = xs;
-          y = (y != ye) ? (y + ay) : ys;
-          idx = y * yw + x * xw;
-        }
-      } while (--length);
-    }
-    else
+    uint32_t linelength;
+    do
     {
-      if (r & 1)
+      linelength = std::min<uint32_t>(xe - x + 1, length);
+      param->fp_copy(buf, 0, linelength, param);
+      fb_write_line(x, y, linelength, buf);
+      if ((x += linelength) > xe)
       {
-        do
-        {
-          param->fp_copy(&_fbp[x * k], y, y + 1, param);
-          if (x != xe)
-          {
-            x += ax;
-          }
-          else
-          {
-            x = xs;
-            y = (y != ye) ? (y + ay) : ys;
-          }
-        } while (--length);
+        x = xs;
+        y = (y != ye) ? (y + 1) : ys;
       }
-      else
-      {
-        do
-        {
-          param->fp_copy(&_fbp[y * k], x, x + 1, param);
-          if (x != xe)
-          {
-            x += ax;
-          }
-          else
-          {
-            x = xs;
-            y = (y != ye) ? (y + ay) : ys;
-          }
-        } while (--length);
-      }
-    }
-    if ((1u << r) & 0b10010110) { y = _height - (y + 1); }
-    if (r & 2)                  { x = _width  - (x + 1); }
+    } while (length -= linelength);
     _xpos = x;
     _ypos = y;
   }
 
   void Panel_fb::writeImage(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param, bool)
   {
-    // NOT TEST
-    uint_fast8_t r = _internal_rotation;
-    if (r == 0 && param->transp == pixelcopy_t::NON_TRANSP && param->no_convert)
+    size_t bytes = _write_bits >> 3;
+    if (param->transp == pixelcopy_t::NON_TRANSP && param->no_convert)
     {
-      auto sx = param->src_x;
-      auto bits = param->src_bits;
-
-      auto bw = _cfg.panel_width * bits >> 3;
-      auto dst = &_fbp[bw * y];
-      auto sw = param->src_bitwidth * bits >> 3;
-      auto src = &((uint8_t*)param->src_data)[param->src_y * sw];
-      if (sw == bw && this->_cfg.panel_width == w && sx == 0 && x == 0)
-      {
-        memcpy(dst, src, bw * h);
-        return;
-      }
-      y = 0;
-      dst +=  x * bits >> 3;
-      src += sx * bits >> 3;
-      w    =  w * bits >> 3;
+      size_t sw = param->src_bitwidth * bytes;
+      auto src = &((const uint8_t*)param->src_data)[param->src_y * sw + param->src_x * bytes];
       do
       {
-        memcpy(&dst[y * bw], &src[y * sw], w);
-      } while (++y != h);
+        fb_write_line(x, y++, w, src);
+        src += sw;
+      } while (--h);
       return;
     }
 
-    uint32_t nextx = 0;
-    uint32_t nexty = 1 << pixelcopy_t::FP_SCALE;
-    if (r)
-    {
-      _rotate_pixelcopy(x, y, w, h, param, nextx, nexty);
-    }
     uint32_t sx32 = param->src_x32;
     uint32_t sy32 = param->src_y32;
-
-    y *= _cfg.panel_width;
+    auto buf = _line_buffer;
     do
     {
-      int32_t pos = x + y;
-      int32_t end = pos + w;
-      while (end != (pos = param->fp_copy(_fbp, pos, end, param))
-         &&  end != (pos = param->fp_skip(      pos, end, param)));
-      param->src_x32 = (sx32 += nextx);
-      param->src_y32 = (sy32 += nexty);
-      y += _cfg.panel_width;
+      uint32_t pos = 0;
+      do
+      {
+        uint32_t start = pos;
+        pos = param->fp_copy(buf, pos, w, param);
+        if (pos != start)
+        {
+          fb_write_line(x + start, y, pos - start, &buf[start * bytes]);
+        }
+      } while (w != pos && w != (pos = param->fp_skip(pos, w, param)));
+      param->src_x32 = sx32;
+      param->src_y32 = (sy32 += 1 << pixelcopy_t::FP_SCALE);
+      ++y;
     } while (--h);
   }
 
   void Panel_fb::writeImageARGB(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param)
   {
-    // NOT TEST
-    uint32_t nextx = 0;
-    uint32_t nexty = 1 << pixelcopy_t::FP_SCALE;
-    if (_internal_rotation)
-    {
-      _rotate_pixelcopy(x, y, w, h, param, nextx, nexty);
-    }
     uint32_t sx32 = param->src_x32;
     uint32_t sy32 = param->src_y32;
-
-    uint32_t pos = x + y * _cfg.panel_width;
-    uint32_t end = pos + w;
-    param->fp_copy(_fbp, pos, end, param);
-    while (--h)
+    auto buf = _line_buffer;
+    do
     {
-      pos += _cfg.panel_width;
-      end = pos + w;
-      param->src_x32 = (sx32 += nextx);
-      param->src_y32 = (sy32 += nexty);
-      param->fp_copy(_fbp, pos, end, param);
-    }
+      fb_read_line(x, y, w, buf);
+      param->fp_copy(buf, 0, w, param);
+      fb_write_line(x, y, w, buf);
+      param->src_x32 = sx32;
+      param->src_y32 = (sy32 += 1 << pixelcopy_t::FP_SCALE);
+      ++y;
+    } while (--h);
   }
 
   void Panel_fb::readRect(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, void* dst, pixelcopy_t* param)
   {
-    // TODO
+    auto d = (uint8_t*)dst;
+    if (param->no_convert)
+    {
+      size_t len = w * (_write_bits >> 3);
+      do
+      {
+        fb_read_line(x, y++, w, d);
+        d += len;
+      } while (--h);
+      return;
+    }
+
+    auto buf = _line_buffer;
+    uint32_t pos = 0;
+    do
+    {
+      fb_read_line(x, y++, w, buf);
+      param->src_data = buf;
+      param->src_x32 = 0;
+      param->src_y32 = 0;
+      param->fp_copy(d, pos, pos + w, param);
+      pos += w;
+    } while (--h);
   }
 
   void Panel_fb::copyRect(uint_fast16_t dst_x, uint_fast16_t dst_y, uint_fast16_t w, uint_fast16_t h, uint_fast16_t src_x, uint_fast16_t src_y)
   {
-
     uint_fast8_t r = _internal_rotation;
     if (r)
     {
@@ -520,11 +638,18 @@ namespace lgfx
 
     if ((dst_x + w) > _var_info.xres) w = _var_info.xres - dst_x;
     if ((dst_y + h) > _var_info.yres) h = _var_info.yres - dst_y;
+    fb_dirty(dst_x, dst_y, w, h);
     size_t bytes = _write_bits >> 3;
     size_t len = w * bytes;
-    int32_t add = _var_info.xres * bytes;  // _cfg.panel_width may not was the screen width, use _var_info.xres instead.
-    char *src = (_fbp + (src_x * bytes + src_y * _fix_info.line_length));
-    char *dst = (_fbp + (dst_x * bytes + dst_y * _fix_info.line_length));
+    int32_t add = _fix_info.line_length;
+    int32_t pos = 0;
+    if (src_y < dst_y)
+    { // copy from the bottom line so that overlapping areas are not overwritten.
+      pos = h - 1;
+      add = -add;
+    }
+    auto src = fb_ptr(src_x, src_y + pos);
+    auto dst = fb_ptr(dst_x, dst_y + pos);
 
     do
     {
@@ -22,6 +22,7 @@ Porting for Linux FrameBuffer:
 
 #include "../../panel/Panel_Device.hpp"
 #include "../../misc/range.hpp"
+#include "../../misc/present_stats.hpp"
 #include "../../Touch.hpp"
 
 #include <unistd.h>
@@ -30,6 +31,10 @@ Porting for Linux FrameBuffer:
 #include <sys/mman.h>
 #include <sys/ioctl.h>
 
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
 namespace lgfx
 {
  inline namespace v1
@@ -47,6 +52,27 @@ namespace lgfx
     {
       // 操作対象とするフレームバッファのパス名、または、デバイス名称 ("st7789") 等の文字列へのポインタを指定する。
       const char* device_name = "/dev/fb0";
+
+      // 描画をバックバッファに対して行い、display() の呼出しで表示に反映する。
+      // ドライバがパンニングに対応していれば仮想画面を2画面分確保してページを切り替え、非対応の場合はシャドウバッファの変更範囲をコピーする。
+      bool double_buffer = false;
+
+      // FBIO_WAITFORVSYNC で垂直同期を待つ。ページ切替では切替の後、古いページを描画に戻す前に待つ。
+      bool wait_vsync = true;
+
+      // シャドウバッファ使用時、display() は変更範囲を表示待ちバッファへ複写して戻り、垂直同期待ちとフレームバッファへの転送は別スレッドで行う。
+      // With the shadow buffer, display() only copies the modified area and returns; a presenter thread waits for vsync and writes the framebuffer.
+      bool present_thread = false;
+
+      // display() の呼出しをこのフレームレートに制限する。0 = 制限なし
+      uint16_t frame_rate = 0;
+    };
+
+    enum buffer_mode_t
+    {
+      buffer_direct,    // draw into the visible framebuffer.
+      buffer_page_flip, // draw into the hidden page, display() pans to it.
+      buffer_shadow,    // draw into system memory, display() copies the modified area.
     };
 
     bool init(bool use_reset) override;
@@ -78,11 +104,20 @@ namespace lgfx
 
     uint_fast8_t getTouchRaw(touch_point_t* tp, uint_fast8_t count) override;
 
+    buffer_mode_t getBufferMode(void) const { return _buffer_mode; }
+
+    /// number of frames presented by display() per second, updated every second.
+    float getPresentRate(void) const { return _present_rate; }
+    uint32_t getPresentCount(void) const { return _present_count; }
+
+    /// frame count, dropped frames and latency of the presenter thread.
+    present_stats_t getPresentStats(void);
+
     // init前に使用し、操作対象とするフレームバッファのパス名、または、デバイス名称 ("st7789") 等の文字列へのポインタを指定する。
     void setDeviceName(const char* device_name) { _config_detail.device_name = device_name; };
 
     const config_detail_t& config_detail(void) const { return _config_detail; }
-    void config_detail(const config_detail_t& config_detail);
+    void config_detail(const config_detail_t& config_detail) { _config_detail = config_detail; }
 
   protected:
 
@@ -99,11 +134,62 @@ namespace lgfx
     int32_t _xpos = 0;
     int32_t _ypos = 0;
 
-    void _rotate_pixelcopy(uint_fast16_t& x, uint_fast16_t& y, uint_fast16_t& w, uint_fast16_t& h, pixelcopy_t* param, uint32_t& nextx, uint32_t& nexty);
-
-  private:
-    void fb_draw_rgb_pixel(int x, int y, uint32_t rawcolor);
-    void fb_draw_argb_pixel(int x, int y, uint32_t rawcolor);
+    buffer_mode_t _buffer_mode = buffer_direct;
+    uint8_t* _draw_fbp = nullptr;  // drawing target (visible framebuffer, back page or shadow buffer)
+    uint8_t* _shadow_buffer = nullptr;
+    uint_fast8_t _back_page = 0;
+
+    // modified area of the drawing target since the last display(), in framebuffer coordinates.
+    uint_fast16_t _dirty_x0 = UINT16_MAX;
+    uint_fast16_t _dirty_y0 = UINT16_MAX;
+    uint_fast16_t _dirty_x1 = 0;
+    uint_fast16_t _dirty_y1 = 0;
+
+    uint32_t _present_count = 0;
+    uint32_t _present_count_prev = 0;
+    uint32_t _present_msec = 0;
+    float _present_rate = 0.0f;
+
+    // one line of pixels in the LGFX raw format, used to convert rows from/to the framebuffer.
+    uint8_t* _line_buffer = nullptr;
+
+    // presenter thread. _present_buffer holds the frames handed over by display(), guarded by _present_mutex.
+    std::thread _present_thread;
+    std::mutex _present_mutex;
+    std::condition_variable _present_cv;
+    uint8_t* _present_buffer = nullptr;
+    uint_fast16_t _pending_x0 = UINT16_MAX;
+    uint_fast16_t _pending_y0 = UINT16_MAX;
+    uint_fast16_t _pending_x1 = 0;
+    uint_fast16_t _pending_y1 = 0;
+    uint32_t _pending_usec = 0;
+    bool _present_quit = false;
+    present_stats_t _present_stats = {};
+    frame_pacer_t _frame_pacer;
+
+    void present_proc(void);
+    void update_present_rate(void);
+
+    uint8_t* fb_ptr(uint_fast16_t x, uint_fast16_t y) const { return &_draw_fbp[x * (_write_bits >> 3) + y * _fix_info.line_length]; }
+
+    void fb_dirty(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h)
+    {
+      if (_dirty_x0 > x) { _dirty_x0 = x; }
+      if (_dirty_y0 > y) { _dirty_y0 = y; }
+      if (_dirty_x1 < x + w - 1) { _dirty_x1 = x + w - 1; }
+      if (_dirty_y1 < y + h - 1) { _dirty_y1 = y + h - 1; }
+    }
+
+    bool fb_init_page_flip(void);
+    void fb_copy_rect(uint8_t* dst, const uint8_t* src, uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h) const;
+
+    // The framebuffer holds the pixels in the reverse byte order of the LGFX raw format. (swap565 / bgr888 / bgra8888)
+    void fb_swap_copy(uint8_t* dst, const uint8_t* src, uint32_t len, int32_t dst_step, int32_t src_step) const;
+
+    // Copy len pixels of the logical line starting at (x, y), in the direction of rotation.
+    void fb_write_line(uint_fast16_t x, uint_fast16_t y, uint32_t len, const uint8_t* src);
+    void fb_read_line(uint_fast16_t x, uint_fast16_t y, uint32_t len, uint8_t* dst) const;
+    void fb_line_step(uint_fast16_t& x, uint_fast16_t& y, int32_t& step) const;
   };
 
 //----------------------------------------------------------------------------
@@ -108,9 +108,29 @@ namespace lgfx
         cv::namedWindow(info.window_name, cv::WINDOW_AUTOSIZE);
         cv::setMouseCallback(info.window_name, cv_mouse_callback, &(info.panel->_touch_point));
       }
-      cv::cvtColor(*(info.cvmat), mat, cv::COLOR_BGR2RGB);
+      auto panel = info.panel;
+      if (!panel->_double_buffer)
+      {
+        cv::cvtColor(*(info.cvmat), mat, cv::COLOR_BGR2RGB);
+        cv::imshow(info.window_name, mat);
+        mat.release();
+        continue;
+      }
+
+      uint32_t usec;
+      {
+        std::lock_guard<std::mutex> lock(panel->_present_mutex);
+        if (!panel->_present_pending) continue;  // nothing new; the window keeps the last frame.
+        panel->_present_pending = false;
+        usec = panel->_pending_usec;
+        cv::cvtColor(panel->_front_mat, mat, cv::COLOR_BGR2RGB);
+      }
       cv::imshow(info.window_name, mat);
       mat.release();
+      {
+        std::lock_guard<std::mutex> lock(panel->_present_mutex);
+        panel->_present_stats.addLatency(micros() - usec);
+      }
     }
     cv::waitKey(10);
   }
@@ -143,6 +163,20 @@ namespace lgfx
 
   void Panel_OpenCV::display(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h)
   {
+    if (_double_buffer)
+    {
+      uint32_t wait = _frame_pacer.wait_time(micros());
+      if (wait) { delayMicroseconds(wait); }
+
+      std::lock_guard<std::mutex> lock(_present_mutex);
+      // the previous frame has not been shown yet; it is replaced by this one.
+      if (_present_pending) { ++_present_stats.dropped; }
+      _cv_mat.copyTo(_front_mat);
+      _present_pending = true;
+      _pending_usec = micros();
+      ++_present_stats.frames;
+      return;
+    }
 //    cv::imshow(_window_name, _cv_mat);
 //    cv::pollKey();
   }
@@ -160,6 +194,12 @@ namespace lgfx
 
   void Panel_OpenCV::endTransaction(void) {}
 
+  present_stats_t Panel_OpenCV::getPresentStats(void)
+  {
+    std::lock_guard<std::mutex> lock(_present_mutex);
+    return _present_stats;
+  }
+
   void Panel_OpenCV::setRotation(uint_fast8_t r)
   {
     r &= 7;
@@ -202,7 +242,7 @@ namespace lgfx
       *img = rawcolor;
     }
 
-    if (!getStartCount())
+    if (!getStartCount() && !_double_buffer)
     {
       display(x, y, 1, 1);
     }
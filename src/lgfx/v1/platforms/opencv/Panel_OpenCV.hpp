@@ -19,9 +19,11 @@ Contributors:
 
 #include "../../panel/Panel_Device.hpp"
 #include "../../misc/range.hpp"
+#include "../../misc/present_stats.hpp"
 #include "../../Touch.hpp"
 
 #include <opencv2/opencv.hpp>
+#include <mutex>
 
 namespace lgfx
 {
@@ -67,6 +69,19 @@ namespace lgfx
 
     uint_fast8_t getTouchRaw(touch_point_t* tp, uint_fast8_t count) override;
 
+    /// display() で描画内容を表示用の画像へ複写し、imshowall はその画像だけを表示する。;
+    /// display() copies the drawing to a front image and imshowall shows only that image,
+    /// so imshowall never shows a half drawn frame and drawing the next frame overlaps the presentation.
+    void setDoubleBuffer(bool enable) { _double_buffer = enable; }
+    bool getDoubleBuffer(void) const { return _double_buffer; }
+
+    /// display() の呼出しをこのフレームレートに制限する。0 = 制限なし;
+    /// Holds display() to this frame rate. 0 = not limited.
+    void setFrameRate(uint32_t fps) { _frame_pacer.setFrameRate(fps); }
+
+    /// frame count, dropped frames and latency from display() to imshow. (double buffer only)
+    present_stats_t getPresentStats(void);
+
   protected:
     char _window_name[32];
     touch_point_t _touch_point;
@@ -75,6 +90,15 @@ namespace lgfx
     int32_t _xpos = 0;
     int32_t _ypos = 0;
 
+    // double buffer: _front_mat holds the frame handed over by display(), guarded by _present_mutex.
+    bool _double_buffer = false;
+    bool _present_pending = false;
+    cv::Mat _front_mat;
+    std::mutex _present_mutex;
+    uint32_t _pending_usec = 0;
+    present_stats_t _present_stats = {};
+    frame_pacer_t _frame_pacer;
+
     void _rotate_pixelcopy(uint_fast16_t& x, uint_fast16_t& y, uint_fast16_t& w, uint_fast16_t& h, pixelcopy_t* param, uint32_t& nextx, uint32_t& nexty);
   };
 
@@ -338,6 +338,21 @@ namespace lgfx
     monitor.frame_angle = (monitor.frame_rotation) * 90;
   }
 
+  void Panel_sdl::setDoubleBuffer(bool enable)
+  {
+    if (_double_buffer == enable) return;
+    _double_buffer = enable;
+    if (enable)
+    { // frames are shown by display(), the previous setting comes back when disabled.
+      _auto_display_saved = _auto_display;
+      _auto_display = false;
+    }
+    else
+    {
+      _auto_display = _auto_display_saved;
+    }
+  }
+
   Panel_sdl::~Panel_sdl(void)
   {
     _list_monitor.remove(&monitor);
@@ -375,18 +390,43 @@ namespace lgfx
     }
     _write_depth = depth;
     _read_depth = depth;
+    mark_dirty_all();
 
     return depth;
   }
 
+  void Panel_sdl::mark_dirty(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h)
+  {
+    auto tiles = _double_buffer ? _back_tiles : _dirty_tiles;
+    if (tiles == nullptr || !w || !h) return;
+    uint_fast8_t r = _internal_rotation;
+    if (r)
+    {
+      if ((1u << r) & 0b10010110) { y = _height - (y + h); }
+      if (r & 2)                  { x = _width  - (x + w); }
+      if (r & 1) { std::swap(x, y);  std::swap(w, h); }
+    }
+    uint_fast16_t tx = x >> dirty_tile_shift;
+    uint_fast16_t tw = ((x + w - 1) >> dirty_tile_shift) - tx + 1;
+    uint_fast16_t ty = y >> dirty_tile_shift;
+    uint_fast16_t ye = (y + h - 1) >> dirty_tile_shift;
+    do
+    {
+      memset(&tiles[ty * _dirty_cols + tx], 1, tw);
+    } while (++ty <= ye);
+  }
+
   Panel_sdl::lock_t::lock_t(Panel_sdl* parent)
   : _parent { parent }
   {
+    // with the double buffer, the drawing thread owns the back buffer. display() hands it over.
+    if (parent->_double_buffer) return;
     SDL_LockMutex(parent->_sdl_mutex);
   };
 
   Panel_sdl::lock_t::~lock_t(void)
   {
+    if (_parent->_double_buffer) return;
     ++_parent->_modified_counter;
     SDL_UnlockMutex(_parent->_sdl_mutex);
     if (SDL_SemValue(_update_in_semaphore) < 2)
@@ -402,12 +442,21 @@ namespace lgfx
   {
     lock_t lock(this);
     Panel_FrameBufferBase::drawPixelPreclipped(x, y, rawcolor);
+    mark_dirty(x, y, 1, 1);
   }
 
   void Panel_sdl::writeFillRectPreclipped(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t rawcolor)
   {
     lock_t lock(this);
     Panel_FrameBufferBase::writeFillRectPreclipped(x, y, w, h, rawcolor);
+    mark_dirty(x, y, w, h);
+  }
+
+  void Panel_sdl::writeFillRectAlphaPreclipped(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t argb8888)
+  {
+    lock_t lock(this);
+    Panel_FrameBufferBase::writeFillRectAlphaPreclipped(x, y, w, h, argb8888);
+    mark_dirty(x, y, w, h);
   }
 
   void Panel_sdl::writeBlock(uint32_t rawcolor, uint32_t length)
@@ -420,18 +469,34 @@ namespace lgfx
   {
     lock_t lock(this);
     Panel_FrameBufferBase::writeImage(x, y, w, h, param, use_dma);
+    mark_dirty(x, y, w, h);
   }
 
   void Panel_sdl::writeImageARGB(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param)
   {
     lock_t lock(this);
     Panel_FrameBufferBase::writeImageARGB(x, y, w, h, param);
+    mark_dirty(x, y, w, h);
   }
 
   void Panel_sdl::writePixels(pixelcopy_t* param, uint32_t len, bool use_dma)
   {
     lock_t lock(this);
     Panel_FrameBufferBase::writePixels(param, len, use_dma);
+    mark_dirty(_xs, _ys, _xe - _xs + 1, _ye - _ys + 1);
+  }
+
+  void Panel_sdl::copyRect(uint_fast16_t dst_x, uint_fast16_t dst_y, uint_fast16_t w, uint_fast16_t h, uint_fast16_t src_x, uint_fast16_t src_y)
+  {
+    lock_t lock(this);
+    Panel_FrameBufferBase::copyRect(dst_x, dst_y, w, h, src_x, src_y);
+    mark_dirty(dst_x, dst_y, w, h);
+  }
+
+  void Panel_sdl::commitFrameBuffer(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h)
+  {
+    lock_t lock(this);
+    mark_dirty(x, y, w, h);
   }
 
   void Panel_sdl::display(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h)
@@ -440,6 +505,11 @@ namespace lgfx
     (void)y;
     (void)w;
     (void)h;
+    if (_double_buffer)
+    {
+      present_back_buffer();
+      return;
+    }
     if (_in_step_exec)
     {
       if (_display_counter != _modified_counter) {
@@ -452,6 +522,60 @@ namespace lgfx
     }
   }
 
+  void Panel_sdl::present_back_buffer(void)
+  {
+    if (_back_tiles == nullptr) return;
+
+    uint32_t wait = _frame_pacer.wait_time(micros());
+    if (wait) { delayMicroseconds(wait); }
+
+    size_t bytes = _write_bits >> 3;
+    bool modified = false;
+    SDL_LockMutex(_sdl_mutex);
+    for (size_t ty = 0; ty < _dirty_rows; ++ty)
+    {
+      int ys = ty << dirty_tile_shift;
+      int ye = std::min<int>(ys + (1 << dirty_tile_shift), _cfg.panel_height);
+      auto row = &_back_tiles[ty * _dirty_cols];
+      for (size_t tx = 0; tx < _dirty_cols; ++tx)
+      {
+        if (!row[tx]) continue;
+        size_t xs = tx << dirty_tile_shift;
+        row[tx] = 0;
+        _dirty_tiles[ty * _dirty_cols + tx] = 1;
+        while (tx + 1 < _dirty_cols && row[tx + 1]) { ++tx; row[tx] = 0; _dirty_tiles[ty * _dirty_cols + tx] = 1; }
+        size_t xe = std::min<size_t>((tx + 1) << dirty_tile_shift, _cfg.panel_width);
+        for (int y = ys; y < ye; ++y)
+        {
+          memcpy(&_front_buffer[y * _line_stride + xs * bytes], &_lines_buffer[y][xs * bytes], (xe - xs) * bytes);
+        }
+        modified = true;
+      }
+    }
+    if (modified)
+    {
+      // the previous frame has not been taken by sdl_update yet; it is replaced by this one.
+      if (_texupdate_counter != _modified_counter) { ++_present_stats.dropped; }
+      ++_modified_counter;
+      ++_present_stats.frames;
+      _pending_usec = micros();
+    }
+    SDL_UnlockMutex(_sdl_mutex);
+
+    if (modified && SDL_SemValue(_update_in_semaphore) < 2)
+    {
+      SDL_SemPost(_update_in_semaphore);
+    }
+  }
+
+  present_stats_t Panel_sdl::getPresentStats(void)
+  {
+    SDL_LockMutex(_sdl_mutex);
+    auto stats = _present_stats;
+    SDL_UnlockMutex(_sdl_mutex);
+    return stats;
+  }
+
   uint_fast8_t Panel_sdl::getTouchRaw(touch_point_t* tp, uint_fast8_t count)
   {
     (void)count;
@@ -542,6 +666,8 @@ namespace lgfx
     }
 
     bool step_exec = _in_step_exec;
+    bool new_frame = false;
+    uint32_t frame_usec = 0;
 
     if (_texupdate_counter != _modified_counter) {
       pixelcopy_t pc(nullptr, color_depth_t::rgb888_3Byte, _write_depth, false);
@@ -555,17 +681,52 @@ namespace lgfx
         pc.fp_copy = pixelcopy_t::copy_rgb_fast<bgr888_t, grayscale_t>;
       }
 
+      size_t tiles = _dirty_cols * _dirty_rows;
+      auto dirty = (uint8_t*)alloca(tiles);
       if (0 == SDL_LockMutex(_sdl_mutex))
       {
         _texupdate_counter = _modified_counter;
-        for (int y = 0; y < _cfg.panel_height; ++y)
+        new_frame = _double_buffer;
+        frame_usec = _pending_usec;
+        memcpy(dirty, _dirty_tiles, tiles);
+        memset(_dirty_tiles, 0, tiles);
+        for (size_t ty = 0; ty < _dirty_rows; ++ty)
         {
-          pc.src_x32 = 0;
-          pc.src_data = _lines_buffer[y];
-          pc.fp_copy(&_texturebuf[y * _cfg.panel_width], 0, _cfg.panel_width, &pc);
+          int ys = ty << dirty_tile_shift;
+          int ye = std::min<int>(ys + (1 << dirty_tile_shift), _cfg.panel_height);
+          auto row = &dirty[ty * _dirty_cols];
+          for (size_t tx = 0; tx < _dirty_cols; ++tx)
+          {
+            if (!row[tx]) continue;
+            int xs = tx << dirty_tile_shift;
+            while (tx + 1 < _dirty_cols && row[tx + 1]) { ++tx; }
+            int xe = std::min<int>((tx + 1) << dirty_tile_shift, _cfg.panel_width);
+            for (int y = ys; y < ye; ++y)
+            {
+              pc.src_x32 = xs;
+              pc.src_data = _double_buffer ? &_front_buffer[y * _line_stride] : _lines_buffer[y];
+              pc.fp_copy(&_texturebuf[y * _cfg.panel_width], xs, xe, &pc);
+            }
+          }
         }
         SDL_UnlockMutex(_sdl_mutex);
-        SDL_UpdateTexture(monitor.texture, nullptr, _texturebuf, _cfg.panel_width * sizeof(rgb888_t));
+
+        // upload each run of modified tiles as one rectangle.
+        for (size_t ty = 0; ty < _dirty_rows; ++ty)
+        {
+          auto row = &dirty[ty * _dirty_cols];
+          for (size_t tx = 0; tx < _dirty_cols; ++tx)
+          {
+            if (!row[tx]) continue;
+            SDL_Rect rect;
+            rect.x = tx << dirty_tile_shift;
+            rect.y = ty << dirty_tile_shift;
+            while (tx + 1 < _dirty_cols && row[tx + 1]) { ++tx; }
+            rect.w = std::min<int>((tx + 1) << dirty_tile_shift, _cfg.panel_width) - rect.x;
+            rect.h = std::min<int>(rect.y + (1 << dirty_tile_shift), _cfg.panel_height) - rect.y;
+            SDL_UpdateTexture(monitor.texture, &rect, &_texturebuf[rect.y * _cfg.panel_width + rect.x], _cfg.panel_width * sizeof(rgb888_t));
+          }
+        }
       }
     }
 
@@ -615,6 +776,12 @@ namespace lgfx
       render_texture(monitor.texture_frameimage, 0, 0, monitor.frame_width, monitor.frame_height, angle);
       SDL_RenderPresent(monitor.renderer);
       _display_counter = _texupdate_counter;
+      if (new_frame)
+      {
+        SDL_LockMutex(_sdl_mutex);
+        _present_stats.addLatency(micros() - frame_usec);
+        SDL_UnlockMutex(_sdl_mutex);
+      }
       if (_invalidated) {
         _invalidated = false;
         SDL_SetRenderDrawColor(monitor.renderer, 0, 0, 0, 0xFF);
@@ -648,12 +815,27 @@ namespace lgfx
 
     _texturebuf = (rgb888_t*)heap_alloc_dma(width * height * sizeof(rgb888_t));
 
+    _dirty_cols = (_cfg.panel_width  + (1 << dirty_tile_shift) - 1) >> dirty_tile_shift;
+    _dirty_rows = (_cfg.panel_height + (1 << dirty_tile_shift) - 1) >> dirty_tile_shift;
+    _dirty_tiles = (uint8_t*)heap_alloc(_dirty_cols * _dirty_rows);
+    mark_dirty_all();
+
     /// 8byte alignment;
     width = (width + 7) & ~7u;
 
     _lines_buffer = lineArray;
     memset(lineArray, 0, height * sizeof(uint8_t*));
 
+    if (_double_buffer)
+    {
+      _line_stride = width;
+      _front_buffer = (uint8_t*)heap_alloc_dma(width * height + 16);
+      _back_tiles = (uint8_t*)heap_alloc(_dirty_cols * _dirty_rows);
+      if (_front_buffer == nullptr || _back_tiles == nullptr) { return false; }
+      memset(_front_buffer, 0, width * height);
+      mark_dirty_all();
+    }
+
     uint8_t* framebuffer = (uint8_t*)heap_alloc_dma(width * height + 16);
 
     auto fb = framebuffer;
@@ -680,6 +862,18 @@ namespace lgfx
       heap_free(_texturebuf);
       _texturebuf = nullptr;
     }
+    if (_dirty_tiles) {
+      heap_free(_dirty_tiles);
+      _dirty_tiles = nullptr;
+    }
+    if (_front_buffer) {
+      heap_free(_front_buffer);
+      _front_buffer = nullptr;
+    }
+    if (_back_tiles) {
+      heap_free(_back_tiles);
+      _back_tiles = nullptr;
+    }
   }
 
 //----------------------------------------------------------------------------
@@ -25,6 +25,7 @@ Porting for SDL:
 #if defined (SDL_h_)
 #include "../../panel/Panel_FrameBufferBase.hpp"
 #include "../../misc/range.hpp"
+#include "../../misc/present_stats.hpp"
 #include "../../Touch.hpp"
 
 namespace lgfx
@@ -83,10 +84,13 @@ namespace lgfx
     // void setInvert(bool invert) override {}
     void drawPixelPreclipped(uint_fast16_t x, uint_fast16_t y, uint32_t rawcolor) override;
     void writeFillRectPreclipped(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t rawcolor) override;
+    void writeFillRectAlphaPreclipped(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t argb8888) override;
     void writeBlock(uint32_t rawcolor, uint32_t length) override;
     void writeImage(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param, bool use_dma) override;
     void writeImageARGB(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param) override;
     void writePixels(pixelcopy_t* param, uint32_t len, bool use_dma) override;
+    void copyRect(uint_fast16_t dst_x, uint_fast16_t dst_y, uint_fast16_t w, uint_fast16_t h, uint_fast16_t src_x, uint_fast16_t src_y) override;
+    void commitFrameBuffer(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h) override;
 
     uint_fast8_t getTouchRaw(touch_point_t* tp, uint_fast8_t count) override;
 
@@ -95,6 +99,19 @@ namespace lgfx
     void setFrameImage(const void* frame_image, int frame_width, int frame_height, int inner_x, int inner_y);
     void setFrameRotation(uint_fast16_t frame_rotaion);
 
+    /// 描画はバックバッファに対して行い、display() で変更範囲を表示用バッファへ複写する。表示(変換と転送)はSDLのスレッドで行う。init の前に設定する。;
+    /// Draws into a back buffer without locking; display() copies the modified tiles to the front buffer
+    /// and the SDL thread converts and presents it, so drawing the next frame overlaps the presentation. Set before init.
+    void setDoubleBuffer(bool enable);
+    bool getDoubleBuffer(void) const { return _double_buffer; }
+
+    /// display() の呼出しをこのフレームレートに制限する。0 = 制限なし;
+    /// Holds display() to this frame rate. 0 = not limited.
+    void setFrameRate(uint32_t fps) { _frame_pacer.setFrameRate(fps); }
+
+    /// frame count, dropped frames and latency from display() to SDL_RenderPresent. (double buffer only)
+    present_stats_t getPresentStats(void);
+
     static int setup(void);
     static int loop(void);
     static int close(void);
@@ -122,15 +139,38 @@ namespace lgfx
     monitor_t monitor;
 
     rgb888_t* _texturebuf = nullptr;
+
+    // modified area of _lines_buffer, one flag per tile. only these tiles are uploaded to the texture.
+    static constexpr uint_fast8_t dirty_tile_shift = 5;
+    uint8_t* _dirty_tiles = nullptr;
+    uint_fast16_t _dirty_cols = 0;
+    uint_fast16_t _dirty_rows = 0;
     uint_fast16_t _modified_counter;
     uint_fast16_t _texupdate_counter;
     uint_fast16_t _display_counter;
     bool _invalidated;
 
+    // double buffer: _lines_buffer is the back buffer, _front_buffer is read by sdl_update. (guarded by _sdl_mutex)
+    bool _double_buffer = false;
+    bool _auto_display_saved = true; // _auto_display before the double buffer was enabled
+    uint8_t* _front_buffer = nullptr;
+    size_t _line_stride = 0;
+    uint8_t* _back_tiles = nullptr;  // modified tiles of the back buffer since the last display()
+    uint32_t _pending_usec = 0;      // time the frame waiting for sdl_update was handed over
+    present_stats_t _present_stats = {};
+    frame_pacer_t _frame_pacer;
+
     static void _event_proc(void);
     static void _update_proc(void);
     static void _update_scaling(monitor_t * m, float sx, float sy);
     void sdl_invalidate(void) { _invalidated = true; }
+    void mark_dirty(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h);
+    void mark_dirty_all(void)
+    {
+      if (_dirty_tiles) { memset(_dirty_tiles, 1, _dirty_cols * _dirty_rows); }
+      if (_back_tiles) { memset(_back_tiles, 1, _dirty_cols * _dirty_rows); }
+    }
+    void present_back_buffer(void);
     void render_texture(SDL_Texture* texture, int tx, int ty, int tw, int th, float angle);
     bool initFrameBuffer(size_t width, size_t height);
     void deinitFrameBuffer(void);
@@ -24,6 +24,10 @@ Contributors:
 #include "v1/lgfx_filesystem_support.hpp"
 #include "v1/LGFXBase.hpp"
 #include "v1/LGFX_Sprite.hpp"
+#include "v1/LGFX_DisplayList.hpp"
+#include "v1/LGFX_BandRenderer.hpp"
+#include "v1/LGFX_ParallelRenderer.hpp"
+#include "v1/misc/PrefetchDataWrapper.hpp"
 #include "v1/LGFX_Button.hpp"
 #include "v1/Light.hpp"
 